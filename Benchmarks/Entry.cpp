@@ -0,0 +1,11 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+/*
+* This file does nothing, but needs to exist.
+* Run with: runbenchmarks "[Benchmark]"
+*/
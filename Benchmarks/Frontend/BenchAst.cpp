@@ -0,0 +1,216 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <n19/Frontend/AST/ASTNodes.hpp>
+#include <n19/Frontend/AST/AstArena.hpp>
+#include <n19/Frontend/AST/AstVisitor.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <n19/Core/Stream.hpp>
+#include <memory>
+#include <vector>
+using namespace rl;
+
+///
+/// Builds a left-leaning chain of `depth` binary expressions
+/// over identifiers and integer literals: 2 * depth + 1 nodes.
+static auto make_expr(AstArena& arena, const uint32_t depth, uint32_t& line) -> AstNode::Ptr<> {
+  AstNode::Ptr<> expr = AstNode::create<AstEntityRefThunk>(arena, line * 16, line, nullptr, 1);
+  for(uint32_t i = 0; i < depth; i++) {
+    auto* bin = AstNode::create<AstBinExpr>(arena, line * 16 + i, line, nullptr, 1);
+    auto* lit = AstNode::create<AstScalarLiteral>(arena, line * 16 + i + 2, line, bin, 1);
+    lit->scalar_type_ = AstScalarLiteral::IntLit;
+    lit->int_value_   = i;
+    bin->op_type_     = TokenType::Plus;
+    bin->left_        = expr;
+    bin->right_       = lit;
+    expr->parent_     = bin;
+    expr = bin;
+  }
+
+  ++line;
+  return expr;
+}
+
+///
+/// About `nodes` nodes: procedures holding returns of short expressions.
+static auto make_synthetic_tree(AstArena& arena, const size_t nodes) -> std::vector<AstNode::Ptr<>> {
+  std::vector<AstNode::Ptr<>> roots;
+  uint32_t line  = 1;
+  size_t count   = 0;
+
+  while(count < nodes) {
+    auto* proc = AstNode::create<AstProcDecl>(arena, line * 16, line, nullptr, 1);
+    ++count;
+    for(uint32_t stmt = 0; stmt < 16; stmt++) {
+      auto* ret   = AstNode::create<AstReturn>(arena, line * 16, line, proc, 1);
+      ret->value_ = make_expr(arena, 1 + stmt % 5, line);
+      ret->value_->parent_ = ret;
+      proc->body_.push_back(arena, ret);
+      count += 2 + 2 * (1 + stmt % 5);
+    }
+    roots.push_back(proc);
+  }
+
+  return roots;
+}
+
+///
+/// Pointer-chasing walk over the kinds make_synthetic_tree uses.
+static auto walk_tree(const AstNode* node) -> uint64_t {
+  uint64_t sum = node->line_ + static_cast<uint64_t>(node->type_);
+  switch(node->type_) {
+  case AstNode::Type::ProcDecl:
+    for(const auto* child : static_cast<const AstProcDecl*>(node)->body_) sum += walk_tree(child);
+    break;
+  case AstNode::Type::Return:
+    sum += walk_tree(static_cast<const AstReturn*>(node)->value_);
+    break;
+  case AstNode::Type::BinExpr:
+    sum += walk_tree(static_cast<const AstBinExpr*>(node)->left_);
+    sum += walk_tree(static_cast<const AstBinExpr*>(node)->right_);
+    break;
+  default: break;
+  }
+
+  return sum;
+}
+
+///
+/// The same walk as walk_tree(), over FlatAst: recursive, and
+/// reaching each child through its parent's links rather than
+/// by scanning the columns in order.
+static auto walk_flat(const FlatAst& flat, const FlatAst::Index node) -> uint64_t {
+  uint64_t sum = flat.lines_[node] + static_cast<uint64_t>(flat.kinds_[node]);
+  for(auto c = flat.first_child_[node]; c != FlatAst::none_; c = flat.next_sibling_[c]) {
+    sum += walk_flat(flat, c);
+  }
+
+  return sum;
+}
+
+///
+/// Sums the same values walk_tree() does, through AstVisitor.
+class SumVisitor final : public AstVisitor<SumVisitor> {
+public:
+  auto pre_node(const AstNode& node, const AstVisitFrame&) -> VisitAction {
+    sum_ += node.line_ + static_cast<uint64_t>(node.type_);
+    return VisitAction::Continue;
+  }
+
+  uint64_t sum_ = 0;
+};
+
+///
+/// The baseline AstVisitor replaces: a virtual visit() per node
+/// type, looked up from the node's type_ and called recursively.
+class VirtualHandler {
+public:
+  virtual auto visit(const AstNode* node, const std::vector<std::unique_ptr<VirtualHandler>>&) const -> uint64_t {
+    return node->line_ + static_cast<uint64_t>(node->type_);
+  }
+
+  virtual ~VirtualHandler() = default;
+};
+
+static auto visit_virtual_(
+  const AstNode* node,
+  const std::vector<std::unique_ptr<VirtualHandler>>& handlers ) -> uint64_t
+{
+  return handlers[ static_cast<uint16_t>(node->type_) ]->visit(node, handlers);
+}
+
+class VirtualProcDecl final : public VirtualHandler {
+public:
+  auto visit(const AstNode* node, const std::vector<std::unique_ptr<VirtualHandler>>& handlers) const -> uint64_t override {
+    uint64_t sum = VirtualHandler::visit(node, handlers);
+    for(const auto* child : static_cast<const AstProcDecl*>(node)->body_) sum += visit_virtual_(child, handlers);
+    return sum;
+  }
+};
+
+class VirtualReturn final : public VirtualHandler {
+public:
+  auto visit(const AstNode* node, const std::vector<std::unique_ptr<VirtualHandler>>& handlers) const -> uint64_t override {
+    return VirtualHandler::visit(node, handlers)
+      + visit_virtual_(static_cast<const AstReturn*>(node)->value_, handlers);
+  }
+};
+
+class VirtualBinExpr final : public VirtualHandler {
+public:
+  auto visit(const AstNode* node, const std::vector<std::unique_ptr<VirtualHandler>>& handlers) const -> uint64_t override {
+    const auto* bin = static_cast<const AstBinExpr*>(node);
+    return VirtualHandler::visit(node, handlers)
+      + visit_virtual_(bin->left_, handlers)
+      + visit_virtual_(bin->right_, handlers);
+  }
+};
+
+TEST_CASE("AstWalk", "[Benchmark][Frontend.AST]") {
+  AstArena arena;
+  const auto roots = make_synthetic_tree(arena, 1'000'000);
+  const auto flat  = FlatAst::from_tree(roots);
+
+  BENCHMARK("Ast.Walk.Tree") {
+    uint64_t sum = 0;
+    for(const auto* root : roots) sum += walk_tree(root);
+    return sum;
+  };
+
+  BENCHMARK("Ast.Walk.Flat") {
+    uint64_t sum = 0;
+    for(auto root = FlatAst::Index{0}; root != FlatAst::none_; root = flat.next_sibling_[root]) {
+      sum += walk_flat(flat, root);
+    }
+    return sum;
+  };
+
+  BENCHMARK("Ast.Walk.Visitor") {
+    SumVisitor visitor;
+    visitor.walk(roots);
+    return visitor.sum_;
+  };
+
+  std::vector<std::unique_ptr<VirtualHandler>> handlers;
+  #define ASTNODE_X(NAME) handlers.push_back(std::make_unique<VirtualHandler>());
+  RL_ASTNODE_TYPE_LIST
+  #undef ASTNODE_X
+  handlers[ static_cast<uint16_t>(AstNode::Type::ProcDecl) ] = std::make_unique<VirtualProcDecl>();
+  handlers[ static_cast<uint16_t>(AstNode::Type::Return) ]   = std::make_unique<VirtualReturn>();
+  handlers[ static_cast<uint16_t>(AstNode::Type::BinExpr) ]  = std::make_unique<VirtualBinExpr>();
+
+  BENCHMARK("Ast.Walk.Virtual") {
+    uint64_t sum = 0;
+    for(const auto* root : roots) sum += visit_virtual_(root, handlers);
+    return sum;
+  };
+
+  BENCHMARK("Ast.Convert") {
+    return FlatAst::from_tree(roots).size();
+  };
+}
+
+///
+/// The dumper through both layouts: AstNode::print() walks the
+/// tree through AstVisitor, FlatAst::dump() walks the columns.
+/// Both write exactly the same text.
+TEST_CASE("AstDump", "[Benchmark][Frontend.AST]") {
+  AstArena arena;
+  const auto roots = make_synthetic_tree(arena, 100'000);
+  const auto flat  = FlatAst::from_tree(roots);
+  NullOStream sink;
+
+  BENCHMARK("Ast.Dump.Tree") {
+    for(const auto* root : roots) root->print(0, sink, Nothing);
+    return roots.size();
+  };
+
+  BENCHMARK("Ast.Dump.Flat") {
+    flat.dump(sink);
+    return flat.size();
+  };
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <Benchmarks/Frontend/Synthetic.hpp>
+#include <n19/Core/ThreadPool.hpp>
+#include <string>
+#include <vector>
+using namespace rl;
+
+///
+/// Walks the token stream the way the parser does: a couple of
+/// single peeks, a batched peek, and an occasional short backtrack.
+static auto walk_like_parser(Lexer& lxr) -> size_t {
+  size_t seen = 0;
+  while(lxr.current() != TokenType::EndOfFile) {
+    seen += lxr.peek(1).len_;
+    seen += lxr.peek(2).len_;
+    seen += lxr.batched_peek<3>()[2].len_;
+
+    if(seen % 16 == 0) {
+      const auto saved = lxr.current();
+      lxr.consume(3);
+      lxr.revert_before(saved);
+    }
+
+    lxr.consume(1);
+  }
+
+  return seen;
+}
+
+TEST_CASE("LexModes", "[Benchmark][Frontend.Lexer]") {
+  const std::string source = make_synthetic_source(20'000);
+
+  BENCHMARK("Lexer.OnDemand") {
+    auto lxr = Lexer::create_shared(to_buffer(source), LexMode::OnDemand).value();
+    return walk_like_parser(*lxr);
+  };
+
+  BENCHMARK("Lexer.Eager") {
+    auto lxr = Lexer::create_shared(to_buffer(source), LexMode::Eager).value();
+    return walk_like_parser(*lxr);
+  };
+}
+
+TEST_CASE("ScannerLevels", "[Benchmark][Frontend.Lexer]") {
+  const std::string source = make_synthetic_source(20'000);
+  const SimdLevel saved = ByteScanner::level();
+
+  BENCHMARK("Lexer.Scan.Scalar") {
+    ByteScanner::set_level(SimdLevel::Scalar);
+    return Lexer::create_shared(to_buffer(source)).value()->current().len_;
+  };
+
+  BENCHMARK("Lexer.Scan.Best") {
+    ByteScanner::set_level(ByteScanner::max_level());
+    return Lexer::create_shared(to_buffer(source)).value()->current().len_;
+  };
+
+  ByteScanner::set_level(saved);
+}
+
+TEST_CASE("Keywords", "[Benchmark][Frontend.Lexer]") {
+  const std::string source = make_identifier_source(1'000'000);
+  std::vector<std::u8string> words;
+  for(size_t i = 0, start = 0; i <= source.size(); i++) {
+    if(i == source.size() || source[i] == ' ' || source[i] == ',' || source[i] == '\n') {
+      if(i > start) words.emplace_back(source.begin() + start, source.begin() + i);
+      start = i + 1;
+    }
+  }
+
+  BENCHMARK("Keywords.Lookup") {
+    size_t hits = 0;
+    for(const auto& word : words) hits += Lexer::get_keyword(word).has_value();
+    return hits;
+  };
+
+  BENCHMARK("Keywords.Lex") {
+    return Lexer::create_shared(to_buffer(source)).value()->current().len_;
+  };
+}
+
+TEST_CASE("Operators", "[Benchmark][Frontend.Lexer]") {
+  const std::string source = make_operator_source(500'000);
+
+  BENCHMARK("Operators.Lex") {
+    return Lexer::create_shared(to_buffer(source)).value()->current().len_;
+  };
+}
+
+TEST_CASE("ParallelScaling", "[Benchmark][Frontend.Lexer]") {
+  const std::string source = make_synthetic_source(100'000);
+  const size_t max_threads = ThreadPool::hardware_threads();
+
+  for(size_t threads = 1; threads <= max_threads; threads *= 2) {
+    ThreadPool pool(threads);
+
+    BENCHMARK("Lexer.Parallel." + std::to_string(threads)) {
+      return Lexer::create_parallel(to_buffer(source), pool).value()->current().len_;
+    };
+  }
+}
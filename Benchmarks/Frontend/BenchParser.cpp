@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <n19/Frontend/Parser/Parser.hpp>
+#include <n19/Frontend/Parser/ParseContext.hpp>
+#include <Benchmarks/Frontend/Synthetic.hpp>
+#include <n19/Core/Console.hpp>
+#include <string>
+using namespace rl;
+
+///
+/// Parses `source` from scratch. Returns the number of
+/// BinExpr nodes, or zero if the parse failed.
+static auto parse_source(const std::string& source) -> size_t {
+  EntityTable table(_nstr("BenchTable"));
+  ErrorCollector errors;
+  auto lexer = Lexer::create_shared(to_buffer(source), LexMode::Eager).value();
+  ParseContext ctx(1, errs(), errors, *lexer, table);
+  if(!parse(ctx)) return 0;
+  return ctx.arena.usage(uint16_t(AstNode::Type::BinExpr)).count;
+}
+
+///
+/// Declarations only: every body is skimmed. Returns
+/// the number of procedures, or zero on failure.
+static auto skim_source(const std::string& source) -> size_t {
+  EntityTable table(_nstr("BenchTable"));
+  ErrorCollector errors;
+  auto lexer = Lexer::create_shared(to_buffer(source), LexMode::Eager).value();
+  ParseContext ctx(1, errs(), errors, *lexer, table);
+  ctx.skim_bodies = true;
+  if(!parse(ctx)) return 0;
+  return ctx.pending_bodies_.size();
+}
+
+TEST_CASE("Expressions", "[Benchmark][Frontend.Parser]") {
+  const std::string source = make_expression_source(20'000);
+  REQUIRE(parse_source(source) > 0);
+
+  /// Lexing alone, so the parser's share can be read off.
+  BENCHMARK("Parser.Expressions.LexOnly") {
+    return Lexer::create_shared(to_buffer(source), LexMode::Eager).value()->current().len_;
+  };
+
+  BENCHMARK("Parser.Expressions") {
+    return parse_source(source);
+  };
+}
+
+TEST_CASE("SkimmedBodies", "[Benchmark][Frontend.Parser]") {
+  const std::string source = make_expression_source(20'000);
+  REQUIRE(skim_source(source) == 20'000);
+
+  BENCHMARK("Parser.Declarations.Skim") {
+    return skim_source(source);
+  };
+
+  BENCHMARK("Parser.Declarations.Full") {
+    return parse_source(source);
+  };
+}
@@ -0,0 +1,119 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <iterator>
+
+///
+/// Builds a synthetic rl source containing `procs` procedures.
+/// The output mixes identifiers, keywords, literals, operators,
+/// strings and comments in roughly the proportions we see in
+/// generated translation units.
+inline auto make_synthetic_source(const size_t procs) -> std::string {
+  std::string out;
+  out.reserve(procs * 256);
+
+  for(size_t i = 0; i < procs; i++) {
+    const std::string n = std::to_string(i);
+    out += "# generated procedure " + n + "\n";
+    out += "proc gen_fn_" + n + "() -> {\n";
+    out += "  let value_" + n + " = (alpha + beta_" + n + ") * 0x1F - 017 / 3.25e-2;\n";
+    out += "  other::thing(value_" + n + ", \"string literal\", 'c') >>= gamma;\n";
+    out += "  counter_" + n + " += delta && epsilon || !zeta;\n";
+    out += "  return value_" + n + " <= 42;\n";
+    out += "}\n\n";
+  }
+
+  return out;
+}
+
+inline auto to_buffer(const std::string& source) -> std::vector<char8_t> {
+  return {source.begin(), source.end()};
+}
+
+///
+/// Identifier-heavy input: long runs of names, a fraction of which
+/// are keywords or near-misses of keywords ("continu", "proce"),
+/// separated only by whitespace and the odd comma.
+inline auto make_identifier_source(const size_t words) -> std::string {
+  static constexpr const char* pool[] = {
+    "value", "continue", "compeval", "continu", "proc", "proce",
+    "counter_", "let", "letter", "return", "returns", "if", "iff",
+    "namespace", "alpha_beta", "x", "defer_if", "deferred", "true",
+    "truth", "null", "nullable", "gen_fn_", "as", "ask", "for", "form",
+  };
+
+  std::string out;
+  out.reserve(words * 8);
+  for(size_t i = 0; i < words; i++) {
+    out += pool[ (i * 7 + i / 5) % std::size(pool) ];
+    out += (i % 11 == 10) ? ",\n" : " ";
+  }
+
+  return out;
+}
+
+///
+/// Operator-heavy input: every punctuator and operator spelling,
+/// mostly packed together so that maximal munch is exercised
+/// ("<<=" next to "<", "..." next to "."), with short operands.
+inline auto make_operator_source(const size_t exprs) -> std::string {
+  static constexpr const char* pool[] = {
+    "<<=", ">>=", "...", "::", "->", "=>", "==", "!=", "<=", ">=", "&&",
+    "||", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "++", "--",
+    "<<", ">>", "..", "=", ":", ";", "(", ")", "{", "}", "[", "]", ",",
+    ".", "$", "@", "<", ">", "!", "+", "-", "*", "/", "%", "~", "&",
+    "|", "^",
+  };
+
+  std::string out;
+  out.reserve(exprs * 24);
+  for(size_t i = 0; i < exprs; i++) {
+    out += pool[ (i * 13) % std::size(pool) ];
+    out += pool[ (i * 7 + 3) % std::size(pool) ];
+    out += (i % 3 == 0) ? " a" : "b";
+    out += pool[ (i * 5 + 1) % std::size(pool) ];
+    out += (i % 9 == 8) ? "\n" : " ";
+  }
+
+  return out;
+}
+
+///
+/// Expression-heavy input the parser accepts: procedures whose
+/// bodies are returns of long operator chains, with prefixes,
+/// postfixes, calls and parentheses mixed in.
+inline auto make_expression_source(const size_t procs) -> std::string {
+  static constexpr const char* ops[] = {
+    " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " < ", " >= ",
+    " == ", " != ", " && ", " || ", " & ", " ^ ", "::", " = ", " += ",
+  };
+
+  static constexpr const char* operands[] = {
+    "alpha", "beta", "42", "!gamma", "delta++", "f(x, 1)", "(a + b)", "~mask",
+  };
+
+  std::string out;
+  out.reserve(procs * 512);
+  for(size_t i = 0; i < procs; i++) {
+    out += "proc expr_fn_" + std::to_string(i) + "() -> {\n";
+    for(size_t stmt = 0; stmt < 4; stmt++) {
+      out += "  return ";
+      out += operands[ (i + stmt) % std::size(operands) ];
+      for(size_t term = 0; term < 12; term++) {
+        out += ops[ (i * 7 + stmt * 3 + term) % std::size(ops) ];
+        out += operands[ (i * 5 + stmt + term * 3) % std::size(operands) ];
+      }
+      out += ";\n";
+    }
+    out += "}\n";
+  }
+
+  return out;
+}
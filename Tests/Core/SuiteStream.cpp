@@ -138,3 +138,15 @@ TEST_CASE("BasicFunctionality", "[Core.BufferedOStream]") {
     REQUIRE(stream.buffer_remaining() == N19_OSTREAM_BUFFSIZE);
   }
 }
+
+TEST_CASE("StringOStream", "[Core.StringOStream]") {
+  StringOStream stream;
+  stream << "value = " << 42 << ' ' << std::string_view("done") << Endl;
+  stream << Flush;
+
+  /// Nothing is lost on a flush.
+  REQUIRE(stream.str() == "value = 42 done\n");
+
+  stream.clear();
+  REQUIRE(stream.str().empty());
+}
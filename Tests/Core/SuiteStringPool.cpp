@@ -28,6 +28,19 @@ TEST_CASE("StringPool basic interning", "[Core.StringPool]") {
   REQUIRE(maybe_idx->offset == idx1.offset);
 }
 
+TEST_CASE("StringPool precomputed hash", "[Core.StringPool]") {
+  StringPool pool(1024, 7);
+
+  const auto hash = pool.hash_of("hello");
+  REQUIRE(hash == pool.hash_of("hello"));
+  REQUIRE(hash != pool.hash_of("world"));
+
+  const auto idx1 = pool.get_index("hello", hash);
+  const auto idx2 = pool.get_index("hello");
+  REQUIRE(idx1 == idx2);
+  REQUIRE(pool.get_string(idx1) == "hello");
+}
+
 TEST_CASE("StringPool distinct strings", "[Core.StringPool]") {
   StringPool pool(1024, 1);
 
@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Core/ThreadPool.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+using namespace n19;
+
+TEST_CASE("ThreadPool runs every job", "[Core.ThreadPool]") {
+  ThreadPool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  std::atomic<size_t> sum = 0;
+  for(size_t i = 1; i <= 1000; i++) {
+    pool.submit([&sum, i] { sum += i; });
+  }
+
+  pool.wait();
+  REQUIRE(sum == 500500);
+}
+
+TEST_CASE("ThreadPool parallel_for", "[Core.ThreadPool]") {
+  ThreadPool pool(3);
+  std::vector<size_t> out(257, 0);
+  pool.parallel_for(out.size(), [&](const size_t i) { out[i] = i * 2; });
+
+  for(size_t i = 0; i < out.size(); i++) {
+    REQUIRE(out[i] == i * 2);
+  }
+
+  /// The pool is reusable after a wait().
+  pool.parallel_for(out.size(), [&](const size_t i) { out[i] += 1; });
+  REQUIRE(out.back() == 513);
+}
+
+TEST_CASE("ThreadPool parallel_for waits only on its own work", "[Core.ThreadPool]") {
+  ThreadPool pool(1);
+
+  /// Holds the only worker until parallel_for is done. A pool-wide
+  /// wait() inside parallel_for would never return.
+  std::atomic<bool> release = false;
+  pool.submit([&] { while(!release) std::this_thread::yield(); });
+
+  std::vector<size_t> out(64, 0);
+  pool.parallel_for(out.size(), [&](const size_t i) { out[i] = i + 1; });
+  REQUIRE(out.back() == 64);
+
+  release = true;
+  pool.wait();
+}
+
+TEST_CASE("ThreadPool parallel_for from a worker", "[Core.ThreadPool]") {
+  ThreadPool pool(2);
+  std::atomic<size_t> sum = 0;
+  pool.submit([&] {
+    pool.parallel_for(100, [&](const size_t i) { sum += i; });
+  });
+
+  pool.wait();
+  REQUIRE(sum == 4950);
+}
+
+TEST_CASE("ThreadPool size clamps to one", "[Core.ThreadPool]") {
+  ThreadPool pool(0);
+  REQUIRE(pool.size() == 1);
+
+  bool ran = false;
+  pool.submit([&] { ran = true; });
+  pool.wait();
+  REQUIRE(ran);
+}
@@ -0,0 +1,59 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Core/TokenDump.hpp>
+#include <vector>
+#include <cstring>
+using namespace n19;
+
+static auto make_dump(const size_t count) -> std::vector<Byte> {
+  const auto header = TokenDumpHeader::make();
+  std::vector<Byte> out(sizeof(header) + count * sizeof(TokenRecord));
+  std::memcpy(out.data(), &header, sizeof(header));
+
+  for(size_t i = 0; i < count; i++) {
+    TokenRecord rec{};
+    rec.offset = i * 10;
+    rec.len    = static_cast<uint32_t>(i + 1);
+    rec.line   = static_cast<uint32_t>(i / 3 + 1);
+    rec.type   = static_cast<uint16_t>(i);
+    std::memcpy(out.data() + sizeof(header) + i * sizeof(rec), &rec, sizeof(rec));
+  }
+
+  return out;
+}
+
+TEST_CASE("TokenDumpReader", "[Core.TokenDump]") {
+  SECTION("RoundTrip") {
+    const auto data = make_dump(7);
+    auto reader = TokenDumpReader::create(as_bytes(data)).value();
+    REQUIRE(reader.size() == 7);
+    for(size_t i = 0; i < reader.size(); i++) {
+      const auto rec = reader.at(i);
+      REQUIRE(rec.offset == i * 10);
+      REQUIRE(rec.len == i + 1);
+      REQUIRE(rec.line == i / 3 + 1);
+      REQUIRE(rec.type == i);
+    }
+  }
+
+  SECTION("Unaligned") {
+    auto data = make_dump(3);
+    data.insert(data.begin(), Byte{0});
+    const auto reader = TokenDumpReader::create(as_bytes(data).subspan(1)).value();
+    REQUIRE(reader.size() == 3);
+    REQUIRE(reader.at(2).offset == 20);
+  }
+
+  SECTION("Rejected") {
+    auto data = make_dump(2);
+    REQUIRE(!TokenDumpReader::create(as_bytes(data).first(8)).has_value());
+    REQUIRE(!TokenDumpReader::create(as_bytes(data).first(data.size() - 1)).has_value());
+
+    data[0] = Byte{'x'};
+    REQUIRE(!TokenDumpReader::create(as_bytes(data)).has_value());
+  }
+}
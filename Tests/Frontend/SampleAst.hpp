@@ -0,0 +1,39 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Parser/Parser.hpp>
+#include <n19/Frontend/Parser/ParseContext.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <n19/Core/Console.hpp>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+///
+/// A small program that reaches most kinds of node, parsed
+/// as input 1 on construction. The tree lives as long as this
+/// does, in ctx.toplevel_decls_.
+struct SampleAst {
+  static constexpr std::u8string_view source =
+    u8"namespace a::b {\n"
+    u8"  proc f() -> {\n"
+    u8"    return x + 1 * y;\n"
+    u8"    return g(1, \"two\\n\", 3.5);\n"
+    u8"    scope { return !z; continue; }\n"
+    u8"  }\n"
+    u8"}\n"
+    u8"proc h() -> { return true; }\n";
+
+  rl::EntityTable table{ _nstr("SampleTable") };
+  rl::ErrorCollector errors;
+  std::shared_ptr<rl::Lexer> lexer =
+    rl::Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+  rl::ParseContext ctx{ 1, n19::errs(), errors, *lexer, table };
+
+  SampleAst() { REQUIRE(rl::parse(ctx)); }
+};
@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/AST/AstArena.hpp>
+#include <n19/Frontend/AST/ASTNodes.hpp>
+#include <cstdint>
+#include <string>
+using namespace rl;
+
+TEST_CASE("AstArena", "[Frontend.AstArena]") {
+  SECTION("Alignment") {
+    AstArena arena;
+    for(size_t i = 0; i < 4096; i++) {
+      const size_t align = size_t(1) << (i % 6);
+      auto* ptr = static_cast<uint8_t*>(arena.allocate(i % 37 + 1, align));
+      REQUIRE(reinterpret_cast<uintptr_t>(ptr) % align == 0);
+      ptr[i % 37] = 0xAB;                 /// Must be writable up to the end.
+    }
+
+    REQUIRE(arena.bytes_reserved() >= arena.bytes_used());
+  }
+
+  SECTION("LargeAllocationsKeepBlock") {
+    AstArena arena;
+    auto* first = static_cast<char*>(arena.allocate(16, 8));
+    auto* large = static_cast<char*>(arena.allocate(AstArena::block_size_ * 2, 16));
+    auto* after = static_cast<char*>(arena.allocate(16, 8));
+
+    REQUIRE(after == first + 16);
+    large[AstArena::block_size_ * 2 - 1] = 'x';
+  }
+
+  SECTION("DestructorsRun") {
+    static size_t destroyed = 0;
+    struct Tracked {
+      ~Tracked() { ++destroyed; }
+    };
+
+    destroyed = 0;
+    {
+      AstArena arena;
+      for(size_t i = 0; i < 100; i++) (void)arena.make<Tracked>(0);
+      REQUIRE(destroyed == 0);
+    }
+
+    REQUIRE(destroyed == 100);
+  }
+
+  SECTION("ListGrowth") {
+    AstArena arena;
+    AstList<uint32_t> a, b;
+    for(uint32_t i = 0; i < 5000; i++) {
+      a.push_back(arena, i);
+      if(i % 3 == 0) b.push_back(arena, ~i);  /// Interleaved, so a can't always grow in place.
+    }
+
+    REQUIRE(a.size() == 5000);
+    for(uint32_t i = 0; i < a.size(); i++) REQUIRE(a[i] == i);
+    for(uint32_t i = 0; i < b.size(); i++) REQUIRE(b.at(i) == ~(i * 3));
+    REQUIRE(arena.list_usage().count == 2);
+  }
+
+  SECTION("NodeUsage") {
+    AstArena arena;
+    auto* lit = AstNode::create<AstScalarLiteral>(arena, 0, 1, nullptr, 0);
+    lit->scalar_type_ = AstScalarLiteral::StringLit;
+    lit->value_ = std::string(200, 'q');  /// Heap storage the arena has to release.
+
+    auto* call = AstNode::create<AstCall>(arena, 0, 1, nullptr, 0);
+    call->arguments_.push_back(arena, lit);
+    lit->parent_ = call;
+
+    REQUIRE(lit->type_ == AstNode::Type::ScalarLiteral);
+    REQUIRE(call->arguments_.at(0) == lit);
+
+    const auto usage = arena.usage(uint16_t(AstNode::Type::ScalarLiteral));
+    REQUIRE(usage.count == 1);
+    REQUIRE(usage.bytes == sizeof(AstScalarLiteral));
+    REQUIRE(arena.usage(uint16_t(AstNode::Type::Call)).count == 1);
+    REQUIRE(arena.usage(uint16_t(AstNode::Type::BinExpr)).count == 0);
+  }
+}
@@ -0,0 +1,171 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/AST/AstCache.hpp>
+#include <n19/Frontend/AST/AstImage.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <Tests/Frontend/SampleAst.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+using namespace rl;
+
+TEST_CASE("AstImageRoundTrip", "[Frontend.AstImage]") {
+  SampleAst sample;
+
+  const auto flat  = FlatAst::from_tree(sample.ctx.toplevel_decls_);
+  const auto bytes = AstImage::serialize(flat, { 1, 2 }, 1);
+  auto image = AstImage::view(bytes);
+  REQUIRE(image.has_value());
+  REQUIRE(image->size() == flat.size());
+  REQUIRE(image->source().first_ == 1);
+  REQUIRE(image->source().second_ == 2);
+  REQUIRE(image->file() == 1);
+
+  SECTION("MatchesTreeDump") {
+    StringOStream tree_out, image_out;
+    for(const auto* decl : sample.ctx.toplevel_decls_) decl->print(0, tree_out, Nothing);
+    image->dump(image_out);
+
+    REQUIRE(image_out.str().find("Call.Args.3") != std::string::npos);
+    REQUIRE(image_out.str() == tree_out.str());
+  }
+
+  SECTION("SameColumns") {
+    for(FlatAst::Index i = 0; i < flat.size(); i++) {
+      REQUIRE(image->kinds_[i] == flat.kinds_[i]);
+      REQUIRE(image->parents_[i] == flat.parents_[i]);
+      REQUIRE(image->next_sibling_[i] == flat.next_sibling_[i]);
+      REQUIRE(image->payload_[i] == flat.payload_[i]);
+      REQUIRE(SourcePos(image->pos_[i]) == SourcePos(flat.pos_[i]));
+    }
+
+    REQUIRE(image->strings_.size() == flat.strings_.size());
+    for(FlatAst::Index i = 0; i < flat.strings_.size(); i++) {
+      REQUIRE(image->string(i) == flat.strings_[i]);
+    }
+  }
+}
+
+TEST_CASE("AstImageSideTables", "[Frontend.AstImage]") {
+  AstArena arena;
+  auto* sw     = AstNode::create<AstSwitch>(arena, 0, 1, nullptr, 3);
+  auto* target = AstNode::create<AstEntityRefThunk>(arena, 7, 1, sw, 3);
+  auto* cs     = AstNode::create<AstCase>(arena, 12, 2, sw, 3);
+  auto* value  = AstNode::create<AstScalarLiteral>(arena, 17, 2, cs, 3);
+  auto* qual   = AstNode::create<AstQualifiedRef>(arena, 20, 3, cs, 3);
+
+  target->name_         = "target";
+  value->scalar_type_   = AstScalarLiteral::IntLit;
+  value->int_value_     = 9;
+  qual->descriptor_.id_ = 12;
+  qual->descriptor_.ptr_depth_   = 2;
+  qual->descriptor_.flags_       = EntityQualifier::Constant;
+  qual->descriptor_.arr_lengths_ = { 4, 2 };
+
+  cs->is_fallthrough = true;
+  cs->value_ = value;
+  cs->children_.push_back(arena, qual);
+  sw->target_ = target;
+  sw->cases_.push_back(arena, cs);
+
+  const std::vector<AstNode::Ptr<>> roots{ sw };
+  const auto flat  = FlatAst::from_tree(roots);
+  const auto bytes = AstImage::serialize(flat, {}, 3);
+  auto image = AstImage::view(bytes);
+  REQUIRE(image.has_value());
+
+  REQUIRE(image->thunk_name(0) == "target");
+  const auto restored = image->qualifier(0);
+  REQUIRE(restored.id_ == 12);
+  REQUIRE(restored.ptr_depth_ == 2);
+  REQUIRE(restored.is_constant());
+  REQUIRE(restored.arr_lengths_ == std::vector<uint32_t>{ 4, 2 });
+
+  StringOStream flat_out, image_out;
+  flat.dump(flat_out);
+  image->dump(image_out);
+  REQUIRE(image_out.str().find("target") != std::string::npos);
+  REQUIRE(image_out.str() == flat_out.str());
+}
+
+TEST_CASE("AstImageRejectsCorruption", "[Frontend.AstImage]") {
+  SampleAst sample;
+  auto flat = FlatAst::from_tree(sample.ctx.toplevel_decls_);
+
+  SECTION("Truncated") {
+    auto bytes = AstImage::serialize(flat, {}, 1);
+    bytes.resize(bytes.size() / 2);
+    REQUIRE_FALSE(AstImage::view(bytes).has_value());
+  }
+
+  SECTION("BadMagic") {
+    auto bytes = AstImage::serialize(flat, {}, 1);
+    bytes[0] = Byte{'x'};
+    REQUIRE_FALSE(AstImage::view(bytes).has_value());
+  }
+
+  SECTION("BadLinks") {
+    flat.parents_[1] = 5;
+    const auto bytes = AstImage::serialize(flat, {}, 1);
+    REQUIRE_FALSE(AstImage::view(bytes).has_value());
+  }
+
+  SECTION("BadPayload") {
+    for(FlatAst::Index i = 0; i < flat.size(); i++) {
+      if(flat.kinds_[i] == AstNode::Type::BinExpr) flat.payload_[i] = 1000;
+    }
+
+    const auto bytes = AstImage::serialize(flat, {}, 1);
+    REQUIRE_FALSE(AstImage::view(bytes).has_value());
+  }
+}
+
+TEST_CASE("AstCache", "[Frontend.AstCache]") {
+  const auto root = std::filesystem::temp_directory_path() / "n19_suite_ast_cache";
+  std::filesystem::remove_all(root);
+
+  SampleAst sample;
+
+  const auto flat = FlatAst::from_tree(sample.ctx.toplevel_decls_);
+  const auto hash = AstCache::hash({ SampleAst::source.data(), SampleAst::source.size() });
+  auto cache = AstCache::open(root.native()).release_value();
+
+  SECTION("MissThenHit") {
+    REQUIRE_FALSE(cache.load(hash, 1).has_value());
+    REQUIRE(cache.store(hash, 1, flat).has_value());
+
+    auto image = cache.load(hash, 1);
+    REQUIRE(image.has_value());
+    REQUIRE(cache.stats().misses == 1);
+    REQUIRE(cache.stats().hits == 1);
+
+    StringOStream flat_out, image_out;
+    flat.dump(flat_out);
+    image->dump(image_out);
+    REQUIRE(image_out.str() == flat_out.str());
+  }
+
+  SECTION("OtherFileIdMisses") {
+    REQUIRE(cache.store(hash, 1, flat).has_value());
+    REQUIRE_FALSE(cache.load(hash, 2).has_value());
+    REQUIRE(cache.stats().misses == 1);
+  }
+
+  SECTION("ChangedSourceMisses") {
+    REQUIRE(cache.store(hash, 1, flat).has_value());
+    constexpr std::u8string_view changed = u8"proc h() -> { return false; }\n";
+    REQUIRE_FALSE(cache.load(AstCache::hash({ changed.data(), changed.size() }), 1).has_value());
+  }
+
+  SECTION("CorruptEntryMisses") {
+    REQUIRE(cache.store(hash, 1, flat).has_value());
+    std::filesystem::resize_file(cache.path_for(hash), 16);
+    REQUIRE_FALSE(cache.load(hash, 1).has_value());
+  }
+
+  std::filesystem::remove_all(root);
+}
@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/AST/AstVisitor.hpp>
+#include <n19/Frontend/AST/AstArena.hpp>
+#include <string>
+#include <vector>
+using namespace rl;
+
+///
+/// Records every hook call as "+Kind" or "-Kind".
+class TraceVisitor final : public AstVisitor<TraceVisitor> {
+public:
+  auto pre_node(const AstNode& node, const AstVisitFrame& frame) -> VisitAction {
+    trace_.push_back("+" + std::to_string(static_cast<int>(node.type_)));
+    depths_.push_back(frame.depth);
+    if(&node == skip_) return VisitAction::Skip;
+    if(&node == stop_) return VisitAction::Stop;
+    return VisitAction::Continue;
+  }
+
+  auto post_node(const AstNode& node, const AstVisitFrame&) -> VisitAction {
+    trace_.push_back("-" + std::to_string(static_cast<int>(node.type_)));
+    return VisitAction::Continue;
+  }
+
+  auto pre_BinExpr(const AstBinExpr& node, const AstVisitFrame& frame) -> VisitAction {
+    ++binexprs_;
+    return pre_node(node, frame);
+  }
+
+  std::vector<std::string> trace_;
+  std::vector<uint32_t> depths_;
+  const AstNode* skip_ = nullptr;
+  const AstNode* stop_ = nullptr;
+  size_t binexprs_     = 0;
+};
+
+static auto tag_(const AstNode::Type type, const char sign) -> std::string {
+  return sign + std::to_string(static_cast<int>(type));
+}
+
+TEST_CASE("AstVisitorOrder", "[Frontend.AstVisitor]") {
+  using T = AstNode::Type;
+  AstArena arena;
+
+  /// return a + b;
+  auto* ret   = AstNode::create<AstReturn>(arena, 0, 1, nullptr, 1);
+  auto* expr  = AstNode::create<AstBinExpr>(arena, 7, 1, ret, 1);
+  auto* left  = AstNode::create<AstEntityRef>(arena, 7, 1, expr, 1);
+  auto* right = AstNode::create<AstEntityRef>(arena, 11, 1, expr, 1);
+  ret->value_  = expr;
+  expr->left_  = left;
+  expr->right_ = right;
+
+  TraceVisitor visitor;
+
+  SECTION("PreAndPost") {
+    REQUIRE(visitor.walk(ret));
+    const std::vector<std::string> expected{
+      tag_(T::Return, '+'), tag_(T::BinExpr, '+'),
+      tag_(T::EntityRef, '+'), tag_(T::EntityRef, '-'),
+      tag_(T::EntityRef, '+'), tag_(T::EntityRef, '-'),
+      tag_(T::BinExpr, '-'), tag_(T::Return, '-'),
+    };
+
+    REQUIRE(visitor.trace_ == expected);
+    REQUIRE(visitor.depths_ == std::vector<uint32_t>{ 0, 1, 2, 2 });
+    REQUIRE(visitor.binexprs_ == 1);
+  }
+
+  SECTION("Skip") {
+    visitor.skip_ = expr;
+    REQUIRE(visitor.walk(ret));
+    const std::vector<std::string> expected{
+      tag_(T::Return, '+'), tag_(T::BinExpr, '+'),
+      tag_(T::BinExpr, '-'), tag_(T::Return, '-'),
+    };
+
+    REQUIRE(visitor.trace_ == expected);
+  }
+
+  SECTION("Stop") {
+    visitor.stop_ = left;
+    REQUIRE_FALSE(visitor.walk(ret));
+    REQUIRE(visitor.trace_.size() == 3);
+    REQUIRE(visitor.trace_.back() == tag_(T::EntityRef, '+'));
+
+    /// The visitor can be reused after a stopped walk.
+    visitor.stop_ = nullptr;
+    visitor.trace_.clear();
+    REQUIRE(visitor.walk(right));
+    REQUIRE(visitor.trace_.size() == 2);
+  }
+}
+
+TEST_CASE("AstVisitorDeepTree", "[Frontend.AstVisitor]") {
+  constexpr uint32_t depth = 1'000'000;
+  AstArena arena;
+
+  /// Far deeper than a recursive walk could handle.
+  AstNode::Ptr<> expr = AstNode::create<AstEntityRef>(arena, 0, 1, nullptr, 1);
+  for(uint32_t i = 0; i < depth; i++) {
+    auto* bin     = AstNode::create<AstBinExpr>(arena, 0, 1, nullptr, 1);
+    bin->left_    = expr;
+    expr->parent_ = bin;
+    expr = bin;
+  }
+
+  class DepthVisitor final : public AstVisitor<DepthVisitor> {
+  public:
+    auto pre_node(const AstNode&, const AstVisitFrame& frame) -> VisitAction {
+      ++visited_;
+      if(frame.depth > max_depth_) max_depth_ = frame.depth;
+      return VisitAction::Continue;
+    }
+
+    size_t visited_     = 0;
+    uint32_t max_depth_ = 0;
+  } visitor;
+
+  REQUIRE(visitor.walk(expr));
+  REQUIRE(visitor.visited_ == depth + 1);
+  REQUIRE(visitor.max_depth_ == depth);
+}
@@ -0,0 +1,179 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Common/CompilationCycle.hpp>
+#include <n19/Frontend/FrontendContext.hpp>
+#include <n19/System/File.hpp>
+#include <Tests/TempFiles.hpp>
+#include <n19/Core/Stream.hpp>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+using namespace rl;
+
+///
+/// Input IDs come from a global counter and show up in the dumps,
+/// so runs that get compared have to share one set of InputFiles.
+static auto make_inputs(const std::vector<std::filesystem::path>& paths) -> std::vector<InputFile> {
+  std::vector<InputFile> inputs;
+  for(const auto& path : paths) inputs.emplace_back(sys::String(path.native()));
+  return inputs;
+}
+
+///
+/// Points the global Context at `inputs`, runs every compilation
+/// cycle into `out` and `err`, and puts the Context back.
+static auto compile_all(
+  const std::vector<InputFile>& inputs,
+  const uint32_t jobs,
+  OStream& out,
+  OStream& err,
+  const std::underlying_type_t<Context::Flags> flags = 0 ) -> bool
+{
+  auto& ctx = Context::the();
+  auto saved_inputs  = std::move(ctx.inputs_);
+  auto saved_outputs = std::move(ctx.outputs_);
+  const auto saved_jobs  = ctx.jobs_;
+  const auto saved_flags = ctx.flags_;
+
+  ctx.inputs_ = inputs;
+  ctx.outputs_.clear();
+  for(const auto& in : inputs) {
+    ctx.outputs_.emplace_back(in.name + _nstr(".out"));
+  }
+
+  ctx.jobs_  = jobs;
+  ctx.flags_ = flags;
+  const bool ok = begin_global_compilation_cycles(out, err);
+
+  ctx.inputs_  = std::move(saved_inputs);
+  ctx.outputs_ = std::move(saved_outputs);
+  ctx.jobs_    = saved_jobs;
+  ctx.flags_   = saved_flags;
+  return ok;
+}
+
+static auto compile_all(const std::vector<std::filesystem::path>& paths, const uint32_t jobs) -> bool {
+  NullOStream out, err;
+  return compile_all(make_inputs(paths), jobs, out, err);
+}
+
+TEST_CASE("ParallelCompilation", "[Frontend.CompilationCycle]") {
+  const auto dir = std::filesystem::temp_directory_path() / "n19_suite_compilation_cycle";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  std::vector<std::filesystem::path> good;
+  for(int i = 0; i < 16; i++) {
+    const auto path = dir / ("input" + std::to_string(i) + ".rl");
+    write_file(path, "proc f" + std::to_string(i) + "() -> { return a + " + std::to_string(i) + "; }\n");
+    good.push_back(path);
+  }
+
+  const auto bad = dir / "bad.rl";
+  write_file(bad, "proc g() -> { return a as b; }\n");
+
+  SECTION("AllSucceed") {
+    REQUIRE(compile_all(good, 4));
+    REQUIRE(compile_all(good, 1));
+  }
+
+  SECTION("OneFailureFailsTheBuild") {
+    auto inputs = good;
+    inputs.insert(inputs.begin() + 5, bad);
+    REQUIRE_FALSE(compile_all(inputs, 4));
+    REQUIRE_FALSE(compile_all(inputs, 1));
+  }
+
+  SECTION("OutputInInputOrder") {
+    auto paths = good;
+    paths.insert(paths.begin() + 5, bad);
+    const auto inputs = make_inputs(paths);
+
+    StringOStream serial_out, serial_err, parallel_out, parallel_err;
+    REQUIRE_FALSE(compile_all(inputs, 1, serial_out, serial_err, Context::DumpAST | Context::DumpEnts));
+    REQUIRE_FALSE(compile_all(inputs, 4, parallel_out, parallel_err, Context::DumpAST | Context::DumpEnts));
+
+    REQUIRE(serial_out.str().find("f15") != std::string::npos);
+    REQUIRE(serial_out.str().find("f0") < serial_out.str().find("f15"));
+    REQUIRE_FALSE(serial_err.str().empty());
+    REQUIRE(parallel_out.str() == serial_out.str());
+    REQUIRE(parallel_err.str() == serial_err.str());
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("SharedInclude", "[Frontend.CompilationCycle]") {
+  const auto dir = std::filesystem::temp_directory_path() / "n19_suite_shared_include";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  /// Every input that includes shared.rl has to parse it for
+  /// itself, so every one of them reports its error, whichever
+  /// order the workers get to it in.
+  write_file(dir / "shared.rl", "proc shared() -> { return a as b; }\n");
+  std::vector<std::filesystem::path> paths;
+  for(int i = 0; i < 8; i++) {
+    const auto path = dir / ("input" + std::to_string(i) + ".rl");
+    write_file(path, "@include \"shared.rl\"\nproc f" + std::to_string(i) + "() -> { return a; }\n");
+    paths.push_back(path);
+  }
+
+  const auto inputs = make_inputs(paths);
+  StringOStream serial_out, serial_err, parallel_out, parallel_err;
+  REQUIRE_FALSE(compile_all(inputs, 1, serial_out, serial_err));
+  REQUIRE_FALSE(compile_all(inputs, 4, parallel_out, parallel_err));
+
+  const auto count = [](const std::string& text, const std::string& what) {
+    size_t found = 0;
+    for(size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + 1)) ++found;
+    return found;
+  };
+
+  REQUIRE(count(serial_err.str(), "shared.rl:") == paths.size());
+  REQUIRE(parallel_err.str() == serial_err.str());
+  REQUIRE(parallel_out.str() == serial_out.str());
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("AstCacheSkipsIncludes", "[Frontend.CompilationCycle]") {
+  const auto dir   = std::filesystem::temp_directory_path() / "n19_suite_ast_cache_includes";
+  const auto cache = dir / "cache";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  auto cached_entries = [&] {
+    size_t entries = 0;
+    if(!std::filesystem::exists(cache)) return entries;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(cache)) {
+      if(entry.is_regular_file()) ++entries;
+    }
+    return entries;
+  };
+
+  auto& ctx = Context::the();
+  const auto saved_cache = ctx.ast_cache_;
+  ctx.ast_cache_ = sys::String(cache.native());
+
+  /// Neither of these parses a second file, but both
+  /// trees still depend on more than their own bytes.
+  write_file(dir / "self.rl", "@include \"self.rl\"\nproc f() -> { return a; }\n");
+  write_file(dir / "missing.rl", "@include \"nowhere.rl\"\nproc g() -> { return b; }\n");
+  write_file(dir / "plain.rl", "proc h() -> { return c; }\n");
+
+  NullOStream out, err;
+  (void)compile_all(make_inputs({ dir / "self.rl", dir / "missing.rl" }), 1, out, err, Context::DumpAST);
+  REQUIRE(cached_entries() == 0);
+
+  REQUIRE(compile_all(make_inputs({ dir / "plain.rl" }), 1, out, err, Context::DumpAST));
+  REQUIRE(cached_entries() == 1);
+
+  ctx.ast_cache_ = saved_cache;
+  std::filesystem::remove_all(dir);
+}
@@ -86,3 +86,16 @@ TEST_CASE("Construction", "[Frontend.Entity]") {
   REQUIRE(ptr4->y == 69);
   REQUIRE(ptr4->z == "foobar");
 }
+
+TEST_CASE("SwapKeepsName", "[Frontend.Entity]") {
+  EntityTable table(_nstr("SwapTable"));
+  auto holder = table.insert<PlaceHolder>(RL_ROOT_ENTITY_ID, 0, 1, 1, "entity");
+  holder->lname_id_ = StringPool::Index{ .offset = 7, .bucket = 1 };
+
+  /// Children are matched by lname_id_, so a swapped
+  /// entity has to stay findable under the same name.
+  auto swapped = table.swap_entity<EntFooBar>(holder->id_, RL_ROOT_ENTITY_ID, 5, 2, 1);
+  REQUIRE(swapped->lname_ == "entity");
+  REQUIRE(swapped->lname_id_.has_value());
+  REQUIRE(*swapped->lname_id_ == StringPool::Index{ .offset = 7, .bucket = 1 });
+}
@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <Tests/Frontend/SampleAst.hpp>
+#include <bit>
+#include <string>
+#include <vector>
+using namespace rl;
+
+TEST_CASE("FlatAstFromParser", "[Frontend.FlatAst]") {
+  SampleAst sample;
+  REQUIRE(sample.ctx.toplevel_decls_.size() == 2);
+
+  const auto flat = FlatAst::from_tree(sample.ctx.toplevel_decls_);
+
+  SECTION("MatchesTreeDump") {
+    StringOStream tree_out, flat_out;
+    for(const auto* decl : sample.ctx.toplevel_decls_) decl->print(0, tree_out, Nothing);
+    flat.dump(flat_out);
+
+    REQUIRE(!flat_out.str().empty());
+    REQUIRE(flat_out.str().find("Call.Args.3") != std::string::npos);
+    REQUIRE(flat_out.str() == tree_out.str());
+  }
+
+  SECTION("PreOrderLinks") {
+    REQUIRE(flat.kinds_[0] == AstNode::Type::Namespace);
+    REQUIRE(flat.parents_[0] == FlatAst::none_);
+
+    /// The second procedure is the first one's next sibling.
+    const auto second = flat.next_sibling_[0];
+    REQUIRE(second != FlatAst::none_);
+    REQUIRE(flat.kinds_[second] == AstNode::Type::ProcDecl);
+    REQUIRE(flat.parents_[second] == FlatAst::none_);
+    REQUIRE(flat.next_sibling_[second] == FlatAst::none_);
+
+    for(FlatAst::Index i = 0; i < flat.size(); i++) {
+      if(flat.parents_[i] != FlatAst::none_)      REQUIRE(flat.parents_[i] < i);
+      if(flat.first_child_[i] != FlatAst::none_)  REQUIRE(flat.first_child_[i] == i + 1);
+      if(flat.next_sibling_[i] != FlatAst::none_) {
+        REQUIRE(flat.next_sibling_[i] > i);
+        REQUIRE(flat.parents_[ flat.next_sibling_[i] ] == flat.parents_[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE("FlatAstPayloads", "[Frontend.FlatAst]") {
+  AstArena arena;
+  auto* ret  = AstNode::create<AstReturn>(arena, 10, 2, nullptr, 7);
+  auto* expr = AstNode::create<AstBinExpr>(arena, 17, 2, ret, 7);
+  auto* left = AstNode::create<AstEntityRef>(arena, 17, 2, expr, 7);
+  auto* lit  = AstNode::create<AstScalarLiteral>(arena, 21, 2, expr, 7);
+
+  ret->value_      = expr;
+  expr->op_type_   = TokenType::Plus;
+  expr->left_      = left;
+  expr->right_     = lit;
+  left->id_        = 42;
+  lit->scalar_type_ = AstScalarLiteral::FloatLit;
+  lit->float_value_ = 2.5;
+
+  const std::vector<AstNode::Ptr<>> roots{ ret };
+  const auto flat = FlatAst::from_tree(roots);
+  REQUIRE(flat.size() == 4);
+
+  const std::vector expected_kinds{
+    AstNode::Type::Return, AstNode::Type::BinExpr,
+    AstNode::Type::EntityRef, AstNode::Type::ScalarLiteral,
+  };
+  REQUIRE(flat.kinds_ == expected_kinds);
+  REQUIRE(SourcePos(flat.pos_[3]) == 21);
+  REQUIRE(flat.files_[2] == 7);
+  REQUIRE(flat.lines_[1] == 2);
+
+  REQUIRE(flat.fields_[2] == 0);
+  REQUIRE(flat.fields_[3] == 1);
+  REQUIRE(flat.next_sibling_[2] == 3);
+  REQUIRE(flat.parents_[3] == 1);
+
+  REQUIRE(flat.ops_[ flat.payload_[1] ].type == TokenType::Plus);
+  REQUIRE(flat.payload_[2] == 42);
+
+  const auto& scalar = flat.scalars_[ flat.payload_[3] ];
+  REQUIRE(scalar.type == AstScalarLiteral::FloatLit);
+  REQUIRE(std::bit_cast<double>(scalar.bits) == 2.5);
+  REQUIRE(scalar.string == FlatAst::none_);
+}
@@ -0,0 +1,249 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Parser/IncludePrefetcher.hpp>
+#include <n19/Frontend/Parser/Parser.hpp>
+#include <n19/Frontend/Parser/ParseContext.hpp>
+#include <n19/Frontend/FrontendContext.hpp>
+#include <n19/Core/Console.hpp>
+#include <n19/Core/Stream.hpp>
+#include <n19/System/File.hpp>
+#include <Tests/TempFiles.hpp>
+#include <filesystem>
+#include <string>
+#include <utility>
+using namespace rl;
+
+TEST_CASE("IncludePrefetcherOrder", "[Frontend.IncludePrefetcher]") {
+  const auto dir = std::filesystem::temp_directory_path() / "n19_suite_include_prefetcher";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  const auto first  = dir / "first.rl";
+  const auto second = dir / "second.rl";
+  write_file(first,  "proc first() -> { return a; }\n");
+  write_file(second, "proc second() -> { return b + c; }\n");
+
+  IncludePrefetcher prefetcher;
+  REQUIRE_FALSE(prefetcher.next().has_value());
+
+  prefetcher.enqueue(10, sys::String(first.native()));
+  prefetcher.enqueue(11, sys::String((dir / "missing.rl").native()));
+  prefetcher.enqueue(12, sys::String(second.native()));
+
+  auto a = prefetcher.next();
+  REQUIRE(a.has_value());
+  REQUIRE(a->id == 10);
+  REQUIRE(a->lexer.has_value());
+
+  auto missing = prefetcher.next();
+  REQUIRE(missing.has_value());
+  REQUIRE(missing->id == 11);
+  REQUIRE_FALSE(missing->lexer.has_value());
+
+  auto b = prefetcher.next();
+  REQUIRE(b.has_value());
+  REQUIRE(b->id == 12);
+  REQUIRE(b->lexer.has_value());
+  REQUIRE_FALSE(prefetcher.next().has_value());
+  REQUIRE(prefetcher.stats().files == 3);
+
+  SECTION("SwapsIntoAnEagerLexer") {
+    auto file = sys::File::open(first.native(), false, sys::File::Read).value();
+    auto lexer = Lexer::create_shared(file).value();
+    file.close();
+
+    /// Same stream as lexing the file directly, with
+    /// identifiers interned into the receiving lexer's pool.
+    REQUIRE(lexer->reset(**b->lexer).has_value());
+    std::string tokens;
+    while(lexer->current() != TokenType::EndOfFile) {
+      const Token tok = lexer->current();
+      const auto view = tok.view(*lexer);
+      const std::string text(view.begin(), view.end());
+      if(tok == TokenType::Identifier) {
+        const auto str = lexer->interned(tok);
+        REQUIRE(str.has_value());
+        REQUIRE(lexer->strings().get_index(text) == str->index);
+      }
+
+      tokens += text + " ";
+      lexer->consume(1);
+    }
+
+    REQUIRE(tokens == "proc second ( ) -> { return b + c ; } ");
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("IncludePrefetcherParse", "[Frontend.IncludePrefetcher]") {
+  const auto dir = std::filesystem::temp_directory_path() / "n19_suite_include_parse";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  const auto main     = dir / "main.rl";
+  const auto included = dir / "included.rl";
+  write_file(main, "proc f() -> { return a; }\n");
+  write_file(included, "proc g() -> { return b; }\n");
+
+  auto& frontend = Context::the();
+  auto saved_inputs = std::move(frontend.inputs_);
+  frontend.inputs_.clear();
+
+  /// A made-up ID could be the one the include gets, and
+  /// then it would count as this compilation's own file.
+  const InputFile::ID main_id = Context::get_next_input_id();
+
+  {
+    auto file  = sys::File::open(main.native(), false, sys::File::Read).value();
+    auto lexer = Lexer::create_shared(file).value();
+    file.close();
+
+    EntityTable table(_nstr("IncludeTable"));
+    ErrorCollector errors;
+    ParseContext ctx(main_id, errs(), errors, *lexer, table);
+
+    rl::detail_::register_include_(ctx, sys::String(included.native()));
+    rl::detail_::register_include_(ctx, sys::String(included.native()));  /// Already queued.
+    REQUIRE(frontend.inputs_.size() == 1);
+
+    const InputFile::ID id = frontend.inputs_.front().id;
+    REQUIRE(frontend.inputs_.front().kind == InputFileKind::Included);
+    REQUIRE(frontend.inputs_.front().state == InputFileState::Pending);
+
+    REQUIRE(parse(ctx));
+    REQUIRE(ctx.toplevel_decls_.size() == 2);
+    REQUIRE(ctx.toplevel_decls_.back()->file_ == id);
+    REQUIRE(ctx.curr_file == id);
+    REQUIRE(frontend.inputs_.front().state == InputFileState::Finished);
+    REQUIRE(ctx.includes.stats().files == 1);
+  }
+
+  /// Another compilation including the same file gets the
+  /// same ID, and still parses it for itself.
+  {
+    auto file  = sys::File::open(main.native(), false, sys::File::Read).value();
+    auto lexer = Lexer::create_shared(file).value();
+    file.close();
+
+    EntityTable table(_nstr("IncludeTable"));
+    ErrorCollector errors;
+    ParseContext ctx(main_id, errs(), errors, *lexer, table);
+
+    rl::detail_::register_include_(ctx, sys::String(included.native()));
+    REQUIRE(frontend.inputs_.size() == 1);
+    REQUIRE(parse(ctx));
+    REQUIRE(ctx.toplevel_decls_.size() == 2);
+    REQUIRE(ctx.toplevel_decls_.back()->file_ == frontend.inputs_.front().id);
+  }
+
+  frontend.inputs_ = std::move(saved_inputs);
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("IncludeDirective", "[Frontend.IncludePrefetcher]") {
+  const auto dir = std::filesystem::temp_directory_path() / "n19_suite_include_directive";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "sub");
+
+  const auto included = dir / "sub" / "included.rl";
+  write_file(included, "proc g() -> { return b; }\n");
+
+  auto& frontend = Context::the();
+  auto saved_inputs = std::move(frontend.inputs_);
+  frontend.inputs_.clear();
+
+  auto parse_file = [&](const std::string& source, EntityTable& table, ErrorCollector& errors, NullOStream& err) {
+    const auto main = dir / "main.rl";
+    write_file(main, source);
+    auto file  = sys::File::open(main.native(), false, sys::File::Read).value();
+    auto lexer = Lexer::create_shared(file).value();
+    file.close();
+
+    ParseContext ctx(Context::get_next_input_id(), err, errors, *lexer, table);
+    const bool ok = parse(ctx);
+    return std::make_pair(ok, ctx.toplevel_decls_.size());
+  };
+
+  SECTION("RelativeToIncludingFile") {
+    EntityTable table(_nstr("IncludeTable"));
+    ErrorCollector errors;
+    NullOStream err;
+    const auto [ok, decls] = parse_file("@include \"sub/included.rl\"\nproc f() -> { return a; }\n", table, errors, err);
+    REQUIRE(ok);
+    REQUIRE(decls == 2);
+    REQUIRE(frontend.inputs_.size() == 1);
+    REQUIRE(frontend.inputs_.front().name == sys::String(included.lexically_normal().native()));
+  }
+
+  SECTION("Malformed") {
+    for(const std::string source : { "@nope \"x.rl\"\n", "@include x\n", "@include \"\"\n", "namespace a { @include \"x.rl\" }\n" }) {
+      EntityTable table(_nstr("IncludeTable"));
+      ErrorCollector errors;
+      NullOStream err;
+      REQUIRE_FALSE(parse_file(source, table, errors, err).first);
+      REQUIRE(frontend.inputs_.empty());
+    }
+  }
+
+  frontend.inputs_ = std::move(saved_inputs);
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("SkimmedBodiesAcrossIncludes", "[Frontend.IncludePrefetcher]") {
+  const auto dir = std::filesystem::temp_directory_path() / "n19_suite_skim_include";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  const auto main = dir / "main.rl";
+  write_file(main,
+    "@include \"included.rl\"\n"
+    "proc f() -> { return a + b; }\n"
+    "proc bad() -> { return a as b; }\n");
+  write_file(dir / "included.rl", "proc g() -> { return c; }\n");
+
+  auto& frontend = Context::the();
+  auto saved_inputs = std::move(frontend.inputs_);
+
+  for(const auto mode : { LexMode::Eager, LexMode::OnDemand }) {
+    frontend.inputs_.clear();
+    auto file  = sys::File::open(main.native(), false, sys::File::Read).value();
+    auto lexer = Lexer::create_shared(file, mode).value();
+    file.close();
+
+    EntityTable table(_nstr("SkimIncludeTable"));
+    ErrorCollector errors;
+    StringOStream sink;
+    ParseContext ctx(Context::get_next_input_id(), sink, errors, *lexer, table);
+    ctx.skim_bodies = true;
+
+    REQUIRE(parse(ctx));
+    REQUIRE(ctx.toplevel_decls_.size() == 3);
+    const InputFile::ID included = frontend.inputs_.front().id;
+    REQUIRE(ctx.curr_file == included);
+
+    /// main.rl's bodies are still there after the lexer
+    /// moved on, and parsing one doesn't move it back.
+    auto* f   = static_cast<AstProcDecl*>(ctx.toplevel_decls_[0]);
+    auto* bad = static_cast<AstProcDecl*>(ctx.toplevel_decls_[1]);
+    REQUIRE(f->ensure_body(ctx).has_value());
+    REQUIRE(f->body_.size() == 1);
+    REQUIRE(ctx.curr_file == included);
+    REQUIRE(ctx.lxr.current() == TokenType::EndOfFile);
+    REQUIRE(std::filesystem::path(ctx.lxr.file_name_).filename() == "included.rl");
+
+    REQUIRE_FALSE(bad->ensure_body(ctx).has_value());
+    REQUIRE(sink.str().find("main.rl:3") != std::string::npos);
+
+    REQUIRE(parse_pending_bodies(ctx));
+    REQUIRE(static_cast<AstProcDecl*>(ctx.toplevel_decls_[2])->body_.size() == 1);
+    REQUIRE(ctx.parked_files_.empty());
+  }
+
+  frontend.inputs_ = std::move(saved_inputs);
+  std::filesystem::remove_all(dir);
+}
@@ -6,18 +6,29 @@
 #include <catch2/catch_test_macros.hpp>
 #include <n19/Frontend/Lexer/Lexer.hpp>
 #include <n19/Frontend/Lexer/Token.hpp>
+#include <n19/System/PageAllocator.hpp>
+#include <n19/Core/TokenDump.hpp>
+#include <n19/Core/Stream.hpp>
+#include <Tests/Frontend/TokenStreams.hpp>
+#include <Tests/TempFiles.hpp>
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <filesystem>
+#include <random>
 using namespace rl;
 
-static auto create_lexer(const std::string& source) -> std::shared_ptr<Lexer> {
+static auto create_lexer(
+  const std::string& source,
+  const LexMode mode = LexMode::Eager ) -> std::shared_ptr<Lexer>
+{
   std::vector<char8_t> buffer;
   buffer.reserve(source.size());
   for(auto c : source) {
     buffer.push_back(static_cast<char8_t>(c));
   }
 
-  return Lexer::create_shared(std::move(buffer)).value();
+  return Lexer::create_shared(std::move(buffer), mode).value();
 }
 
 TEST_CASE("BasicTokenRecognition", "[Frontend.Lexer]") {
@@ -136,6 +147,67 @@ TEST_CASE("BasicTokenRecognition", "[Frontend.Lexer]") {
   }
 }
 
+TEST_CASE("OperatorTable", "[Frontend.Lexer]") {
+  std::vector<std::pair<std::string, TokenType>> spellings;
+#define X(TYPE, STR, CAT_UNUSED)                                    \
+  if(!std::string_view(STR).empty()                                 \
+    && std::string_view(STR).find_first_not_of("!$%&()*+,-./:;<=>@[]^{|}~") == std::string_view::npos) \
+    spellings.emplace_back(STR, TokenType::TYPE);
+  RL_TOKEN_TYPE_LIST
+#undef X
+  REQUIRE(spellings.size() > 40);
+
+  SECTION("EverySpelling") {
+    for(const auto& [spelling, type] : spellings) {
+      auto lexer = create_lexer(spelling + " x");
+      REQUIRE(lexer->current().type_ == type);
+      REQUIRE(lexer->current().len_ == spelling.size());
+      REQUIRE(lexer->current().cat() == TokenCategory::of(type));
+      REQUIRE(lexer->consume(1).type_ == TokenType::Identifier);
+    }
+  }
+
+  SECTION("AdjacentPairs") {
+    /// Separated by a space, any two spellings lex
+    /// back as exactly those two tokens.
+    for(const auto& [a, type_a] : spellings) {
+      std::string source;
+      for(const auto& [b, type_b] : spellings) source += a + " " + b + "\n";
+
+      auto lexer = create_lexer(source);
+      for(const auto& [b, type_b] : spellings) {
+        REQUIRE(lexer->current().type_ == type_a);
+        REQUIRE(lexer->consume(1).type_ == type_b);
+        lexer->consume(1);
+      }
+    }
+  }
+
+  SECTION("MaximalMunch") {
+    auto lexer = create_lexer("<<==>>>=....:::->=>");
+    for(const auto type : {
+      TokenType::LshiftEq, TokenType::FatArrow, TokenType::RshiftEq, TokenType::DotThree, TokenType::Dot, TokenType::NamespaceOperator,
+      TokenType::TypeAssignment, TokenType::SkinnyArrow, TokenType::FatArrow })
+    {
+      REQUIRE(lexer->current().type_ == type);
+      lexer->consume(1);
+    }
+
+    REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
+  }
+
+  SECTION("Categories") {
+    using enum TokenCategory::Value;
+    REQUIRE(TokenCategory::of(TokenType::Inc) == TokenCategory(
+      UnaryOp | ArithAssignOp | ArithmeticOp | PointerArithOp | ValidPostfix | ValidPrefix));
+    REQUIRE(TokenCategory::of(TokenType::Comma) == TokenCategory(Punctuator | Terminator));
+    REQUIRE(TokenCategory::of(TokenType::LeftParen) == TokenCategory(Punctuator | ValidPostfix));
+    REQUIRE(TokenCategory::of(TokenType::Identifier) == TokenCategory(Identifier));
+    REQUIRE(TokenCategory::of(TokenType::StringLiteral) == TokenCategory(Literal));
+    REQUIRE(TokenCategory::of(TokenType::Illegal) == TokenCategory(NonCategorical));
+  }
+}
+
 TEST_CASE("Literals", "[Frontend.Lexer]") {
   SECTION("IntegerLiterals") {
     auto lexer = create_lexer("42 0 123456789");
@@ -246,10 +318,53 @@ TEST_CASE("Literals", "[Frontend.Lexer]") {
     
     REQUIRE(lexer->current().type_ == TokenType::NullLiteral);
     REQUIRE(lexer->current().value(*lexer).value() == "null");
+    REQUIRE(!lexer->literal(lexer->current()).has_value());
     lexer->consume(1);
     
     REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
   }
+
+  SECTION("DecodedValues") {
+    for(const LexMode mode : { LexMode::Eager, LexMode::OnDemand }) {
+      auto lexer = create_lexer("42 0x1F 0777 1.5e3 18446744073709551615", mode);
+
+      auto lit = lexer->literal(lexer->current());
+      REQUIRE(lit.has_value());
+      REQUIRE(lit->integer == 42);
+      lexer->consume(1);
+
+      REQUIRE(lexer->peek(1).type_ == TokenType::OctalLiteral);
+      lit = lexer->literal(lexer->current());
+      REQUIRE(lit.has_value());
+      REQUIRE(lit->integer == 0x1F);
+      lexer->consume(1);
+
+      lit = lexer->literal(lexer->current());
+      REQUIRE(lit.has_value());
+      REQUIRE(lit->integer == 0777);
+      lexer->consume(1);
+
+      lit = lexer->literal(lexer->current());
+      REQUIRE(lit.has_value());
+      REQUIRE(lit->floating == 1500.0);
+      lexer->consume(1);
+
+      lit = lexer->literal(lexer->current());
+      REQUIRE(lit.has_value());
+      REQUIRE(lit->in_range);
+      REQUIRE(lit->integer == UINT64_MAX);
+    }
+  }
+
+  SECTION("OutOfRange") {
+    auto lexer = create_lexer("18446744073709551616 0x10000000000000000 1e999");
+    while(lexer->current() != TokenType::EndOfFile) {
+      const auto lit = lexer->literal(lexer->current());
+      REQUIRE(lit.has_value());
+      REQUIRE(!lit->in_range);
+      lexer->consume(1);
+    }
+  }
 }
 
 TEST_CASE("IdentifiersAndKeywords", "[Frontend.Lexer]") {
@@ -308,6 +423,38 @@ TEST_CASE("IdentifiersAndKeywords", "[Frontend.Lexer]") {
     
     REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
   }
+
+  SECTION("KeywordTable") {
+    using enum TokenCategory::Value;
+#define KEYWORD_X(NAME, TYPE, CAT)                                  \
+    {                                                               \
+      auto kw = Lexer::get_keyword(u8##NAME);                       \
+      REQUIRE(kw.has_value());                                      \
+      REQUIRE(kw->type == TokenType::TYPE);                         \
+      REQUIRE(kw->cat == TokenCategory(CAT));                       \
+      REQUIRE(TokenType::from_keyword(u8##NAME).value() == TokenType::TYPE); \
+      REQUIRE(TokenCategory::of(TokenType::TYPE) == TokenCategory(CAT)); \
+    }
+    LR_KEYWORDS
+#undef KEYWORD_X
+  }
+
+  SECTION("KeywordNearMisses") {
+    for(const auto* str : {
+      u8"continu", u8"compevak", u8"contenue", u8"Return", u8"returN",
+      u8"defer_", u8"defer_iff", u8"i", u8"", u8"nul", u8"nulll",
+      u8"proce", u8"_proc", u8"fallthroug", u8"namespaces" })
+    {
+      REQUIRE(!Lexer::get_keyword(str).has_value());
+    }
+
+    auto lexer = create_lexer("continue compeval compevak");
+    REQUIRE(lexer->current().type_ == TokenType::Continue);
+    lexer->consume(1);
+    REQUIRE(lexer->current().type_ == TokenType::CompEval);
+    lexer->consume(1);
+    REQUIRE(lexer->current().type_ == TokenType::Identifier);
+  }
 }
 
 TEST_CASE("Peeking", "[Frontend.Lexer]") {
@@ -361,8 +508,8 @@ TEST_CASE("Peeking", "[Frontend.Lexer]") {
     
     // Current token should still be the same
     REQUIRE(lexer->current().type_ == tok.type_);
-    REQUIRE(lexer->current().cat_  == tok.cat_);
-    REQUIRE(lexer->current().line_ == tok.line_);
+    REQUIRE(lexer->current().cat()  == tok.cat());
+    REQUIRE(lexer->line_of(lexer->current()) == lexer->line_of(tok));
     REQUIRE(lexer->current().pos_  == tok.pos_);
   }
 }
@@ -400,46 +547,46 @@ TEST_CASE("LineCounting", "[Frontend.Lexer]") {
   SECTION("BasicLineCounting") {
     auto lexer = create_lexer("42\n+ 10\n* 5");
     
-    REQUIRE(lexer->current().line_ == 1);
+    REQUIRE(lexer->line_of(lexer->current()) == 1);
     REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 2);
+    REQUIRE(lexer->line_of(lexer->current()) == 2);
     REQUIRE(lexer->current().type_ == TokenType::Plus);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 2);
+    REQUIRE(lexer->line_of(lexer->current()) == 2);
     REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 3);
+    REQUIRE(lexer->line_of(lexer->current()) == 3);
     REQUIRE(lexer->current().type_ == TokenType::Mul);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 3);
+    REQUIRE(lexer->line_of(lexer->current()) == 3);
     REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 3);
+    REQUIRE(lexer->line_of(lexer->current()) == 3);
     REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
   }
 
   SECTION("Comments") {
     auto lexer = create_lexer("42 # This is a comment\n+ 10");
     
-    REQUIRE(lexer->current().line_ == 1);
+    REQUIRE(lexer->line_of(lexer->current()) == 1);
     REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 2);
+    REQUIRE(lexer->line_of(lexer->current()) == 2);
     REQUIRE(lexer->current().type_ == TokenType::Plus);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 2);
+    REQUIRE(lexer->line_of(lexer->current()) == 2);
     REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
     lexer->consume(1);
     
-    REQUIRE(lexer->current().line_ == 2);
+    REQUIRE(lexer->line_of(lexer->current()) == 2);
     REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
   }
 }
@@ -471,15 +618,25 @@ TEST_CASE("Expect", "[Frontend.Lexer]") {
 }
 
 TEST_CASE("Revert", "[Frontend.Lexer]") {
-  auto lexer = create_lexer("42 + 10");    
-  REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
-  auto token = lexer->current();
+  for(const auto mode : { LexMode::Eager, LexMode::OnDemand }) {
+    auto lexer = create_lexer("42 + 10\n+ 7", mode);
+    REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
+    auto token = lexer->current();
 
-  lexer->consume(1);
-  REQUIRE(lexer->current().type_ == TokenType::Plus);
+    lexer->consume(1);
+    REQUIRE(lexer->current().type_ == TokenType::Plus);
+
+    lexer->revert_before(token);
+    REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
 
-  lexer->revert_before(token);
-  REQUIRE(lexer->current().type_ == TokenType::IntLiteral);
+    /// Every mode picks up right after the token it reverted to.
+    REQUIRE(lexer->consume(1).type_ == TokenType::Plus);
+    const auto ten = lexer->consume(1);
+    lexer->consume(2);
+    lexer->revert_before(ten);
+    REQUIRE(lexer->consume(1).type_ == TokenType::Plus);
+    REQUIRE(lexer->line_of(lexer->current()) == 2);
+  }
 }
 
 TEST_CASE("UTF8Parsing", "[Frontend.Lexer]") {
@@ -569,6 +726,17 @@ TEST_CASE("UTF8Parsing", "[Frontend.Lexer]") {
     
     REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
   }
+
+  SECTION("InvalidUTF8Rejected") {
+    std::vector<char8_t> buffer;
+    for(const char ch : std::string_view("let a = 1;\nlet b = \"")) buffer.push_back(char8_t(ch));
+    buffer.push_back(0xC3);                   /// Missing its continuation byte.
+    buffer.push_back(u8'"');
+
+    const auto lexer = Lexer::create_shared(std::move(buffer));
+    REQUIRE(!lexer.has_value());
+    REQUIRE(lexer.error().msg.find("line 2, byte offset 20") != std::string::npos);
+  }
 }
 
 TEST_CASE("CharacterLiterals", "[Frontend.Lexer]") {
@@ -656,3 +824,575 @@ TEST_CASE("InvalidTokens", "[Frontend.Lexer]") {
     REQUIRE(lexer->current().type_ == TokenType::EndOfFile);
   }
 }
+
+TEST_CASE("LexModes", "[Frontend.Lexer]") {
+  const std::string source =
+    "proc main() -> {\n"
+    "  let x: i32 = (42 + 0x1F) * 3.14e-2; # comment\n"
+    "  foo::bar(x, \"str\", 'c') >>= 017 ? 1.2.3 \\ \n"
+    "  \"unterminated\n"
+    "}\n";
+
+  SECTION("IdenticalStreams") {
+    auto eager    = create_lexer(source, LexMode::Eager);
+    auto ondemand = create_lexer(source, LexMode::OnDemand);
+    REQUIRE(eager->mode() == LexMode::Eager);
+    REQUIRE(ondemand->mode() == LexMode::OnDemand);
+
+    while(true) {
+      const Token a = eager->current();
+      const Token b = ondemand->current();
+      REQUIRE(a.type_ == b.type_);
+      REQUIRE(a.cat() == b.cat());
+      REQUIRE(a.pos_  == b.pos_);
+      REQUIRE(a.len_  == b.len_);
+      REQUIRE(eager->line_of(a) == ondemand->line_of(b));
+
+      if(a == TokenType::EndOfFile) break;
+      eager->consume(1);
+      ondemand->consume(1);
+    }
+  }
+
+  SECTION("PeekMatchesOnDemand") {
+    auto eager    = create_lexer(source, LexMode::Eager);
+    auto ondemand = create_lexer(source, LexMode::OnDemand);
+
+    while(eager->current() != TokenType::EndOfFile) {
+      for(uint32_t i = 0; i < 4; i++) {
+        REQUIRE(eager->peek(i).pos_ == ondemand->peek(i).pos_);
+      }
+
+      const auto a = eager->batched_peek<3>();
+      const auto b = ondemand->batched_peek<3>();
+      for(size_t i = 0; i < a.size(); i++) {
+        REQUIRE(a[i].type_ == b[i].type_);
+        REQUIRE(a[i].pos_  == b[i].pos_);
+      }
+
+      REQUIRE(eager->current().pos_ == ondemand->current().pos_);
+      eager->consume(1);
+      ondemand->consume(1);
+    }
+  }
+
+  SECTION("RevertBefore") {
+    auto lexer = create_lexer(source, LexMode::Eager);
+    lexer->consume(2);
+
+    const auto saved = lexer->current();
+    const auto after = lexer->peek(1);
+    lexer->consume(5);
+    REQUIRE(lexer->current().pos_ != saved.pos_);
+
+    lexer->revert_before(saved);
+    REQUIRE(lexer->current().pos_ == saved.pos_);
+    REQUIRE(lexer->consume(1).pos_ == after.pos_);
+  }
+
+  SECTION("PastEndOfFile") {
+    auto lexer = create_lexer("a + b", LexMode::Eager);
+    REQUIRE(lexer->peek(100) == TokenType::EndOfFile);
+    REQUIRE(lexer->consume(100) == TokenType::EndOfFile);
+    REQUIRE(lexer->consume(1) == TokenType::EndOfFile);
+
+    const auto eof = lexer->current();
+    lexer->revert_before(eof);
+    REQUIRE(lexer->current() == TokenType::EndOfFile);
+  }
+}
+
+TEST_CASE("LineIndex", "[Frontend.Lexer]") {
+  const std::vector<std::string> lines = {
+    "proc main() -> {",
+    "",
+    "  let x: i32 = 1; # comment",
+    "\t\t  foo(x, \"str\")   ",
+    "",
+    "",
+    "}",
+  };
+
+  std::string source;
+  for(const auto& line : lines) source += line + "\n";
+
+  auto check_tokens = [&](Lexer& lxr) {
+    while(true) {
+      const Token tok = lxr.current();
+      if(tok == TokenType::EndOfFile) break;
+
+      const LineCol pos = lxr.line_col(tok.pos_);
+      const SourcePos at = tok.pos_;
+      REQUIRE(pos.line == 1 + std::count(source.begin(), source.begin() + at, '\n'));
+
+      const auto text = lxr.line_span(pos.line);
+      REQUIRE(pos.column >= 1);
+      REQUIRE(pos.column - 1 + tok.len_ <= text.size());
+      REQUIRE(text.data() + pos.column - 1 == lxr.src_.data() + lxr.offset_in_window(tok.pos_));
+      lxr.consume(1);
+    }
+  };
+
+  SECTION("Queries") {
+    auto lexer = create_lexer(source, LexMode::Eager);
+    REQUIRE(lexer->line_count() == lines.size() + 1);
+
+    for(uint32_t i = 0; i < lines.size(); i++) {
+      const auto text = lexer->line_span(i + 1);
+      REQUIRE(std::string(text.begin(), text.end()) == lines[i]);
+    }
+
+    REQUIRE(lexer->line_span(0).empty());
+    REQUIRE(lexer->line_span(100).empty());
+    REQUIRE(lexer->line_col(0).line == 1);
+    REQUIRE(lexer->line_col(0).column == 1);
+    REQUIRE(lexer->line_col(source.find("let")).line == 3);
+    REQUIRE(lexer->line_col(source.find("let")).column == 3);
+    REQUIRE(lexer->line_col(source.find("foo")).column == 5);
+    check_tokens(*lexer);
+  }
+
+  SECTION("OnDemandWithBacktracking") {
+    auto lexer = create_lexer(source, LexMode::OnDemand);
+    lexer->peek(8);
+    lexer->consume(4);
+    const auto saved = lexer->current();
+    lexer->consume(10);
+    lexer->revert_before(saved);
+    check_tokens(*lexer);
+    REQUIRE(lexer->line_count() == lines.size() + 1);
+  }
+
+  SECTION("Parallel") {
+    ThreadPool pool(3);
+    auto eager    = create_lexer(source, LexMode::Eager);
+    auto parallel = Lexer::create_parallel(std::vector<char8_t>(source.begin(), source.end()), pool, 5).value();
+    REQUIRE(parallel->line_count() == eager->line_count());
+    for(uint32_t i = 1; i <= eager->line_count(); i++) {
+      REQUIRE(parallel->line_span(i).size() == eager->line_span(i).size());
+    }
+
+    check_tokens(*parallel);
+  }
+}
+
+TEST_CASE("Interning", "[Frontend.Lexer]") {
+  auto spelling = [](Lexer& lxr, const Token& tok) -> std::string {
+    const auto str = lxr.interned(tok);
+    REQUIRE(str.has_value());
+    REQUIRE(str->hash == lxr.strings().hash_of(lxr.strings().get_string(str->index)));
+    return std::string(lxr.strings().get_string(str->index));
+  };
+
+  SECTION("Identifiers") {
+    auto lexer = create_lexer("foo bar foo 42 const");
+    const Token foo1 = lexer->current();
+    const Token bar  = lexer->consume(1);
+    const Token foo2 = lexer->consume(1);
+
+    REQUIRE(spelling(*lexer, foo1) == "foo");
+    REQUIRE(spelling(*lexer, bar) == "bar");
+    REQUIRE(lexer->interned(foo1)->index == lexer->interned(foo2)->index);
+    REQUIRE(lexer->interned(foo1)->index != lexer->interned(bar)->index);
+
+    REQUIRE(!lexer->interned(lexer->consume(1)).has_value());   /// 42
+    REQUIRE(!lexer->interned(lexer->consume(1)).has_value());   /// const
+  }
+
+  SECTION("StringLiterals") {
+    auto lexer = create_lexer("\"plain\" \"esc\\tape\" \"\" \"plain\" \"bad\\q\"");
+    const Token plain = lexer->current();
+    REQUIRE(spelling(*lexer, plain) == "plain");
+    REQUIRE(spelling(*lexer, lexer->consume(1)) == "esc\tape");
+    REQUIRE(!lexer->interned(lexer->consume(1)).has_value());   /// Empty.
+    REQUIRE(lexer->interned(lexer->consume(1))->index == lexer->interned(plain)->index);
+    REQUIRE(!lexer->interned(lexer->consume(1)).has_value());   /// Invalid escape.
+  }
+
+  SECTION("LexModes") {
+    std::string source;
+    for(int i = 0; i < 300; i++) {
+      source += "let name" + std::to_string(i % 17) + " = \"s" + std::to_string(i % 5) + "\";\n";
+    }
+
+    ThreadPool pool(4);
+    std::vector<char8_t> buffer(source.begin(), source.end());
+    auto eager    = create_lexer(source, LexMode::Eager);
+    auto ondemand = create_lexer(source, LexMode::OnDemand);
+    auto parallel = Lexer::create_parallel(std::move(buffer), pool, 128).value();
+
+    while(eager->current() != TokenType::EndOfFile) {
+      const Token tok = eager->current();
+      ondemand->peek(2);
+      REQUIRE(ondemand->current().pos_ == tok.pos_);
+      REQUIRE(parallel->current().pos_ == tok.pos_);
+
+      if(tok == TokenType::Identifier || tok == TokenType::StringLiteral) {
+        const std::string expect = spelling(*eager, tok);
+        REQUIRE(spelling(*ondemand, ondemand->current()) == expect);
+        REQUIRE(spelling(*parallel, parallel->current()) == expect);
+      }
+
+      eager->consume(1);
+      ondemand->consume(1);
+      parallel->consume(1);
+    }
+  }
+}
+
+TEST_CASE("ParallelLexing", "[Frontend.Lexer]") {
+  auto to_buffer = [](const std::string& source) {
+    return std::vector<char8_t>(source.begin(), source.end());
+  };
+
+  auto require_same_stream = [&](const std::string& source, const size_t chunk) {
+    ThreadPool pool(4);
+    auto serial   = create_lexer(source, LexMode::Eager);
+    auto parallel = Lexer::create_parallel(to_buffer(source), pool, chunk).value();
+    REQUIRE(parallel->mode() == LexMode::Eager);
+
+    while(true) {
+      const Token a = serial->current();
+      const Token b = parallel->current();
+      REQUIRE(a.type_ == b.type_);
+      REQUIRE(a.pos_  == b.pos_);
+      REQUIRE(a.len_  == b.len_);
+      REQUIRE(serial->line_of(a) == parallel->line_of(b));
+      REQUIRE(serial->literal(a).has_value() == parallel->literal(b).has_value());
+      if(serial->literal(a)) REQUIRE(serial->literal(a)->integer == parallel->literal(b)->integer);
+      if(a == TokenType::EndOfFile) break;
+      serial->consume(1);
+      parallel->consume(1);
+    }
+  };
+
+  SECTION("MatchesSerial") {
+    std::string source;
+    for(size_t i = 0; i < 50; i++) {
+      source += "proc main() -> {\n\n";
+      source += "  let x: i32 = (42 + 0x1F) * 3.14e-2; # comment \"not a string\n";
+      source += "  foo::bar(x, \"str # not a comment\", 'c') >>= 017 ? 1.2.3 \\ \n";
+      source += "  \"unterminated\n}\n";
+    }
+
+    for(const size_t chunk : { 1, 7, 64, 1000, 1 << 20 }) {
+      require_same_stream(source, chunk);
+    }
+  }
+
+  SECTION("RandomSources") {
+    /// Heavy on the bytes that change lexer state, so chunk
+    /// starts land inside strings, comments and broken tokens.
+    /// The last pick is a whole two byte sequence, never half of one.
+    constexpr std::string_view alphabet = "ab1_0x.e\"'#\\\n\n  -+=<>:;(){}";
+    std::mt19937 rng(1234);
+    for(size_t round = 0; round < 50; round++) {
+      std::string source;
+      const size_t len = 1 + rng() % 2000;
+      for(size_t i = 0; i < len; i++) {
+        const size_t pick = rng() % (alphabet.size() + 1);
+        if(pick == alphabet.size()) source += "\xC3\xA9";
+        else source += alphabet[pick];
+      }
+      require_same_stream(source, 1 + rng() % 64);
+    }
+  }
+
+  SECTION("EmbeddedNul") {
+    std::string source = "let a = 1;\nlet b = 2;\n";
+    source += '\0';
+    source += "\nlet c = 3;\n";
+    require_same_stream(source, 4);
+  }
+}
+
+TEST_CASE("FileSource", "[Frontend.Lexer]") {
+  const auto path = std::filesystem::temp_directory_path() / "n19_suite_lexer.rl";
+
+  SECTION("EndsOnPageBoundary") {
+    /// No trailing newline, and the last identifier runs right up
+    /// to the end of the mapping: the zero padding has to stop it.
+    const size_t page = sys::PageAllocator::page_size();
+    std::string contents = "let ";
+    contents += std::string(page - contents.size(), 'a');
+
+    auto file = create_file(path, contents);
+    auto lxr  = Lexer::create_shared(file).value();
+    REQUIRE(lxr->src_.size() == page);
+    REQUIRE(lxr->current().type_ == TokenType::Let);
+    lxr->consume(1);
+    REQUIRE(lxr->current().type_ == TokenType::Identifier);
+    REQUIRE(lxr->current().len_ == page - 4);
+    lxr->consume(1);
+    REQUIRE(lxr->current().type_ == TokenType::EndOfFile);
+    file.close();
+  }
+
+  SECTION("Reset") {
+    auto first = create_file(path, "proc");
+    auto lxr   = Lexer::create_shared(first).value();
+    REQUIRE(lxr->current().type_ == TokenType::Proc);
+    first.close();
+
+    auto second = create_file(path, "const x\n\"unterminated");
+    REQUIRE(lxr->reset(second).has_value());
+    REQUIRE(lxr->current().type_ == TokenType::Const);
+    lxr->consume(1);
+    REQUIRE(lxr->current().type_ == TokenType::Identifier);
+    lxr->consume(1);
+    REQUIRE(lxr->current().type_ == TokenType::Illegal);
+    REQUIRE(lxr->line_of(lxr->current()) == 2);
+    second.close();
+  }
+
+  SECTION("EmptyFile") {
+    auto file = create_file(path, "");
+    REQUIRE(!Lexer::create_shared(file).has_value());
+    REQUIRE(!Lexer::create_shared(file, LexMode::Streaming).has_value());
+    file.close();
+  }
+
+  SECTION("Streaming") {
+    std::string contents;
+    for(size_t i = 0; i < 40; i++) {
+      contents += "proc some_long_identifier_" + std::to_string(i) + "() -> {\n";
+      contents += "  let x: i32 = (0x1F + 017) * 3.14e-2; # trailing comment\n";
+      contents += "  foo::bar(x, \"a string literal\", 'c') >>= 1;\n}\n";
+      contents += "let \xE4\xB8\x96\xE7\x95\x8C = \"\xF0\x9F\x98\x80\";\n";
+    }
+
+    /// Multi-byte sequences get cut by the small windows.
+    auto file = create_file(path, contents);
+    for(const size_t window : { 16, 64, 4096 }) {
+      auto lxr = Lexer::create_shared(file, LexMode::Streaming, window).value();
+      REQUIRE(lxr->mode() == LexMode::Streaming);
+      auto reference = Lexer::create_shared(file).value();
+      while(true) {
+        const Token a = reference->current();
+        const Token b = lxr->current();
+        REQUIRE(a.type_ == b.type_);
+        REQUIRE(a.pos_  == b.pos_);
+        REQUIRE(a.len_  == b.len_);
+        REQUIRE(reference->line_of(a) == lxr->line_of(b));
+        REQUIRE(reference->literal(a).has_value() == lxr->literal(b).has_value());
+        if(reference->literal(a)) REQUIRE(reference->literal(a)->integer == lxr->literal(b)->integer);
+        REQUIRE(a.value(*reference).value_or("") == b.value(*lxr).value_or(""));
+        REQUIRE(reference->line_col(a.pos_).column == lxr->line_col(b.pos_).column);
+        if(a == TokenType::EndOfFile) break;
+
+        REQUIRE(reference->peek(2).pos_ == lxr->peek(2).pos_);
+        REQUIRE(reference->batched_peek<3>()[2].pos_ == lxr->batched_peek<3>()[2].pos_);
+        reference->consume(1);
+        lxr->consume(1);
+      }
+    }
+
+    file.close();
+  }
+
+  SECTION("StreamingRevert") {
+    std::string contents;
+    for(size_t i = 0; i < 200; i++) contents += "let x = y + 1;\n";
+
+    /// Streaming rewinds exactly like OnDemand does, as long
+    /// as the token is still inside the window.
+    auto file      = create_file(path, contents);
+    auto lxr       = Lexer::create_shared(file, LexMode::Streaming, 64).value();
+    auto reference = Lexer::create_shared(file, LexMode::OnDemand).value();
+    lxr->consume(150);
+    reference->consume(150);
+
+    const auto saved = lxr->current();
+    lxr->consume(3);
+    reference->consume(3);
+    REQUIRE(lxr->base() > 0);
+    REQUIRE(saved.pos_ >= lxr->base());
+
+    lxr->revert_before(saved);
+    reference->revert_before(saved);
+    REQUIRE(lxr->current().pos_ == saved.pos_);
+    REQUIRE(lxr->line_of(lxr->current()) == reference->line_of(saved));
+    REQUIRE(lxr->consume(1).pos_ == reference->consume(1).pos_);
+    REQUIRE(lxr->consume(1).pos_ == reference->consume(1).pos_);
+    file.close();
+  }
+
+  SECTION("StreamingTokenLargerThanWindow") {
+    const std::string ident(1000, 'q');
+    auto file = create_file(path, "let " + ident + " = \"" + ident + "\";");
+    auto lxr  = Lexer::create_shared(file, LexMode::Streaming, 16).value();
+
+    REQUIRE(lxr->current().type_ == TokenType::Let);
+    lxr->consume(1);
+    REQUIRE(lxr->current().type_ == TokenType::Identifier);
+    REQUIRE(lxr->current().len_ == ident.size());
+    REQUIRE(lxr->current().value(*lxr).value() == ident);
+    lxr->consume(2);
+    REQUIRE(lxr->current().type_ == TokenType::StringLiteral);
+    REQUIRE(lxr->current().pos_ == ident.size() + 7);
+    lxr->consume(2);
+    REQUIRE(lxr->current().type_ == TokenType::EndOfFile);
+    file.close();
+  }
+
+  SECTION("StreamingInvalidUTF8") {
+    std::string contents;
+    for(size_t i = 0; i < 100; i++) contents += "let x = y + 1;\n";
+    contents += "let \xC3( = 1;\n";
+
+    auto file  = create_file(path, contents);
+    auto eager = Lexer::create_shared(file);
+    REQUIRE(!eager.has_value());
+
+    /// Streaming only finds out when the window gets there,
+    /// but ends up with the same diagnostic.
+    auto lxr = Lexer::create_shared(file, LexMode::Streaming, 64).value();
+    while(lxr->current() != TokenType::EndOfFile && lxr->current() != TokenType::Illegal) {
+      REQUIRE(!lxr->stream_error().has_value());
+      lxr->consume(1);
+    }
+
+    REQUIRE(lxr->current().type_ == TokenType::Illegal);
+    REQUIRE(lxr->stream_error().has_value());
+    REQUIRE(lxr->stream_error()->msg == eager.error().msg);
+    REQUIRE(eager.error().msg == "Invalid UTF-8 on line 101, byte offset 1504.");
+    file.close();
+  }
+}
+
+TEST_CASE("IncrementalEdits", "[Frontend.Lexer]") {
+  auto apply = [](Lexer& lxr, std::string& source, size_t offset, size_t removed, const std::string& text) {
+    const std::vector<char8_t> bytes(text.begin(), text.end());
+    const auto range = lxr.apply_edit(offset, removed, bytes);
+    REQUIRE(range.has_value());
+    source.replace(offset, removed, text);
+    return *range;
+  };
+
+  /// apply_edit() keeps the cursor on the token it was on, which
+  /// can leave new tokens behind it. Compare from the start.
+  auto require_relexed = [](Lexer& lxr, const std::string& source) {
+    auto full = create_lexer(source);
+    lxr.revert_before(full->current());
+    require_same_stream(lxr, *full);
+  };
+
+  SECTION("ResyncsAfterEdit") {
+    std::string source;
+    for(int i = 0; i < 100; i++) source += "let x" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+
+    auto lexer = create_lexer(source);
+    const size_t before = lexer->line_count();
+    const size_t offset = source.find("x50");
+    const auto range = apply(*lexer, source, offset + 1, 2, "fifty");
+
+    /// Only the edited identifier (and the token before it) is re-lexed.
+    REQUIRE(range.end - range.begin == 2);
+    REQUIRE(range.replaced == 2);
+    REQUIRE(lexer->line_count() == before);
+    require_relexed(*lexer, source);
+  }
+
+  SECTION("OpensStringAndComment") {
+    std::string source = "a b c\nd e f\n";
+    auto lexer = create_lexer(source);
+
+    apply(*lexer, source, 2, 0, "\"");
+    require_relexed(*lexer, source);
+
+    apply(*lexer, source, 0, 0, "# ");
+    require_relexed(*lexer, source);
+
+    /// The cursor was on `d`, which survives the edit, so it
+    /// stays there even though a token now comes before it.
+    apply(*lexer, source, 0, 3, "");
+    REQUIRE(lexer->current().pos_ == source.find('d'));
+    require_relexed(*lexer, source);
+  }
+
+  SECTION("OutOfRange") {
+    auto lexer = create_lexer("abc");
+    const std::vector<char8_t> none;
+    REQUIRE(!lexer->apply_edit(4, 0, none).has_value());
+    REQUIRE(!lexer->apply_edit(1, 3, none).has_value());
+    REQUIRE(!lexer->apply_edit(0, 3, none).has_value());
+  }
+
+  SECTION("RandomEditScripts") {
+    constexpr std::string_view alphabet = "ab1_0x.e\"'#\\\n\n  -+=<>:;(){}";
+    std::mt19937 rng(4321);
+    auto random_text = [&](const size_t len) {
+      std::string text;
+      for(size_t i = 0; i < len; i++) {
+        const size_t pick = rng() % (alphabet.size() + 1);
+        if(pick == alphabet.size()) text += "\xC3\xA9";
+        else text += alphabet[pick];
+      }
+      return text;
+    };
+
+    for(size_t round = 0; round < 20; round++) {
+      std::string source = random_text(1 + rng() % 1000);
+      auto lexer = create_lexer(source);
+
+      for(size_t step = 0; step < 25; step++) {
+        const size_t offset  = rng() % (source.size() + 1);
+        size_t removed = std::min<size_t>(rng() % 8, source.size() - offset);
+        std::string text = random_text(rng() % 8);
+        if(removed == source.size() && text.empty()) text = "z";
+
+        /// Edits that split a sequence are refused, and change nothing.
+        std::string edited = source;
+        edited.replace(offset, removed, text);
+        const auto* first = reinterpret_cast<const char8_t*>(edited.data());
+        if(ByteScanner::find_invalid_utf8(first, first + edited.size()) != first + edited.size()) {
+          const std::vector<char8_t> bytes(text.begin(), text.end());
+          REQUIRE(!lexer->apply_edit(offset, removed, bytes).has_value());
+          continue;
+        }
+
+        apply(*lexer, source, offset, removed, text);
+        require_relexed(*lexer, source);
+      }
+    }
+  }
+}
+
+TEST_CASE("TokenDump", "[Frontend.Lexer]") {
+  const std::string source = "let x: i32 = 0x1F;\nfoo::bar(x, \"str\");\n";
+
+  SECTION("Text") {
+    auto lexer = create_lexer(source);
+    REQUIRE(lexer->current().format(*lexer)
+      == "Let         : \"let\" -- LINE=1,POS=0 -- Keyword\n");
+
+    lexer->consume(7);
+    REQUIRE(lexer->current().format(*lexer)
+      == "Identifier  : \"foo\" -- LINE=2,POS=19 -- Identifier\n");
+    REQUIRE(TokenCategory(TokenCategory::BinaryOp | TokenCategory::UnaryOp).to_string()
+      == "UnaryOp | BinaryOp");
+  }
+
+  SECTION("Binary") {
+    auto lexer  = create_lexer(source);
+    auto stream = BufferedOStream<4096>::create_testable();
+    lexer->dump_binary(stream);
+
+    const Bytes bytes{ stream.buffer_data(), stream.buffer_current() };
+    const auto reader = TokenDumpReader::create(bytes).value();
+
+    auto fresh = create_lexer(source);
+    for(size_t i = 0; i < reader.size(); i++) {
+      const Token tok = fresh->current();
+      const TokenRecord rec = reader.at(i);
+      REQUIRE(rec.type == tok.type_.value);
+      REQUIRE(rec.offset == SourcePos(tok.pos_));
+      REQUIRE(rec.len == tok.len_);
+      REQUIRE(rec.line == fresh->line_of(tok));
+      REQUIRE(rec.category == tok.cat().value);
+      fresh->consume(1);
+    }
+
+    REQUIRE(reader.at(reader.size() - 1).type == TokenType::EndOfFile);
+  }
+}
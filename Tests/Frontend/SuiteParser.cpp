@@ -0,0 +1,327 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Parser/Parser.hpp>
+#include <n19/Frontend/Parser/ParseContext.hpp>
+#include <n19/Core/Console.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+using namespace rl;
+
+/// Every allocation in the test binary goes through here,
+/// so a test can count what a piece of code costs.
+static std::atomic<size_t> allocations{ 0 };
+
+auto operator new(const size_t size) -> void* {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if(void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+auto operator delete(void* ptr) noexcept -> void {
+  std::free(ptr);
+}
+
+auto operator delete(void* ptr, size_t) noexcept -> void {
+  std::free(ptr);
+}
+
+static auto make_source(const size_t repeats) -> std::vector<char8_t> {
+  constexpr std::u8string_view line = u8"foo::bar\n";
+  std::vector<char8_t> buffer;
+  buffer.reserve(line.size() * repeats);
+  for(size_t i = 0; i < repeats; i++) {
+    buffer.insert(buffer.end(), line.begin(), line.end());
+  }
+
+  return buffer;
+}
+
+/// Lexes `source` and runs it through parse_deep_ident_ until EOF.
+/// Returns the number of allocations made after the buffer exists.
+static auto count_allocations(std::vector<char8_t>&& source) -> size_t {
+  EntityTable table(_nstr("AllocTable"));
+  ErrorCollector errors;
+
+  const size_t before = allocations.load();
+  auto lexer = Lexer::create_shared(std::move(source)).value();
+  ParseContext ctx(1, errs(), errors, *lexer, table);
+
+  size_t idents = 0;        /// No REQUIRE in here, Catch2
+  bool all_ok   = true;     /// allocates on its own.
+  while(ctx.lxr.current() != TokenType::EndOfFile) {
+    const auto tok = ctx.lxr.current();
+    all_ok &= tok.view(*lexer) == u8"foo";
+    all_ok &= rl::detail_::parse_deep_ident_(ctx).has_value();
+    ++idents;
+  }
+
+  const size_t count = allocations.load() - before;
+  REQUIRE(all_ok);
+  REQUIRE(idents > 0);
+  return count;
+}
+
+TEST_CASE("IdentifierAllocations", "[Frontend.Parser]") {
+  SECTION("ConstantInTokenCount") {
+    const size_t small = count_allocations(make_source(64));
+    const size_t large = count_allocations(make_source(64 * 256));
+
+    /// The token and side-table vectors grow geometrically, so
+    /// a few more reallocations are fine. One per token is not.
+    REQUIRE(large - small < 64);
+  }
+}
+
+/// Parses one procedure with `statements` returns in its body.
+/// Returns the number of allocations made after the buffer exists.
+static auto count_node_allocations(const size_t statements) -> size_t {
+  std::u8string text = u8"proc main() -> {\n";
+  for(size_t i = 0; i < statements; i++) text += u8"return x + 1;\n";
+  text += u8"}\n";
+
+  EntityTable table(_nstr("AllocTable"));
+  ErrorCollector errors;
+
+  const size_t before = allocations.load();
+  auto lexer = Lexer::create_shared(std::vector<char8_t>(text.begin(), text.end())).value();
+  ParseContext ctx(1, errs(), errors, *lexer, table);
+
+  const bool parsed  = parse(ctx);
+  const size_t count = allocations.load() - before;
+  const size_t nodes = ctx.arena.usage(uint16_t(AstNode::Type::Return)).count;
+
+  REQUIRE(parsed);
+  REQUIRE(ctx.toplevel_decls_.size() == 1);
+  REQUIRE(nodes == statements);
+  return count;
+}
+
+TEST_CASE("NodeAllocations", "[Frontend.Parser]") {
+  SECTION("ConstantInNodeCount") {
+    const size_t small = count_node_allocations(16);
+    const size_t large = count_node_allocations(16 * 256);
+
+    /// Nodes and child lists come out of the arena's blocks.
+    REQUIRE(large - small < 64);
+  }
+}
+
+/// Writes an expression out as an s-expression, e.g. "(+ a 1)".
+static auto shape_of(const AstNode* node) -> std::string {
+  switch(node->type_) {
+  case AstNode::Type::BinExpr: {
+    const auto* bin = static_cast<const AstBinExpr*>(node);
+    return "(" + bin->op_type_.string_repr() + " " + shape_of(bin->left_) + " " + shape_of(bin->right_) + ")";
+  }
+  case AstNode::Type::UnaryExpr: {
+    const auto* un = static_cast<const AstUnaryExpr*>(node);
+    return "(" + un->op_type_.string_repr() + (un->is_postfix_ ? "post " : " ") + shape_of(un->operand_) + ")";
+  }
+  case AstNode::Type::Call: {
+    const auto* call = static_cast<const AstCall*>(node);
+    std::string out = "(call " + shape_of(call->target_);
+    for(const auto* arg : call->arguments_) out += " " + shape_of(arg);
+    return out + ")";
+  }
+  case AstNode::Type::EntityRefThunk:
+    return std::string(static_cast<const AstEntityRefThunk*>(node)->name_);
+  case AstNode::Type::ScalarLiteral:
+    return std::to_string(static_cast<const AstScalarLiteral*>(node)->int_value_);
+  default:
+    return "?";
+  }
+}
+
+TEST_CASE("ExpressionShapes", "[Frontend.Parser]") {
+  constexpr std::u8string_view source =
+    u8"proc f() -> {\n"
+    u8"  return a + b * c;\n"
+    u8"  return a - b - c;\n"
+    u8"  return x = y += !z++ :: w;\n"
+    u8"  return f(a)(b, 2) + 1;\n"
+    u8"  return (a + b) << c == d;\n"
+    u8"}\n";
+
+  EntityTable table(_nstr("ShapeTable"));
+  ErrorCollector errors;
+  auto lexer = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+  ParseContext ctx(1, errs(), errors, *lexer, table);
+  REQUIRE(parse(ctx));
+  REQUIRE(ctx.toplevel_decls_.size() == 1);
+
+  std::vector<std::string> shapes;
+  for(const auto* stmt : static_cast<const AstProcDecl*>(ctx.toplevel_decls_[0])->body_) {
+    REQUIRE(stmt->type_ == AstNode::Type::Return);
+    shapes.push_back(shape_of(static_cast<const AstReturn*>(stmt)->value_));
+  }
+
+  /// Grouping is the same as before binding powers were
+  /// table driven: equal levels group to the right.
+  const std::vector<std::string> expected{
+    "(* (+ a b) c)",
+    "(- a (- b c))",
+    "(= x (+= y (:: (! (++post z)) w)))",
+    "(+ (call (call f a) b 2) 1)",
+    "(<< (+ a b) (== c d))",
+  };
+
+  REQUIRE(shapes == expected);
+}
+
+TEST_CASE("UnknownInfixOperator", "[Frontend.Parser]") {
+  /// "as" is lexed as a BinaryOp but has no binding power yet.
+  constexpr std::u8string_view source = u8"proc f() -> { return a as b; }\n";
+
+  EntityTable table(_nstr("InfixTable"));
+  ErrorCollector errors;
+  NullOStream sink;
+  auto lexer = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+  ParseContext ctx(1, sink, errors, *lexer, table);
+  REQUIRE_FALSE(parse(ctx));
+}
+
+TEST_CASE("SkimmedBodies", "[Frontend.Parser]") {
+  constexpr std::u8string_view source =
+    u8"proc f() -> { return a + b * c; }\n"
+    u8"proc g() -> {\n"
+    u8"  scope { return x; }\n"
+    u8"  return y - z;\n"
+    u8"}\n"
+    u8"proc h() -> { return a as b; }\n";
+
+  EntityTable table(_nstr("SkimTable"));
+  ErrorCollector errors;
+  StringOStream sink;
+  auto lexer = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+  ParseContext ctx(1, sink, errors, *lexer, table);
+  ctx.skim_bodies = true;
+
+  /// h's body doesn't parse, but nothing looks at it yet.
+  REQUIRE(parse(ctx));
+  REQUIRE(ctx.toplevel_decls_.size() == 3);
+  REQUIRE(ctx.pending_bodies_.size() == 3);
+
+  auto* f = static_cast<AstProcDecl*>(ctx.toplevel_decls_[0]);
+  auto* g = static_cast<AstProcDecl*>(ctx.toplevel_decls_[1]);
+  auto* h = static_cast<AstProcDecl*>(ctx.toplevel_decls_[2]);
+  for(const auto* proc : { f, g, h }) {
+    REQUIRE(proc->body_pending_);
+    REQUIRE(proc->body_.empty());
+  }
+
+  SECTION("OnFirstAccess") {
+    REQUIRE(g->ensure_body(ctx).has_value());
+    REQUIRE_FALSE(g->body_pending_);
+    REQUIRE(g->body_.size() == 2);
+    REQUIRE(g->body_[0]->type_ == AstNode::Type::ScopeBlock);
+    REQUIRE(shape_of(static_cast<const AstReturn*>(g->body_[1])->value_) == "(- y z)");
+
+    /// Parsing a body leaves the lexer where it was.
+    REQUIRE(ctx.lxr.current() == TokenType::EndOfFile);
+    REQUIRE(ctx.curr_namespace == RL_ROOT_ENTITY_ID);
+
+    REQUIRE(g->ensure_body(ctx).has_value());
+    REQUIRE(g->body_.size() == 2);
+    REQUIRE(sink.str().empty());
+
+    /// The error is shown, not just counted.
+    REQUIRE_FALSE(h->ensure_body(ctx).has_value());
+    REQUIRE(errors.error_count() == 1);
+    REQUIRE(sink.str().find("<buffer>:6") != std::string::npos);
+  }
+
+  SECTION("AllPending") {
+    REQUIRE_FALSE(parse_pending_bodies(ctx));
+    REQUIRE(ctx.pending_bodies_.empty());
+    REQUIRE(ctx.lxr.current() == TokenType::EndOfFile);
+    REQUIRE(f->body_.size() == 1);
+    REQUIRE(shape_of(static_cast<const AstReturn*>(f->body_[0])->value_) == "(* (+ a b) c)");
+    REQUIRE(g->body_.size() == 2);
+  }
+}
+
+///
+/// How many diagnostics `text` holds, one per "In <buffer>:" header.
+static auto count_diagnostics(const std::string& text) -> size_t {
+  size_t count = 0;
+  for(size_t at = text.find("In <buffer>:"); at != std::string::npos; at = text.find("In <buffer>:", at + 1)) {
+    ++count;
+  }
+
+  return count;
+}
+
+TEST_CASE("ErrorRecovery", "[Frontend.Parser]") {
+  EntityTable table(_nstr("RecoveryTable"));
+  ErrorCollector errors;
+  StringOStream out;
+
+  SECTION("EveryIndependentError") {
+    constexpr std::u8string_view source =
+      u8"proc f() -> { return a as b; return c; }\n"
+      u8"proc 5() -> { return d; }\n"
+      u8"proc h() -> {\n"
+      u8"  scope { return e as f; }\n"
+      u8"  return g;\n"
+      u8"}\n"
+      u8"namespace ns { return x; }\n"
+      u8"proc k() -> { return y; }\n";
+
+    auto lexer = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+    ParseContext ctx(1, out, errors, *lexer, table);
+    REQUIRE_FALSE(parse(ctx));
+    REQUIRE(errors.error_count() == 4);
+    REQUIRE(count_diagnostics(out.str()) == 4);
+
+    /// One diagnostic per bad line, in source order.
+    const auto l1 = out.str().find("In <buffer>:1:");
+    const auto l2 = out.str().find("In <buffer>:2:");
+    const auto l4 = out.str().find("In <buffer>:4:");
+    const auto l7 = out.str().find("In <buffer>:7:");
+    REQUIRE(l1 < l2);
+    REQUIRE(l2 < l4);
+    REQUIRE(l4 < l7);
+    REQUIRE(l7 != std::string::npos);
+
+    /// Everything that did parse is kept, good
+    /// statements around a bad one included.
+    REQUIRE(ctx.toplevel_decls_.size() == 4);
+    const auto* f = static_cast<const AstProcDecl*>(ctx.toplevel_decls_[0]);
+    const auto* h = static_cast<const AstProcDecl*>(ctx.toplevel_decls_[1]);
+    REQUIRE(f->body_.size() == 1);
+    REQUIRE(h->body_.size() == 2);
+    REQUIRE(ctx.toplevel_decls_[2]->type_ == AstNode::Type::Namespace);
+    REQUIRE(ctx.toplevel_decls_[3]->type_ == AstNode::Type::ProcDecl);
+    REQUIRE(ctx.curr_namespace == RL_ROOT_ENTITY_ID);
+  }
+
+  SECTION("UnexpectedEndOfFile") {
+    constexpr std::u8string_view source = u8"proc f() -> { return a";
+    auto lexer = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+    ParseContext ctx(1, out, errors, *lexer, table);
+    REQUIRE_FALSE(parse(ctx));
+    REQUIRE(errors.error_count() == 1);
+    REQUIRE(count_diagnostics(out.str()) == 1);
+  }
+
+  SECTION("ErrorLimit") {
+    std::string source;
+    for(int i = 0; i < N19_MAX_ERRORS * 2; i++) {
+      source += "proc f" + std::to_string(i) + "() -> { return a as b; }\n";
+    }
+
+    auto lexer = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+    ParseContext ctx(1, out, errors, *lexer, table);
+    REQUIRE_FALSE(parse(ctx));
+    REQUIRE(errors.error_count() == N19_MAX_ERRORS);
+    REQUIRE(count_diagnostics(out.str()) == N19_MAX_ERRORS);
+    REQUIRE(out.str().find("too many errors") != std::string::npos);
+  }
+}
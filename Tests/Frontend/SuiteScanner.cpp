@@ -0,0 +1,215 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Lexer/Scanner.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <vector>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cctype>
+using namespace rl;
+using namespace std::literals;
+
+///
+/// Restores the scanner's SIMD level when a test exits,
+/// so a failed REQUIRE can't leak a forced level into other suites.
+struct LevelGuard {
+  LevelGuard() : saved_(ByteScanner::level()) {}
+  ~LevelGuard() { ByteScanner::set_level(saved_); }
+  SimdLevel saved_;
+};
+
+static auto make_buffer(const size_t size, const std::u8string_view alphabet, const uint32_t seed)
+  -> std::vector<char8_t>
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  std::vector<char8_t> buf(size);
+  for(auto& ch : buf) ch = alphabet[ pick(rng) ];
+  return buf;
+}
+
+static auto all_levels() -> std::vector<SimdLevel> {
+  std::vector<SimdLevel> levels;
+  for(uint8_t i = 0; i <= static_cast<uint8_t>(ByteScanner::max_level()); i++) {
+    levels.push_back(static_cast<SimdLevel>(i));
+  }
+
+  return levels;
+}
+
+TEST_CASE("ByteClassTable", "[Frontend.Scanner]") {
+  SECTION("MatchesReservedBytes") {
+    for(size_t ch = 0; ch < 256; ch++) {
+      const bool reserved = ByteClass::table[ch] & ByteClass::Reserved;
+      REQUIRE(reserved == Lexer::is_reserved_byte(static_cast<char8_t>(ch)));
+    }
+  }
+
+  SECTION("DelimitersEndIdentifiers") {
+    for(size_t ch = 0; ch < 0x80; ch++) {
+      const bool expected = std::isspace(int(ch)) || std::iscntrl(int(ch))
+        || Lexer::is_reserved_byte(static_cast<char8_t>(ch));
+      REQUIRE(bool(ByteClass::table[ch] & ByteClass::Delimiter) == expected);
+    }
+
+    for(size_t ch = 0x80; ch < 256; ch++) {
+      REQUIRE((ByteClass::table[ch] & ByteClass::Delimiter) == 0);
+    }
+  }
+}
+
+TEST_CASE("ByteScannerLevels", "[Frontend.Scanner]") {
+  LevelGuard guard;
+  constexpr std::u8string_view alphabet = u8"abcXYZ019_ \t\n\r;(.#\x80\xC3\0"sv;
+
+  for(uint32_t seed = 0; seed < 64; seed++) {
+    const auto buf = make_buffer(seed * 7 + 1, alphabet, seed);
+    const char8_t* begin = buf.data();
+    const char8_t* end   = buf.data() + buf.size();
+
+    for(size_t off = 0; off < buf.size(); off += 3) {
+      ByteScanner::set_level(SimdLevel::Scalar);
+      const auto* delim = ByteScanner::find_delimiter(begin + off, end);
+      const auto* eol   = ByteScanner::find_line_end(begin + off, end);
+      uint32_t lines    = 0;
+      const auto* ws    = ByteScanner::skip_space(begin + off, end, lines);
+
+      for(const SimdLevel level : all_levels()) {
+        ByteScanner::set_level(level);
+        uint32_t lines_simd = 0;
+        REQUIRE(ByteScanner::find_delimiter(begin + off, end) == delim);
+        REQUIRE(ByteScanner::find_line_end(begin + off, end) == eol);
+        REQUIRE(ByteScanner::skip_space(begin + off, end, lines_simd) == ws);
+        REQUIRE(lines_simd == lines);
+      }
+    }
+  }
+}
+
+TEST_CASE("ByteScannerLongRuns", "[Frontend.Scanner]") {
+  LevelGuard guard;
+
+  SECTION("Whitespace") {
+    std::vector<char8_t> buf;
+    for(size_t i = 0; i < 100; i++) {
+      buf.push_back(u8' ');
+      buf.push_back(u8'\n');
+      buf.push_back(u8'\t');
+    }
+
+    buf.push_back(u8'x');
+    for(const SimdLevel level : all_levels()) {
+      ByteScanner::set_level(level);
+      uint32_t lines = 0;
+      const auto* stop = ByteScanner::skip_space(buf.data(), buf.data() + buf.size(), lines);
+      REQUIRE(stop == buf.data() + 300);
+      REQUIRE(lines == 100);
+    }
+  }
+
+  SECTION("Identifier") {
+    std::vector<char8_t> buf(100, u8'a');
+    buf.push_back(u8'(');
+    for(const SimdLevel level : all_levels()) {
+      ByteScanner::set_level(level);
+      const auto* stop = ByteScanner::find_delimiter(buf.data(), buf.data() + buf.size());
+      REQUIRE(stop == buf.data() + 100);
+    }
+  }
+
+  SECTION("EmptyRange") {
+    const char8_t ch = u8'a';
+    for(const SimdLevel level : all_levels()) {
+      ByteScanner::set_level(level);
+      uint32_t lines = 0;
+      REQUIRE(ByteScanner::find_delimiter(&ch, &ch) == &ch);
+      REQUIRE(ByteScanner::find_line_end(&ch, &ch) == &ch);
+      REQUIRE(ByteScanner::skip_space(&ch, &ch, lines) == &ch);
+      REQUIRE(lines == 0);
+    }
+  }
+}
+
+TEST_CASE("LexerLineNumbers", "[Frontend.Scanner]") {
+  LevelGuard guard;
+  std::u8string source;
+  for(size_t i = 0; i < 40; i++) {
+    source += u8"ident  \t\r\n   \n# a comment that runs on\n";
+  }
+
+  for(const SimdLevel level : all_levels()) {
+    ByteScanner::set_level(level);
+    auto lxr = Lexer::create_shared(std::vector<char8_t>(source.begin(), source.end())).value();
+
+    for(uint32_t i = 0; i < 40; i++) {
+      REQUIRE(lxr->current().type_ == TokenType::Identifier);
+      REQUIRE(lxr->line_of(lxr->current()) == 1 + i * 3);
+      lxr->consume(1);
+    }
+
+    REQUIRE(lxr->current().type_ == TokenType::EndOfFile);
+  }
+}
+
+TEST_CASE("Utf8Validation", "[Frontend.Scanner]") {
+  LevelGuard guard;
+  auto first_invalid = [](const std::u8string_view str) -> size_t {
+    return static_cast<size_t>(ByteScanner::find_invalid_utf8(str.data(), str.data() + str.size()) - str.data());
+  };
+
+  SECTION("KnownSequences") {
+    const std::u8string pad(40, u8'a');   /// Lands the sequence past the first block.
+    const std::pair<std::u8string_view, bool> cases[] = {
+      { u8"é"sv,                true  },
+      { u8"世界"sv,             true  },
+      { u8"\U0001F600"sv,       true  },
+      { u8"\U0010FFFF"sv,       true  },
+      { u8"\xC3"sv,             false },   /// Cut off.
+      { u8"\x80"sv,             false },   /// Stray continuation.
+      { u8"\xC0\xAF"sv,         false },   /// Overlong.
+      { u8"\xE0\x80\xAF"sv,     false },
+      { u8"\xF0\x80\x80\xAF"sv, false },
+      { u8"\xED\xA0\x80"sv,     false },   /// Surrogate.
+      { u8"\xF4\x90\x80\x80"sv, false },   /// Past U+10FFFF.
+      { u8"\xFF"sv,             false },
+    };
+
+    for(const SimdLevel level : all_levels()) {
+      ByteScanner::set_level(level);
+      for(const auto& [seq, valid] : cases) {
+        const std::u8string str = pad + std::u8string(seq) + pad;
+        REQUIRE(first_invalid(str) == (valid ? str.size() : pad.size()));
+      }
+    }
+  }
+
+  SECTION("MatchesScalar") {
+    const std::u8string_view pieces[] = {
+      u8"a"sv, u8"\n"sv, u8"é"sv, u8"世"sv, u8"\U0001F600"sv,
+      u8"\xC3"sv, u8"\x80"sv, u8"\xED\xA0\x80"sv, u8"\xC0\xAF"sv, u8"\xF8"sv,
+    };
+
+    std::mt19937 rng(99);
+    for(size_t round = 0; round < 2000; round++) {
+      /// Mostly valid, so the first error can be anywhere.
+      const bool broken = rng() % 4 == 0;
+      std::u8string str;
+      const size_t count = rng() % 80;
+      for(size_t i = 0; i < count; i++) str += pieces[rng() % (broken ? 10 : 5)];
+      if(rng() % 3 == 0 && !str.empty()) str.resize(rng() % str.size());
+
+      ByteScanner::set_level(SimdLevel::Scalar);
+      const size_t expected = first_invalid(str);
+      for(const SimdLevel level : all_levels()) {
+        ByteScanner::set_level(level);
+        REQUIRE(first_invalid(str) == expected);
+      }
+    }
+  }
+}
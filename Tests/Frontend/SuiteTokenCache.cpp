@@ -0,0 +1,93 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Lexer/TokenCache.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <Tests/Frontend/TokenStreams.hpp>
+#include <Tests/TempFiles.hpp>
+#include <filesystem>
+#include <string>
+using namespace rl;
+
+TEST_CASE("TokenCache", "[Frontend.TokenCache]") {
+  const auto root = std::filesystem::temp_directory_path() / "n19_suite_token_cache";
+  const auto path = std::filesystem::temp_directory_path() / "n19_suite_token_cache.rl";
+  std::filesystem::remove_all(root);
+
+  std::string source;
+  for(int i = 0; i < 200; i++) {
+    source += "let name" + std::to_string(i % 13) + " = 0x" + std::to_string(i) + " + \"s\";\n";
+  }
+
+  SECTION("MissThenHit") {
+    auto file  = create_file(path, source);
+    auto cache = TokenCache::open(root.native()).release_value();
+
+    auto first = cache.lex(file).value();
+    REQUIRE(cache.stats().misses == 1);
+    REQUIRE(cache.stats().hits == 0);
+
+    auto second = cache.lex(file).value();
+    REQUIRE(cache.stats().misses == 1);
+    REQUIRE(cache.stats().hits == 1);
+
+    auto fresh = Lexer::create_shared(file).value();
+    require_same_stream(*second, *fresh);
+    file.close();
+  }
+
+  SECTION("ReusesMapping") {
+    auto file  = create_file(path, source);
+    auto cache = TokenCache::open(root.native()).release_value();
+
+    auto first = cache.lex(file, sys::MappedFile::map(file, Lexer::padding).release_value()).value();
+    auto second = cache.lex(file, sys::MappedFile::map(file, Lexer::padding).release_value()).value();
+    REQUIRE(cache.stats().misses == 1);
+    REQUIRE(cache.stats().hits == 1);
+
+    auto fresh = Lexer::create_shared(file, sys::MappedFile::map(file, Lexer::padding).release_value()).value();
+    require_same_stream(*fresh, *first);
+    require_same_stream(*fresh, *second);
+    file.close();
+  }
+
+  SECTION("ChangedSourceMisses") {
+    auto file  = create_file(path, source);
+    auto cache = TokenCache::open(root.native()).release_value();
+    (void)cache.lex(file).value();
+    file.close();
+
+    file = create_file(path, source + "extra;\n");
+    (void)cache.lex(file).value();
+    REQUIRE(cache.stats().misses == 2);
+    REQUIRE(cache.stats().hits == 0);
+    file.close();
+  }
+
+  SECTION("CorruptEntryMisses") {
+    auto file  = create_file(path, source);
+    auto cache = TokenCache::open(root.native()).release_value();
+    (void)cache.lex(file).value();
+
+    /// Truncate the one entry there is.
+    for(const auto& entry : std::filesystem::directory_iterator(root)) {
+      std::filesystem::resize_file(entry.path(), 40);
+    }
+
+    auto lxr = cache.lex(file).value();
+    REQUIRE(cache.stats().misses == 2);
+    auto fresh = Lexer::create_shared(file).value();
+    require_same_stream(*lxr, *fresh);
+
+    /// The miss rewrote it.
+    (void)cache.lex(file).value();
+    REQUIRE(cache.stats().hits == 1);
+    file.close();
+  }
+
+  std::filesystem::remove_all(root);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,45 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <n19/Frontend/Lexer/Token.hpp>
+
+///
+/// Requires `actual` to hold the same token stream as `expected`:
+/// same tokens, lines, decoded literals and interned spellings.
+/// Walks both from their current token, then puts `actual`'s
+/// cursor back where it started.
+inline auto require_same_stream(rl::Lexer& actual, rl::Lexer& expected) -> void {
+  using namespace rl;
+  const Token head = actual.current();
+  REQUIRE(actual.line_count() == expected.line_count());
+  REQUIRE(actual.literal_count() == expected.literal_count());
+  REQUIRE(actual.interned_count() == expected.interned_count());
+
+  while(true) {
+    const Token a = actual.current();
+    const Token b = expected.current();
+    REQUIRE(a.type_ == b.type_);
+    REQUIRE(a.pos_  == b.pos_);
+    REQUIRE(a.len_  == b.len_);
+    REQUIRE(actual.line_of(a) == expected.line_of(b));
+    REQUIRE(actual.literal(a).has_value() == expected.literal(b).has_value());
+    if(expected.literal(b)) REQUIRE(actual.literal(a)->integer == expected.literal(b)->integer);
+    REQUIRE(actual.interned(a).has_value() == expected.interned(b).has_value());
+    if(expected.interned(b)) {
+      REQUIRE(actual.strings().get_string(actual.interned(a)->index)
+        == expected.strings().get_string(expected.interned(b)->index));
+    }
+
+    if(a == TokenType::EndOfFile) break;
+    actual.consume(1);
+    expected.consume(1);
+  }
+
+  actual.revert_before(head);
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/System/MappedFile.hpp>
+#include <n19/System/PageAllocator.hpp>
+#include <n19/System/File.hpp>
+#include <Tests/TempFiles.hpp>
+#include <filesystem>
+#include <string>
+using namespace n19;
+using namespace n19::sys;
+
+static auto write_temp_file(const std::string& contents) -> File {
+  return create_file(std::filesystem::temp_directory_path() / "n19_suite_mapped_file.tmp", contents);
+}
+
+TEST_CASE("MapContents", "[System.MappedFile]") {
+  const std::string contents = "proc main() -> {}\n";
+  auto file = write_temp_file(contents);
+  auto mf = MappedFile::map(file, 16);
+  REQUIRE(mf.has_value());
+  REQUIRE(mf->size() == contents.size());
+
+  const auto chars = mf->chars();
+  REQUIRE(std::string(chars.begin(), chars.end()) == contents);
+  for(size_t i = 0; i < 16; i++) {
+    REQUIRE(chars.data()[ chars.size() + i ] == u8'\0');
+  }
+
+  file.close();
+}
+
+TEST_CASE("MapPaddingOnPageBoundary", "[System.MappedFile]") {
+  const size_t page = PageAllocator::page_size();
+  const std::string contents(page, 'x');
+  auto file = write_temp_file(contents);
+
+  /// The file fills its last page exactly, so the padding
+  /// has to come from memory placed directly after it.
+  auto mf = MappedFile::map(file, 64);
+  REQUIRE(mf.has_value());
+  REQUIRE(mf->size() == page);
+  REQUIRE(mf->chars().back() == u8'x');
+  for(size_t i = 0; i < 64; i++) {
+    REQUIRE(mf->chars().data()[ page + i ] == u8'\0');
+  }
+
+  file.close();
+}
+
+TEST_CASE("MapLifetime", "[System.MappedFile]") {
+  SECTION("EmptyFile") {
+    auto file = write_temp_file("");
+    REQUIRE(!MappedFile::map(file).has_value());
+    file.close();
+  }
+
+  SECTION("Move") {
+    auto file = write_temp_file("abc");
+    auto first = MappedFile::map(file).release_value();
+    const void* data = first.data();
+
+    MappedFile second = std::move(first);
+    REQUIRE(first.empty());
+    REQUIRE(first.data() == nullptr);
+    REQUIRE(second.data() == data);
+    REQUIRE(second.size() == 3);
+
+    second.close();
+    REQUIRE(second.empty());
+    file.close();
+  }
+}
@@ -0,0 +1,31 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <n19/System/File.hpp>
+#include <n19/Core/Bytes.hpp>
+#include <filesystem>
+#include <string>
+
+///
+/// Creates or truncates the file at `path` and writes `contents`
+/// into it. The file is handed back still open, at its end.
+inline auto create_file(const std::filesystem::path& path, const std::string& contents) -> n19::sys::File {
+  auto file = n19::sys::File::create_trunc(path.native()).value();
+  if(!contents.empty()) {
+    REQUIRE(file.write(n19::as_bytes(contents)).has_value());
+  }
+
+  return file;
+}
+
+///
+/// Same, for files that are only opened again by path.
+inline auto write_file(const std::filesystem::path& path, const std::string& contents) -> void {
+  auto file = create_file(path, contents);
+  file.close();
+}
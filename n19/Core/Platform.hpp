@@ -45,6 +45,15 @@
 #define N19_POSIX
 #  endif
 
+// =========================================
+// Architecture
+// =========================================
+#  if defined(__x86_64__) || defined(_M_X64)
+#define N19_X86_64
+#  elif defined(__aarch64__)
+#define N19_ARM64
+#  endif
+
 // =========================================
 // Cache line size guess
 // =========================================
@@ -81,3 +90,4 @@
 #define FORCEINLINE_  __attribute__((always_inline)) inline
 #define NOINLINE_     __attribute__((noinline))
 #define WEAK_         __attribute__((weak))
+#define TARGET_(ISA)  __attribute__((target(ISA)))
@@ -12,6 +12,7 @@
 #include <n19/System/IODevice.hpp>
 #include <n19/Core/Bytes.hpp>
 #include <n19/Core/Concepts.hpp>
+#include <string>
 #include <string_view>
 #include <cstdint>
 #include <cstring>
@@ -286,6 +287,27 @@ public:
   NullOStream() = default;
 };
 
+///
+/// Keeps everything written to it in memory. Used to hold the
+/// output of work done on another thread until it can be
+/// printed, and by tests. Flushing does nothing.
+class StringOStream final : public OStream {
+public:
+  auto write(const Span_& buff) -> OStream& override {
+    str_.append(reinterpret_cast<const char*>(buff.data()), buff.size());
+    return *this;
+  }
+
+  auto flush() -> OStream& override { return *this; }
+  NODISCARD_ auto str() const -> const std::string& { return str_; }
+  auto clear() -> void { str_.clear(); }
+
+ ~StringOStream() override = default;
+  StringOStream() = default;
+private:
+  std::string str_;
+};
+
 class IStream {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(IStream);
   N19_MAKE_DEFAULT_ASSIGNABLE(IStream);
@@ -114,12 +114,22 @@ auto StringPool::try_get_index(const ViewType_ vt) -> Maybe<Index>
   return new_index;
 }
 
+auto StringPool::hash_of(const ViewType_ vt) const -> HashType_
+{
+  return murmur3_x86_32(vt, hashseed_);
+}
+
 auto StringPool::get_index(ViewType_ vt) -> Index
+{
+  return get_index(vt, hash_of(vt));
+}
+
+/// For callers that already hashed the string with hash_of().
+auto StringPool::get_index(ViewType_ vt, const HashType_ hash) -> Index
 {
   ASSERT(!vt.empty(), "Empty strings are disallowed.");
   ASSERT(vt.size() + 1 <= this->block_size_, "String is too large.");
 
-  const HashType_ hash = murmur3_x86_32(vt, hashseed_);
   auto matches = indices_.equal_range(hash);
 
   /// The hash might already exist. Try and find the string.
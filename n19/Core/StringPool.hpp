@@ -41,6 +41,8 @@ public:
 
   NODISCARD_ ViewType_ get_string(Index index);
   NODISCARD_ Index get_index(ViewType_ vt);
+  NODISCARD_ Index get_index(ViewType_ vt, HashType_ hash);
+  NODISCARD_ HashType_ hash_of(ViewType_ vt) const;
   NODISCARD_ Index insert_new_string_impl_(ViewType_ vt);
 
   StringPool(size_t block_size, uint32_t seed);
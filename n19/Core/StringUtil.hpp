@@ -6,6 +6,7 @@
 #pragma once
 
 #include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
 #include <n19/Core/Maybe.hpp>
 #include <n19/Core/Result.hpp>
 #include <n19/System/String.hpp>
@@ -15,6 +16,11 @@ BEGIN_NAMESPACE(n19);
 auto unescape_string(std::string_view)        -> Result<std::string>;
 auto unescape_quoted_string(std::string_view) -> Result<std::string>;
 
+/// UTF-8 text as plain chars, for APIs that don't take char8_t.
+FORCEINLINE_ auto as_chars(const std::u8string_view str) -> std::string_view {
+  return { reinterpret_cast<const char*>(str.data()), str.size() };
+}
+
 /// For strings that begin and end with `.
 auto unescape_raw_string(std::string_view)    -> Result<std::string>;
 auto unescape_raw_quoted_string(std::string_view) -> Result<std::string>;
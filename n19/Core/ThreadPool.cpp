@@ -0,0 +1,75 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Core/ThreadPool.hpp>
+#include <n19/Core/Panic.hpp>
+#include <algorithm>
+#include <utility>
+BEGIN_NAMESPACE(n19);
+
+ThreadPool::ThreadPool(const size_t threads) {
+  const size_t count = std::max<size_t>(threads, 1);
+  workers_.reserve(count);
+  for(size_t i = 0; i < count; i++) {
+    workers_.emplace_back([this] { worker_loop_(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard guard(lock_);
+    stopping_ = true;
+  }
+
+  job_ready_.notify_all();
+  for(auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+auto ThreadPool::hardware_threads() -> size_t {
+  const unsigned count = std::thread::hardware_concurrency();
+  return count == 0 ? 1 : count;   /// 0 means "unknown".
+}
+
+auto ThreadPool::submit(Job job) -> void {
+  ASSERT(job != nullptr);
+  {
+    std::lock_guard guard(lock_);
+    ASSERT(!stopping_, "Job submitted to a pool that is shutting down.");
+    jobs_.emplace_back(std::move(job));
+  }
+
+  job_ready_.notify_one();
+}
+
+auto ThreadPool::wait() -> void {
+  std::unique_lock guard(lock_);
+  all_idle_.wait(guard, [this] { return jobs_.empty() && active_ == 0; });
+}
+
+auto ThreadPool::worker_loop_() -> void {
+  while(true) {
+    Job job;
+    {
+      std::unique_lock guard(lock_);
+      job_ready_.wait(guard, [this] { return stopping_ || !jobs_.empty(); });
+      if(jobs_.empty()) return;    /// Only reachable once stopping_ is set.
+
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      ++active_;
+    }
+
+    job();
+
+    std::lock_guard guard(lock_);
+    if(--active_ == 0 && jobs_.empty()) {
+      all_idle_.notify_all();
+    }
+  }
+}
+
+END_NAMESPACE(n19);
@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <cstddef>
+BEGIN_NAMESPACE(n19);
+
+/* n19::ThreadPool
+ *
+ * A fixed set of worker threads pulling jobs off a shared
+ * FIFO queue. Jobs are fire-and-forget; wait() blocks until
+ * the queue is drained and every worker is idle again.
+ *
+ * A pool of size 1 (or 0) runs jobs on a single worker, it
+ * never runs them on the calling thread.
+ */
+class ThreadPool {
+  N19_MAKE_NONCOPYABLE(ThreadPool);
+  N19_MAKE_NONMOVABLE(ThreadPool);
+public:
+  using Job = std::function<void()>;
+
+  auto submit(Job job) -> void;
+  auto wait() -> void;
+  auto size() const -> size_t { return workers_.size(); }
+
+  /// Runs fn(0) .. fn(count - 1) across the pool and returns once
+  /// all of them have finished. Only this call's work is waited
+  /// on, and the calling thread takes indices too, so it's safe
+  /// to call from one of the pool's own jobs.
+  template<typename F>
+  auto parallel_for(size_t count, F&& fn) -> void;
+
+  static auto hardware_threads() -> size_t;
+
+  explicit ThreadPool(size_t threads = hardware_threads());
+  ~ThreadPool();
+private:
+  auto worker_loop_() -> void;
+
+  std::vector<std::thread> workers_;
+  std::deque<Job> jobs_;
+  std::mutex lock_;
+  std::condition_variable job_ready_;   /// Signalled on submit() and shutdown.
+  std::condition_variable all_idle_;    /// Signalled when the pool runs dry.
+  size_t active_ = 0;                   /// Jobs currently executing.
+  bool stopping_ = false;
+};
+
+template<typename F>
+auto ThreadPool::parallel_for(const size_t count, F&& fn) -> void {
+  if(count == 0) return;
+
+  /// Shared with the helper jobs, which can start after this call
+  /// returns. A helper that finds every index taken never touches fn.
+  struct Batch {
+    std::atomic<size_t> next{ 0 };
+    size_t count = 0;
+    size_t done  = 0;
+    std::mutex lock;
+    std::condition_variable finished;
+    std::remove_reference_t<F>* fn = nullptr;
+  };
+
+  auto batch   = std::make_shared<Batch>();
+  batch->count = count;
+  batch->fn    = &fn;
+
+  const auto drain = [](Batch& b) {
+    size_t ran = 0;
+    for(size_t i = b.next++; i < b.count; i = b.next++) {
+      (*b.fn)(i);
+      ++ran;
+    }
+
+    if(ran == 0) return;
+    std::lock_guard guard(b.lock);
+    b.done += ran;
+    if(b.done == b.count) b.finished.notify_all();
+  };
+
+  const size_t helpers = std::min(count, size()) - 1;
+  for(size_t i = 0; i < helpers; i++) {
+    submit([batch, drain] { drain(*batch); });
+  }
+
+  /// Every index is either run here or already running on a
+  /// helper, so this never waits on a job stuck in the queue.
+  drain(*batch);
+  std::unique_lock guard(batch->lock);
+  batch->finished.wait(guard, [&] { return batch->done == batch->count; });
+}
+
+END_NAMESPACE(n19);
@@ -0,0 +1,60 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Core/TokenDump.hpp>
+#include <n19/Core/Panic.hpp>
+#include <cstring>
+BEGIN_NAMESPACE(n19);
+
+constexpr char token_dump_magic_[8] = { 'n', '1', '9', 't', 'o', 'k', 'd', '\0' };
+
+auto TokenDumpHeader::make() -> TokenDumpHeader {
+  TokenDumpHeader header{};
+  std::memcpy(header.magic, token_dump_magic_, sizeof(header.magic));
+  header.version     = current_version;
+  header.byte_order  = native_order;
+  header.record_size = sizeof(TokenRecord);
+  return header;
+}
+
+auto TokenDumpReader::create(const Bytes data) -> Result<TokenDumpReader> {
+  TokenDumpHeader header{};
+  if(data.size() < sizeof(header)) {
+    return Error(ErrC::InvalidArg, "Token dump is too small to hold a header.");
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  if(std::memcmp(header.magic, token_dump_magic_, sizeof(header.magic)) != 0) {
+    return Error(ErrC::InvalidArg, "Not a token dump.");
+  }
+  if(header.byte_order != TokenDumpHeader::native_order) {
+    return Error(ErrC::InvalidArg, "Token dump was written with the other byte order.");
+  }
+  if(header.version != TokenDumpHeader::current_version || header.record_size != sizeof(TokenRecord)) {
+    return Error(ErrC::InvalidArg, "Unsupported token dump version.");
+  }
+
+  const Bytes records = data.subspan(sizeof(header));
+  if(records.size() % sizeof(TokenRecord) != 0) {
+    return Error(ErrC::InvalidArg, "Token dump ends in the middle of a record.");
+  }
+
+  TokenDumpReader reader;
+  reader.records_ = records;
+  return reader;
+}
+
+auto TokenDumpReader::size() const -> size_t {
+  return records_.size() / sizeof(TokenRecord);
+}
+
+auto TokenDumpReader::at(const size_t index) const -> TokenRecord {
+  ASSERT(index < size(), "TokenDumpReader::at(): index out of range.");
+  TokenRecord rec{};
+  std::memcpy(&rec, records_.data() + index * sizeof(TokenRecord), sizeof(rec));
+  return rec;
+}
+
+END_NAMESPACE(n19);
@@ -0,0 +1,63 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Bytes.hpp>
+#include <n19/Core/Result.hpp>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+BEGIN_NAMESPACE(n19);
+
+///
+/// The format written by `rl --dump-tokens=bin`, for tools that
+/// want the token stream without parsing the text dump. A dump is
+/// one TokenDumpHeader followed by one TokenRecord per token, the
+/// last of which is either end of file or an illegal token.
+/// Everything is in the writer's byte order; a reader on a machine
+/// with the other one sees a swapped `byte_order` and rejects it.
+struct TokenDumpHeader {
+  constexpr static uint16_t current_version = 1;
+  constexpr static uint16_t native_order    = 0x0102;
+
+  char magic[8];
+  uint16_t version;
+  uint16_t byte_order;
+  uint32_t record_size;   /// sizeof(TokenRecord) when written.
+
+  static auto make() -> TokenDumpHeader;
+};
+
+struct TokenRecord {
+  uint64_t offset;        /// Byte offset into the source file.
+  uint64_t category;      /// TokenCategory mask.
+  uint32_t len;           /// Length in bytes.
+  uint32_t line;          /// 1-based.
+  uint16_t type;          /// TokenType value.
+  uint16_t unused_[3];
+};
+
+static_assert(sizeof(TokenDumpHeader) == 16);
+static_assert(sizeof(TokenRecord) == 32);
+static_assert(std::is_trivially_copyable_v<TokenRecord>);
+
+///
+/// Reads records back out of a dump, usually a mapped file.
+/// Nothing is copied up front, and records don't have to be
+/// aligned in `data`, so the bytes must outlive the reader.
+class TokenDumpReader {
+public:
+  static auto create(Bytes data) -> Result<TokenDumpReader>;
+  auto size() const -> size_t;
+  auto at(size_t index) const -> TokenRecord;
+
+  TokenDumpReader() = default;
+private:
+  Bytes records_;
+};
+
+END_NAMESPACE(n19);
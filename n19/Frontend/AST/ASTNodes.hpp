@@ -13,11 +13,12 @@
 #include <n19/Core/Console.hpp>
 #include <n19/Core/Concepts.hpp>
 #include <n19/Frontend/Lexer/Token.hpp>
+#include <n19/Frontend/Common/SourcePos.hpp>
 #include <n19/Frontend/Entities/Entity.hpp>
 #include <n19/Frontend/FrontendContext.hpp>
+#include <n19/Frontend/AST/AstArena.hpp>
 #include <n19/System/String.hpp>
 #include <vector>
-#include <memory>
 
 #define RL_ASTNODE_TYPE_LIST \
   ASTNODE_X(Node) \
@@ -54,6 +55,8 @@
 BEGIN_NAMESPACE(rl);
 using namespace n19;
 
+struct ParseContext;
+
 class AstNode {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(AstNode);
   N19_MAKE_DEFAULT_ASSIGNABLE(AstNode);
@@ -66,27 +69,26 @@ public:
 
   // Type aliases //
   //////////////////////////////////////////
+  /// Nodes live in the ParseContext's AstArena,
+  /// so neither of these own what they point to.
   template<typename T = AstNode>
-  using Ptr = std::unique_ptr<T>;
+  using Ptr = T*;
 
   template<typename T = AstNode>
-  using Children = std::vector<Ptr<T>>;
+  using Children = AstList<Ptr<T>>;
 
-  auto print_(
-    uint32_t depth,
-    OStream& stream,
-    const std::string& node_name
-  ) const -> void;
-
-  virtual auto print(
+  /// Dumps this node and everything below it. Implemented
+  /// in DumpAST.cpp on top of AstVisitor, so it isn't virtual.
+  auto print(
     uint32_t depth,
     OStream& stream,
     const Maybe<std::string> &alias
-  ) const -> void = 0;
+  ) const -> void;
 
   template<typename T>
   static auto create(
-    size_t pos,
+    AstArena& arena,
+    SourcePos pos,
     uint32_t line,
     AstNode* parent,
     InputFile::ID file
@@ -95,16 +97,23 @@ public:
   // Public fields //
   //////////////////////////////////////////
   AstNode* parent_ = nullptr;
-  size_t pos_      = 0;
+  SourcePos pos_   = 0;
   uint32_t line_   = 1;
   InputFile::ID file_ = RL_INVALID_INFILE_ID;
   Type type_;
   //////////////////////////////////////////
 
   AstNode() = default;
-  virtual ~AstNode() = default;
+protected:
+  /// Not virtual: the arena destroys nodes by their
+  /// concrete type, and only those that need it.
+  ~AstNode() = default;
 };
 
+#define ASTNODE_X(NAME) + 1
+static_assert(0 RL_ASTNODE_TYPE_LIST <= AstArena::max_kinds_);
+#undef ASTNODE_X
+
 class AstBinExpr final : public AstNode {
   N19_MAKE_DEFAULT_MOVE_CONSTRUCTIBLE(AstBinExpr);
   N19_MAKE_DEFAULT_MOVE_ASSIGNABLE(AstBinExpr);
@@ -114,12 +123,7 @@ public:
   AstNode::Ptr<> left_  = nullptr;
   AstNode::Ptr<> right_ = nullptr;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-  
-  ~AstBinExpr() override = default;
+  ~AstBinExpr() = default;
   AstBinExpr() = default;
 };
 
@@ -132,12 +136,7 @@ public:
   AstNode::Ptr<> operand_ = nullptr;
   bool is_postfix_        = false; // only relevant for '--' and '++'
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstUnaryExpr() override = default;
+  ~AstUnaryExpr() = default;
   AstUnaryExpr() = default;
 };
 
@@ -145,7 +144,12 @@ class AstScalarLiteral final : public AstNode {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(AstScalarLiteral);
   N19_MAKE_DEFAULT_ASSIGNABLE(AstScalarLiteral);
 public:
-  std::string value_;
+  std::string value_;          /// StringLit and U8Lit only.
+  union {
+    uint64_t int_value_ = 0;   /// IntLit, and BoolLit as 0 or 1.
+    double float_value_;       /// FloatLit.
+  };
+
   enum : uint8_t {
     None,
     NullLit,
@@ -156,12 +160,7 @@ public:
     BoolLit,
   } scalar_type_ = None;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstScalarLiteral() override = default;
+  ~AstScalarLiteral() = default;
   AstScalarLiteral() = default;
 };
 
@@ -171,12 +170,7 @@ class AstAggregateLiteral final : public AstNode {
 public:
   AstNode::Children<> children_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstAggregateLiteral() override = default;
+  ~AstAggregateLiteral() = default;
   AstAggregateLiteral() = default;
 };
 
@@ -186,12 +180,7 @@ class AstEntityRef final : public AstNode {
 public:
   Entity::ID id_= RL_INVALID_ENTITY_ID;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstEntityRef() override = default;
+  ~AstEntityRef() = default;
   AstEntityRef() = default;
 };
 
@@ -199,14 +188,10 @@ class AstEntityRefThunk final : public AstNode {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(AstEntityRefThunk);
   N19_MAKE_DEFAULT_ASSIGNABLE(AstEntityRefThunk);
 public:
-  std::string name_;
-
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
+  std::string_view name_;        /// Points into the lexer's StringPool.
+  StringPool::Index name_id_{};  /// name_ in the lexer's StringPool.
 
-  ~AstEntityRefThunk() override = default;
+  ~AstEntityRefThunk() = default;
   AstEntityRefThunk() = default;
 };
 
@@ -216,12 +201,7 @@ class AstQualifiedRef final : public AstNode {
 public:
   EntityQualifier descriptor_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstQualifiedRef() override = default;
+  ~AstQualifiedRef() = default;
   AstQualifiedRef() = default;
 };
 
@@ -232,12 +212,7 @@ public:
   AstNode::Children<> body_;
   AstNode::Ptr<> condition_ = nullptr;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstIf() override = default;
+  ~AstIf() = default;
   AstIf() = default;
 };
 
@@ -247,12 +222,7 @@ class AstElse final : public AstNode {
 public:
   AstNode::Children<> body_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstElse() override = default;
+  ~AstElse() = default;
   AstElse() = default;
 };
 
@@ -263,12 +233,7 @@ public:
   AstNode::Children<> body_;
   Entity::ID id_ = RL_INVALID_ENTITY_ID;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstNamespace() override = default;
+  ~AstNamespace() = default;
   AstNamespace() = default;
 };
 
@@ -279,12 +244,7 @@ public:
   AstNode::Children<> body_;
   AstNode::Ptr<> condition_ = nullptr;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstConstIf() override = default;
+  ~AstConstIf() = default;
   AstConstIf() = default;
 };
 
@@ -294,12 +254,7 @@ class AstConstElse final : public AstNode {
 public:
   AstNode::Children<> body_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstConstElse() override = default;
+  ~AstConstElse() = default;
   AstConstElse() = default;
 };
 
@@ -310,12 +265,7 @@ public:
   AstNode::Ptr<AstIf> if_     = nullptr; // If condition + block
   AstNode::Ptr<AstElse> else_ = nullptr; // Can be null!
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstBranch() override = default;
+  ~AstBranch() = default;
   AstBranch() = default;
 };
 
@@ -326,12 +276,7 @@ public:
   AstNode::Ptr<AstConstIf> if_ = nullptr;
   AstNode::Ptr<AstConstElse> else_ = nullptr; // Can be null!
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstConstBranch() override = default;
+  ~AstConstBranch() = default;
   AstConstBranch() = default;
 };
 
@@ -343,12 +288,7 @@ public:
   AstNode::Ptr<> value_ = nullptr;
   AstNode::Children<> children_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstCase() override = default;
+  ~AstCase() = default;
   AstCase() = default;
 };
 
@@ -358,12 +298,7 @@ class AstDefault final : public AstNode {
 public:
   AstNode::Children<> children_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstDefault() override = default;
+  ~AstDefault() = default;
   AstDefault() = default;
 };
 
@@ -375,12 +310,7 @@ public:
   AstNode::Ptr<AstDefault> dflt_ = nullptr;
   AstNode::Children<AstCase> cases_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstSwitch() override = default;
+  ~AstSwitch() = default;
   AstSwitch() = default;
 };
 
@@ -390,12 +320,7 @@ class AstScopeBlock final : public AstNode {
 public:
   AstNode::Children<> children_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstScopeBlock() override = default;
+  ~AstScopeBlock() = default;
   AstScopeBlock() = default;
 };
 
@@ -406,12 +331,7 @@ public:
   AstNode::Ptr<> target_ = nullptr;
   AstNode::Children<> arguments_;
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstCall() override = default;
+  ~AstCall() = default;
   AstCall() = default;
 };
 
@@ -421,12 +341,7 @@ class AstDefer final : public AstNode {
 public:
   AstNode::Ptr<> call_ = nullptr;       // Should ALWAYS be AstCall under the hood
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstDefer() override = default;
+  ~AstDefer() = default;
   AstDefer() = default;
 };
 
@@ -437,12 +352,7 @@ public:
   AstNode::Ptr<> call_ = nullptr;       // Should ALWAYS be AstCall under the hood
   AstNode::Ptr<> condition_ = nullptr;  // The condition on which we call this.
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstDeferIf() override = default;
+  ~AstDeferIf() = default;
   AstDeferIf() = default;
 };
 
@@ -453,12 +363,7 @@ public:
   AstNode::Ptr<> name_ = nullptr;    // EntityRef or EntityRefThunk
   AstNode::Ptr<> vartype_ = nullptr; // TypeRef or TypeRefThunk
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstVardecl() override = default;
+  ~AstVardecl() = default;
   AstVardecl() = default;
 };
 
@@ -470,12 +375,19 @@ public:
   AstNode::Children<> arg_decls_; // The parameter declarations (if any)
   AstNode::Children<> body_;      // The body of the procedure
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
+  // Set when the body was skimmed over instead of parsed (see
+  // ParseContext::skim_bodies). body_ stays empty until then.
+  Token body_begin_;              // The body's opening '{'.
+  Token body_end_;                // The matching '}'.
+  bool body_pending_ = false;
+
+  // Parses a skimmed body, and does nothing otherwise. The body
+  // can be in any file the context has parsed so far, and the
+  // lexer is left where it was. Syntax errors are shown on the
+  // context's errstream, and the body is not parsed again.
+  auto ensure_body(ParseContext& ctx) -> Result<void>;
 
-  ~AstProcDecl() override = default;
+  ~AstProcDecl() = default;
   AstProcDecl() = default;
 };
 
@@ -485,12 +397,7 @@ class AstReturn final : public AstNode {
 public:
   AstNode::Ptr<> value_ = nullptr; // Can be null!
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstReturn() override = default;
+  ~AstReturn() = default;
   AstReturn() = default;
 };
 
@@ -498,12 +405,7 @@ class AstBreak final : public AstNode {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(AstBreak);
   N19_MAKE_DEFAULT_ASSIGNABLE(AstBreak);
 public:
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstBreak() override = default;
+  ~AstBreak() = default;
   AstBreak() = default;
 };
 
@@ -511,13 +413,8 @@ class AstContinue final : public AstNode {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(AstContinue);
   N19_MAKE_DEFAULT_ASSIGNABLE(AstContinue);
 public:
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
   AstContinue() = default;
-  ~AstContinue() override = default;
+  ~AstContinue() = default;
 };
 
 class AstFor final : public AstNode {
@@ -529,12 +426,7 @@ public:
   AstNode::Ptr<> update_  = nullptr; // Can be null!
   AstNode::Ptr<> cond_    = nullptr; // Can be null!
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstFor() override = default;
+  ~AstFor() = default;
   AstFor() = default;
 };
 
@@ -546,12 +438,7 @@ public:
   AstNode::Ptr<> cond_ = nullptr; // The loop condition
   bool is_dowhile      = false;   // If true: the loop is a do-while.
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstWhile() override = default;
+  ~AstWhile() = default;
   AstWhile() = default;
 };
 
@@ -562,12 +449,7 @@ public:
   AstNode::Ptr<> operand_ = nullptr; // The thing being subscripted.
   AstNode::Ptr<> value_   = nullptr; // The index value.
 
-  auto print(uint32_t depth,
-    OStream& stream,
-    const Maybe<std::string> &alias
-  ) const -> void override;
-
-  ~AstSubscript() override = default;
+  ~AstSubscript() = default;
   AstSubscript() = default;
 };
 
@@ -575,26 +457,28 @@ public:
 
 template<typename T>
 auto AstNode::create(
-  const size_t pos,
+  AstArena& arena,
+  const SourcePos pos,
   const uint32_t line,
   AstNode* parent,
   const InputFile::ID file ) -> Ptr<T>
 {
-  auto ptr     = std::make_unique<T>();
-  ptr->parent_ = parent;
-  ptr->pos_    = pos;
-  ptr->line_   = line;
-  ptr->file_   = file;
-  ptr->parent_ = parent;
+  Type type = Type::Node;
 
   #define ASTNODE_X(NAME)              \
   if constexpr(IsSame<T, Ast##NAME>) { \
-    ptr->type_ = Type::NAME;           \
+    type = Type::NAME;                 \
   }
 
   RL_ASTNODE_TYPE_LIST
   #undef ASTNODE_X
 
+  auto ptr     = arena.make<T>(static_cast<uint16_t>(type));
+  ptr->parent_ = parent;
+  ptr->pos_    = pos;
+  ptr->line_   = line;
+  ptr->file_   = file;
+  ptr->type_   = type;
   return ptr;
 }
 
@@ -0,0 +1,116 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/AST/AstArena.hpp>
+#include <n19/Frontend/AST/ASTNodes.hpp>
+#include <n19/System/PageAllocator.hpp>
+#include <n19/Core/Console.hpp>
+#include <n19/Core/Fmt.hpp>
+#include <algorithm>
+BEGIN_NAMESPACE(rl);
+
+static auto align_up_(const uintptr_t value, const size_t align) -> uintptr_t {
+  return (value + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+}
+
+auto AstArena::new_block_(const size_t min_size) -> Block* {
+  const size_t page = sys::PageAllocator::page_size();
+  const size_t want = std::max(block_size_, min_size + sizeof(Block));
+  const size_t size = align_up_(want, page);
+
+  void* mem = sys::PageAllocator::alloc(size);
+#ifndef N19_WIN32
+  if(mem == MAP_FAILED) mem = nullptr;
+#endif
+  if(mem == nullptr) {
+    PANIC("AstArena: could not allocate a block.");
+  }
+
+  auto* block = static_cast<Block*>(mem);
+  block->prev = blocks_;
+  block->size = size;
+  blocks_     = block;
+  reserved_  += size;
+  return block;
+}
+
+auto AstArena::allocate(const size_t size, const size_t align) -> void* {
+  ASSERT(align != 0 && (align & (align - 1)) == 0);
+  used_ += size;
+
+  auto start = align_up_(reinterpret_cast<uintptr_t>(cursor_), align);
+  if(cursor_ != nullptr && start + size <= reinterpret_cast<uintptr_t>(limit_)) {
+    cursor_ = reinterpret_cast<char*>(start + size);
+    return reinterpret_cast<void*>(start);
+  }
+
+  /// Large requests get a block of their own, so the
+  /// rest of the current block isn't thrown away for them.
+  const size_t padded = size + align;
+  if(padded > block_size_ / 4) {
+    Block* block = new_block_(padded);
+    if(cursor_ != nullptr) {              /// Keep the current block on top.
+      blocks_     = block->prev;
+      block->prev = blocks_->prev;
+      blocks_->prev = block;
+    }
+    return reinterpret_cast<void*>(
+      align_up_(reinterpret_cast<uintptr_t>(block + 1), align));
+  }
+
+  Block* block = new_block_(padded);
+  cursor_ = reinterpret_cast<char*>(block + 1);
+  limit_  = reinterpret_cast<char*>(block) + block->size;
+  start   = align_up_(reinterpret_cast<uintptr_t>(cursor_), align);
+  cursor_ = reinterpret_cast<char*>(start + size);
+  return reinterpret_cast<void*>(start);
+}
+
+auto AstArena::try_extend_(void* ptr, const size_t old_size, const size_t new_size) -> bool {
+  char* end = static_cast<char*>(ptr) + old_size;
+  if(end != cursor_ || static_cast<size_t>(limit_ - cursor_) < new_size - old_size) {
+    return false;
+  }
+
+  cursor_ += new_size - old_size;
+  used_   += new_size - old_size;
+  return true;
+}
+
+auto AstArena::usage(const uint16_t kind) const -> Usage {
+  ASSERT(kind < max_kinds_);
+  return kinds_[kind];
+}
+
+auto AstArena::dump(OStream& stream) const -> void {
+  #define ASTNODE_X(NAME)                                        \
+  if(const auto use = usage(uint16_t(AstNode::Type::NAME)); use.count) { \
+    stream << fmt("  {:<18}{:>8} node(s) {:>10} bytes\n",        \
+      #NAME, use.count, use.bytes);                              \
+  }
+
+  RL_ASTNODE_TYPE_LIST
+  #undef ASTNODE_X
+
+  stream
+    << fmt("  {:<18}{:>8} list(s) {:>10} bytes\n", "Child lists", lists_.count, lists_.bytes)
+    << Con::Bold
+    << fmt("  {} bytes used, {} bytes reserved.\n", used_, reserved_)
+    << Con::Reset;
+}
+
+AstArena::~AstArena() {
+  for(Cleanup* rec = cleanups_; rec != nullptr; rec = rec->next) {
+    rec->destroy(rec->object);
+  }
+
+  while(blocks_ != nullptr) {
+    Block* prev = blocks_->prev;
+    sys::PageAllocator::free(blocks_, blocks_->size);
+    blocks_ = prev;
+  }
+}
+
+END_NAMESPACE(rl);
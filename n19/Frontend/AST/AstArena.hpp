@@ -0,0 +1,168 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <n19/Core/Panic.hpp>
+#include <n19/Core/Stream.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+BEGIN_NAMESPACE(rl);
+using namespace n19;
+
+///
+/// Bump allocator for AST nodes and their child lists. Memory is
+/// taken from sys::PageAllocator in blocks and is never freed piecemeal:
+/// everything goes at once when the arena is destroyed. Objects that
+/// have non-trivial destructors are remembered and destroyed first,
+/// newest to oldest.
+class AstArena {
+  N19_MAKE_NONCOPYABLE(AstArena);
+  N19_MAKE_NONMOVABLE(AstArena);
+public:
+  /// Usage is tracked per "kind". For nodes this is the AstNode::Type.
+  static constexpr size_t max_kinds_  = 32;
+  static constexpr size_t block_size_ = 64 * 1024;
+
+  struct Usage {
+    size_t bytes = 0;
+    size_t count = 0;
+  };
+
+  template<typename T, typename ...Args>
+  NODISCARD_ auto make(uint16_t kind, Args&&... args) -> T*;
+
+  /// Returns storage for `new_cap` elements holding the first
+  /// `old_cap` elements of `data`. Grows in place when `data`
+  /// is the most recent allocation and the block has room.
+  template<typename T>
+  NODISCARD_ auto grow_array(T* data, uint32_t old_cap, uint32_t new_cap) -> T*;
+
+  NODISCARD_ auto allocate(size_t size, size_t align) -> void*;
+  NODISCARD_ auto usage(uint16_t kind) const -> Usage;
+  NODISCARD_ auto list_usage() const -> Usage { return lists_; }
+  NODISCARD_ auto bytes_used() const -> size_t { return used_; }
+  NODISCARD_ auto bytes_reserved() const -> size_t { return reserved_; }
+
+  /// Prints bytes used per node type. Implemented alongside
+  /// the node types, since that's where their names are.
+  auto dump(OStream& stream) const -> void;
+
+  AstArena() = default;
+  ~AstArena();
+
+private:
+  struct Block {
+    Block* prev;
+    size_t size;
+  };
+
+  struct Cleanup {
+    void (*destroy)(void*);
+    void* object;
+    Cleanup* next;
+  };
+
+  NODISCARD_ auto new_block_(size_t min_size) -> Block*;
+  NODISCARD_ auto try_extend_(void* ptr, size_t old_size, size_t new_size) -> bool;
+
+  Block* blocks_     = nullptr;
+  char* cursor_      = nullptr;
+  char* limit_       = nullptr;
+  Cleanup* cleanups_ = nullptr;
+  size_t used_       = 0;
+  size_t reserved_   = 0;
+  std::array<Usage, max_kinds_> kinds_{};
+  Usage lists_{};
+};
+
+///
+/// A list whose storage lives in an AstArena. It never owns anything
+/// and is trivially destructible. Growing it leaves the old storage
+/// behind in the arena, so adding an element needs the arena at hand.
+template<typename T>
+class AstList {
+  static_assert(std::is_trivially_copyable_v<T>);
+public:
+  auto push_back(AstArena& arena, T value) -> void {
+    if(size_ == cap_) {
+      const uint32_t new_cap = cap_ ? cap_ * 2 : 4;
+      data_ = arena.grow_array(data_, cap_, new_cap);
+      cap_  = new_cap;
+    }
+    data_[size_++] = value;
+  }
+
+  NODISCARD_ auto at(const size_t i) -> T& {
+    ASSERT(i < size_, "AstList index out of range.");
+    return data_[i];
+  }
+
+  NODISCARD_ auto at(const size_t i) const -> const T& {
+    ASSERT(i < size_, "AstList index out of range.");
+    return data_[i];
+  }
+
+  auto operator[](const size_t i) -> T& { return data_[i]; }
+  auto operator[](const size_t i) const -> const T& { return data_[i]; }
+
+  NODISCARD_ auto begin() -> T* { return data_; }
+  NODISCARD_ auto end()   -> T* { return data_ + size_; }
+  NODISCARD_ auto begin() const -> const T* { return data_; }
+  NODISCARD_ auto end()   const -> const T* { return data_ + size_; }
+  NODISCARD_ auto size()  const -> size_t { return size_; }
+  NODISCARD_ auto empty() const -> bool { return size_ == 0; }
+
+private:
+  T* data_       = nullptr;
+  uint32_t size_ = 0;
+  uint32_t cap_  = 0;
+};
+
+template<typename T, typename ...Args>
+auto AstArena::make(const uint16_t kind, Args&&... args) -> T* {
+  ASSERT(kind < max_kinds_);
+  T* obj = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+  if constexpr(!std::is_trivially_destructible_v<T>) {
+    auto* rec     = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+    rec->destroy  = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+    rec->object   = obj;
+    rec->next     = cleanups_;
+    cleanups_     = rec;
+  }
+
+  kinds_[kind].bytes += sizeof(T);
+  kinds_[kind].count += 1;
+  return obj;
+}
+
+template<typename T>
+auto AstArena::grow_array(T* data, const uint32_t old_cap, const uint32_t new_cap) -> T* {
+  static_assert(std::is_trivially_copyable_v<T>);
+  ASSERT(new_cap > old_cap);
+
+  const size_t old_size = sizeof(T) * old_cap;
+  const size_t new_size = sizeof(T) * new_cap;
+  lists_.bytes += new_size - old_size;
+  if(data == nullptr) lists_.count += 1;
+
+  if(data != nullptr && try_extend_(data, old_size, new_size)) {
+    return data;
+  }
+
+  T* fresh = static_cast<T*>(allocate(new_size, alignof(T)));
+  if(old_size != 0) std::memcpy(fresh, data, old_size);
+  return fresh;
+}
+
+END_NAMESPACE(rl);
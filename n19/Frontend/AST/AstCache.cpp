@@ -0,0 +1,63 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/AST/AstCache.hpp>
+#include <n19/System/File.hpp>
+#include <n19/Core/Bytes.hpp>
+#include <n19/Core/Fmt.hpp>
+#include <string_view>
+
+BEGIN_NAMESPACE(rl);
+
+auto AstCache::open(const sys::String& dir) -> Result<AstCache> {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if(ec) return Error(ErrC::FileIO, "Could not create the AST cache directory: " + ec.message());
+
+  AstCache cache;
+  cache.dir_ = dir;
+  return cache;
+}
+
+auto AstCache::hash(const std::span<const char8_t> src) -> Murmur3_128 {
+  return murmur3_x64_128(std::u8string_view{ src.data(), src.size() }, seed);
+}
+
+auto AstCache::path_for(const Murmur3_128& hash) const -> std::filesystem::path {
+  return dir_ / fmt("{:016x}{:016x}.rlast", hash.first_, hash.second_);
+}
+
+/// Anything that doesn't add up is treated as a miss
+/// rather than an error, the entry just gets rewritten.
+auto AstCache::load(const Murmur3_128& source, const InputFile::ID file) -> Maybe<AstImage> {
+  const auto path = path_for(source);
+  std::error_code ec;
+  if(std::filesystem::is_regular_file(path, ec)) {
+    auto image = AstImage::open(sys::String(path.native()));
+    if(image
+      && image->source().first_  == source.first_
+      && image->source().second_ == source.second_
+      && image->file() == file) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return image.release_value();
+    }
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return Nothing;
+}
+
+/// Written with sys::write_atomically(), so
+/// a concurrent reader never sees half of an entry.
+auto AstCache::store(
+  const Murmur3_128& source,
+  const InputFile::ID file,
+  const FlatAst& ast ) -> Result<void>
+{
+  const auto out = AstImage::serialize(ast, source, file);
+  return sys::write_atomically(path_for(source), as_bytes(out));
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <n19/Core/Maybe.hpp>
+#include <n19/Core/Murmur3.hpp>
+#include <n19/Core/Result.hpp>
+#include <n19/System/String.hpp>
+#include <n19/Frontend/AST/AstImage.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <filesystem>
+#include <atomic>
+#include <utility>
+#include <span>
+#include <cstdint>
+BEGIN_NAMESPACE(rl);
+using namespace n19;
+
+///
+/// An opt-in, on-disk cache of parsed ASTs, one AstImage per
+/// entry. Like TokenCache, entries are keyed by a 128-bit hash of
+/// the source bytes. The image also records the input file ID it
+/// was parsed as, since file IDs show up in the dumped tree, and an
+/// entry stored under a different ID counts as a miss.
+///
+/// Entity IDs in an image refer to the entity table of the parse
+/// that produced it. That table isn't cached, so a hit is only
+/// good for consumers of the tree itself. Like a TokenCache, it
+/// can be shared between threads.
+class AstCache {
+  N19_MAKE_NONCOPYABLE(AstCache);
+public:
+  struct Stats {
+    size_t hits   = 0;
+    size_t misses = 0;
+  };
+
+  constexpr static uint32_t seed = 0x6e313961;
+
+  /// Creates the directory if it doesn't exist yet.
+  static auto open(const sys::String& dir) -> Result<AstCache>;
+  static auto hash(std::span<const char8_t> src) -> Murmur3_128;
+
+  /// The mapped image for `source`, if there's a valid one.
+  auto load(const Murmur3_128& source, InputFile::ID file) -> Maybe<AstImage>;
+  auto store(const Murmur3_128& source, InputFile::ID file, const FlatAst& ast) -> Result<void>;
+  auto stats() const -> Stats;
+  auto path_for(const Murmur3_128& hash) const -> std::filesystem::path;
+
+  AstCache(AstCache&& other) noexcept;
+  AstCache& operator=(AstCache&& other) noexcept;
+  AstCache() = default;
+  ~AstCache() = default;
+private:
+  std::filesystem::path dir_;
+  std::atomic<size_t> hits_{ 0 };
+  std::atomic<size_t> misses_{ 0 };
+};
+
+inline AstCache::AstCache(AstCache&& other) noexcept
+  : dir_(std::move(other.dir_))
+  , hits_(other.hits_.load())
+  , misses_(other.misses_.load()) {}
+
+inline auto AstCache::operator=(AstCache&& other) noexcept -> AstCache& {
+  dir_ = std::move(other.dir_);
+  hits_.store(other.hits_.load());
+  misses_.store(other.misses_.load());
+  return *this;
+}
+
+inline auto AstCache::stats() const -> Stats {
+  return Stats{ .hits = hits_.load(), .misses = misses_.load() };
+}
+
+END_NAMESPACE(rl);
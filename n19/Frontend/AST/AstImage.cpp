@@ -0,0 +1,284 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/AST/AstImage.hpp>
+#include <n19/System/File.hpp>
+#include <n19/Core/Try.hpp>
+#include <type_traits>
+#include <cstring>
+#include <string>
+
+BEGIN_NAMESPACE(rl);
+namespace {
+  enum Section_ : uint32_t {
+    Kinds, Fields, Pos, Lines, Files, Parents, FirstChild, NextSibling, Payload,
+    Ops, Scalars, Strings, Thunks, Qualifiers, Lengths, Blob,
+    SectionCount_,
+  };
+
+  struct SectionRecord_ {
+    uint64_t offset;          /// From the start of the file.
+    uint64_t count;           /// Elements, not bytes.
+    uint32_t elem_size;       /// sizeof one element, in case the layout moves.
+    uint32_t unused_;
+  };
+
+  struct Header_ {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;      /// byte_order_ as written, so a foreign-endian file is rejected.
+    uint64_t hash_first;
+    uint64_t hash_second;
+    uint64_t nodes;
+    InputFile::ID file;
+    uint32_t unused_;
+    SectionRecord_ sections[SectionCount_];
+  };
+
+  constexpr char magic_[8] = { 'n', '1', '9', 'a', 's', 't', '\0', '\0' };
+  constexpr uint16_t kind_count_ = [] {
+    uint16_t count = 0;
+  #define ASTNODE_X(NAME) ++count;
+    RL_ASTNODE_TYPE_LIST
+  #undef ASTNODE_X
+    return count;
+  }();
+  constexpr uint32_t byte_order_ = 0x01020304;
+
+  static_assert(std::is_trivially_copyable_v<FlatAst::Op>);
+  static_assert(std::is_trivially_copyable_v<FlatAst::Scalar>);
+  static_assert(std::is_trivially_copyable_v<PackedPos>);
+  static_assert(std::is_trivially_copyable_v<AstImage::Qualifier>);
+  static_assert(std::is_trivially_copyable_v<Header_>);
+
+  constexpr auto align8_(const uint64_t size) -> uint64_t {
+    return (size + 7) & ~uint64_t{7};
+  }
+
+  template<typename T>
+  auto append_(std::vector<Byte>& out, SectionRecord_& rec, const T* data, const size_t count) -> void {
+    const size_t size = sizeof(T) * count;
+    const size_t at   = out.size();
+    rec = { .offset = at, .count = count, .elem_size = sizeof(T), .unused_ = 0 };
+    out.resize(align8_(at + size));
+    if(size) std::memcpy(out.data() + at, data, size);
+  }
+
+  /// The section as a span over `bytes`, or nothing if its
+  /// record doesn't describe somewhere inside the file.
+  template<typename T>
+  auto section_(const Bytes bytes, const SectionRecord_& rec, std::span<const T>& into) -> bool {
+    if(rec.elem_size != sizeof(T) || rec.offset % 8 != 0 || rec.offset > bytes.size()) return false;
+    if(rec.count > (bytes.size() - rec.offset) / sizeof(T)) return false;
+    into = { reinterpret_cast<const T*>(bytes.data() + rec.offset), static_cast<size_t>(rec.count) };
+    return true;
+  }
+
+  auto flatten_(std::string& blob, const std::string_view text) -> AstImage::StringRef {
+    const AstImage::StringRef ref{ static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(text.size()) };
+    blob += text;
+    return ref;
+  }
+}
+
+auto AstImage::serialize(
+  const FlatAst& ast,
+  const Murmur3_128& source,
+  const InputFile::ID file ) -> std::vector<Byte>
+{
+  std::vector<StringRef> strings;
+  std::vector<StringRef> thunks;
+  std::vector<Qualifier> qualifiers;
+  std::vector<uint32_t> lengths;
+  std::string blob;
+
+  strings.reserve(ast.strings_.size());
+  for(const std::string& str : ast.strings_) {
+    strings.emplace_back(flatten_(blob, str));
+  }
+
+  /// Thunks keep their spelling but not their StringPool
+  /// index, which only means something to the lexer that made it.
+  thunks.reserve(ast.thunks_.size());
+  for(const FlatAst::Thunk& thunk : ast.thunks_) {
+    thunks.emplace_back(flatten_(blob, thunk.name));
+  }
+
+  qualifiers.reserve(ast.qualifiers_.size());
+  for(const EntityQualifier& qual : ast.qualifiers_) {
+    qualifiers.emplace_back(Qualifier{
+      .id        = qual.id_,
+      .ptr_depth = qual.ptr_depth_,
+      .lengths   = static_cast<uint32_t>(lengths.size()),
+      .dims      = static_cast<uint32_t>(qual.arr_lengths_.size()),
+      .flags     = qual.flags_,
+      .unused_   = {},
+    });
+    lengths.insert(lengths.end(), qual.arr_lengths_.begin(), qual.arr_lengths_.end());
+  }
+
+  Header_ header{};
+  std::memcpy(header.magic, magic_, sizeof(magic_));
+  header.version     = version;
+  header.byte_order  = byte_order_;
+  header.hash_first  = source.first_;
+  header.hash_second = source.second_;
+  header.nodes       = ast.size();
+  header.file        = file;
+
+  std::vector<Byte> out(align8_(sizeof(Header_)));
+  auto& sec = header.sections;
+  append_(out, sec[Kinds],       ast.kinds_.data(),        ast.kinds_.size());
+  append_(out, sec[Fields],      ast.fields_.data(),       ast.fields_.size());
+  append_(out, sec[Pos],         ast.pos_.data(),          ast.pos_.size());
+  append_(out, sec[Lines],       ast.lines_.data(),        ast.lines_.size());
+  append_(out, sec[Files],       ast.files_.data(),        ast.files_.size());
+  append_(out, sec[Parents],     ast.parents_.data(),      ast.parents_.size());
+  append_(out, sec[FirstChild],  ast.first_child_.data(),  ast.first_child_.size());
+  append_(out, sec[NextSibling], ast.next_sibling_.data(), ast.next_sibling_.size());
+  append_(out, sec[Payload],     ast.payload_.data(),      ast.payload_.size());
+  append_(out, sec[Ops],         ast.ops_.data(),          ast.ops_.size());
+  append_(out, sec[Scalars],     ast.scalars_.data(),      ast.scalars_.size());
+  append_(out, sec[Strings],     strings.data(),           strings.size());
+  append_(out, sec[Thunks],      thunks.data(),            thunks.size());
+  append_(out, sec[Qualifiers],  qualifiers.data(),        qualifiers.size());
+  append_(out, sec[Lengths],     lengths.data(),           lengths.size());
+  append_(out, sec[Blob],        blob.data(),              blob.size());
+
+  std::memcpy(out.data(), &header, sizeof(header));
+  return out;
+}
+
+auto AstImage::open(const sys::String& path) -> Result<AstImage> {
+  auto file = TRY(sys::File::open(path, false, sys::File::Read));
+  auto mapped = sys::MappedFile::map(file);
+  file.close();
+  if(!mapped) return mapped.release_error();
+
+  auto image = view(mapped->bytes());
+  if(image) image->mapped_ = mapped.release_value();
+  return image;
+}
+
+auto AstImage::view(const Bytes bytes) -> Result<AstImage> {
+  const auto invalid = [] { return Error(ErrC::InvalidArg, "Not a valid AST image."); };
+  Header_ header{};
+  if(bytes.size() < sizeof(header) || reinterpret_cast<uintptr_t>(bytes.data()) % 8 != 0) {
+    return invalid();
+  }
+
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  if(std::memcmp(header.magic, magic_, sizeof(magic_)) != 0
+    || header.version    != version
+    || header.byte_order != byte_order_
+    || header.nodes > bytes.size()) {
+    return invalid();
+  }
+
+  AstImage image;
+  image.source_ = { header.hash_first, header.hash_second };
+  image.file_   = header.file;
+
+  const auto& sec = header.sections;
+  const bool found = section_(bytes, sec[Kinds],       image.kinds_)
+    && section_(bytes, sec[Fields],      image.fields_)
+    && section_(bytes, sec[Pos],         image.pos_)
+    && section_(bytes, sec[Lines],       image.lines_)
+    && section_(bytes, sec[Files],       image.files_)
+    && section_(bytes, sec[Parents],     image.parents_)
+    && section_(bytes, sec[FirstChild],  image.first_child_)
+    && section_(bytes, sec[NextSibling], image.next_sibling_)
+    && section_(bytes, sec[Payload],     image.payload_)
+    && section_(bytes, sec[Ops],         image.ops_)
+    && section_(bytes, sec[Scalars],     image.scalars_)
+    && section_(bytes, sec[Strings],     image.strings_)
+    && section_(bytes, sec[Thunks],      image.thunks_)
+    && section_(bytes, sec[Qualifiers],  image.qualifiers_)
+    && section_(bytes, sec[Lengths],     image.lengths_)
+    && section_(bytes, sec[Blob],        image.blob_);
+
+  if(!found || image.size() != header.nodes || !image.validate_()) {
+    return invalid();
+  }
+
+  return image;
+}
+
+/// Everything a walk of the image dereferences, checked once
+/// up front: links stay in pre-order, payloads index into
+/// their side tables, and every string lies inside the blob.
+auto AstImage::validate_() const -> bool {
+  using T = AstNode::Type;
+  const size_t nodes = size();
+  if(fields_.size() != nodes || pos_.size() != nodes || lines_.size() != nodes
+    || files_.size() != nodes || parents_.size() != nodes || first_child_.size() != nodes
+    || next_sibling_.size() != nodes || payload_.size() != nodes) {
+    return false;
+  }
+
+  const auto in_blob = [this](const StringRef& ref) {
+    return uint64_t{ref.offset} + ref.len <= blob_.size();
+  };
+
+  for(const StringRef& ref : strings_) if(!in_blob(ref)) return false;
+  for(const StringRef& ref : thunks_)  if(!in_blob(ref)) return false;
+  for(const Qualifier& qual : qualifiers_) {
+    if(uint64_t{qual.lengths} + qual.dims > lengths_.size()) return false;
+  }
+  for(const FlatAst::Op& op : ops_) {
+    if(op.type.value >= TokenType::count) return false;
+  }
+  for(const FlatAst::Scalar& scalar : scalars_) {
+    if(scalar.string != FlatAst::none_ && scalar.string >= strings_.size()) return false;
+  }
+
+  for(Index i = 0; i < nodes; i++) {
+    const auto kind = static_cast<uint16_t>(kinds_[i]);
+    if(kind >= kind_count_ || fields_[i] >= 4) return false;
+    if(parents_[i] != FlatAst::none_ && parents_[i] >= i) return false;
+
+    /// FlatAst::field_name() only has three names for a Switch.
+    if(parents_[i] != FlatAst::none_ && kinds_[ parents_[i] ] == T::Switch && fields_[i] > 2) {
+      return false;
+    }
+    if(first_child_[i] != FlatAst::none_ && first_child_[i] != i + 1) return false;
+    if(next_sibling_[i] != FlatAst::none_
+      && (next_sibling_[i] <= i || next_sibling_[i] >= nodes)) {
+      return false;
+    }
+
+    const uint32_t payload = payload_[i];
+    switch(kinds_[i]) {
+    case T::BinExpr:
+    case T::UnaryExpr:      if(payload >= ops_.size()) return false; break;
+    case T::ScalarLiteral:  if(payload >= scalars_.size()) return false; break;
+    case T::EntityRefThunk: if(payload >= thunks_.size()) return false; break;
+    case T::QualifiedRef:   if(payload >= qualifiers_.size()) return false; break;
+    default: break;
+    }
+  }
+
+  /// A first child at i + 1 also has to name i as its parent,
+  /// or the walk would take the wrong node for one.
+  for(Index i = 0; i + 1 < nodes; i++) {
+    if(first_child_[i] != FlatAst::none_ && parents_[i + 1] != i) return false;
+  }
+
+  return first_child_.empty() || first_child_.back() == FlatAst::none_;
+}
+
+auto AstImage::qualifier(const Index i) const -> EntityQualifier {
+  const Qualifier& rec = qualifiers_[i];
+  EntityQualifier qual;
+  qual.id_        = rec.id;
+  qual.ptr_depth_ = rec.ptr_depth;
+  qual.flags_     = rec.flags;
+  qual.arr_lengths_.assign(
+    lengths_.begin() + rec.lengths,
+    lengths_.begin() + rec.lengths + rec.dims);
+  return qual;
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <n19/Core/Bytes.hpp>
+#include <n19/Core/Murmur3.hpp>
+#include <n19/Core/Result.hpp>
+#include <n19/Core/Stream.hpp>
+#include <n19/System/MappedFile.hpp>
+#include <n19/System/String.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+BEGIN_NAMESPACE(rl);
+using namespace n19;
+
+///
+/// A FlatAst in its on-disk form, walked where it lies instead
+/// of being read back into vectors or AstNodes.
+///
+/// The format is a header followed by one section per FlatAst
+/// column and side table, each 8-byte aligned and located by its
+/// byte offset from the start of the file. Nothing in it is a
+/// pointer, so the file can be mapped anywhere. Strings, thunk
+/// names and qualifier array lengths, which FlatAst keeps in
+/// owning containers, are flattened into records that point
+/// into a shared blob or length table.
+///
+/// Every offset, count and cross-reference is checked when an
+/// image is opened, so walking one never reads out of bounds,
+/// no matter what was on disk.
+class AstImage {
+  N19_MAKE_NONCOPYABLE(AstImage);
+public:
+  using Index = FlatAst::Index;
+
+  /// Bumped whenever the layout, or anything
+  /// that changes what the parser produces, changes.
+  constexpr static uint32_t version = 1;
+
+  struct StringRef {
+    uint32_t offset = 0;   /// Into blob_.
+    uint32_t len    = 0;
+  };
+
+  struct Qualifier {
+    Entity::ID id      = 0;
+    uint32_t ptr_depth = 0;
+    uint32_t lengths   = 0;   /// First array length, into lengths_.
+    uint32_t dims      = 0;   /// How many array lengths there are.
+    uint8_t flags      = 0;
+    uint8_t unused_[3] = {};
+  };
+
+  /// The whole image for `ast`, tagged with the source it was
+  /// parsed from and the input file ID it was parsed as.
+  NODISCARD_ static auto serialize(
+    const FlatAst& ast,
+    const Murmur3_128& source,
+    InputFile::ID file
+  ) -> std::vector<Byte>;
+
+  /// Maps `path` and validates it. The image keeps the mapping alive.
+  NODISCARD_ static auto open(const sys::String& path) -> Result<AstImage>;
+
+  /// Validates `bytes` and views them in place. They have to
+  /// be 8-byte aligned and outlive the image.
+  NODISCARD_ static auto view(Bytes bytes) -> Result<AstImage>;
+
+  /// Writes the same text FlatAst::dump() and AstNode::print()
+  /// do, straight off the image. Implemented in DumpAST.cpp.
+  auto dump(OStream& stream) const -> void;
+
+  NODISCARD_ auto string(Index i)     const -> std::string_view;
+  NODISCARD_ auto thunk_name(Index i) const -> std::string_view;
+  NODISCARD_ auto qualifier(Index i)  const -> EntityQualifier;
+
+  NODISCARD_ auto source() const -> Murmur3_128   { return source_; }
+  NODISCARD_ auto file()   const -> InputFile::ID { return file_; }
+  NODISCARD_ auto size()   const -> size_t        { return kinds_.size(); }
+  NODISCARD_ auto empty()  const -> bool          { return kinds_.empty(); }
+
+  // Node columns //
+  //////////////////////////////////////////
+  std::span<const AstNode::Type> kinds_;
+  std::span<const FlatAst::Field> fields_;
+  std::span<const PackedPos> pos_;
+  std::span<const uint32_t> lines_;
+  std::span<const InputFile::ID> files_;
+  std::span<const Index> parents_;
+  std::span<const Index> first_child_;
+  std::span<const Index> next_sibling_;
+  std::span<const uint32_t> payload_;
+
+  // Side tables //
+  //////////////////////////////////////////
+  std::span<const FlatAst::Op> ops_;
+  std::span<const FlatAst::Scalar> scalars_;
+  std::span<const StringRef> strings_;
+  std::span<const StringRef> thunks_;
+  std::span<const Qualifier> qualifiers_;
+  std::span<const uint32_t> lengths_;
+  std::span<const char> blob_;
+  //////////////////////////////////////////
+
+  AstImage(AstImage&&) = default;
+  AstImage& operator=(AstImage&&) = default;
+  AstImage() = default;
+  ~AstImage() = default;
+private:
+  auto validate_() const -> bool;
+
+  sys::MappedFile mapped_;   /// Empty for images from view().
+  Murmur3_128 source_{};
+  InputFile::ID file_ = RL_INVALID_INFILE_ID;
+};
+
+inline auto AstImage::string(const Index i) const -> std::string_view {
+  return { blob_.data() + strings_[i].offset, strings_[i].len };
+}
+
+inline auto AstImage::thunk_name(const Index i) const -> std::string_view {
+  return { blob_.data() + thunks_[i].offset, thunks_[i].len };
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,315 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Frontend/AST/ASTNodes.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+BEGIN_NAMESPACE(rl);
+
+///
+/// Which member of its parent a child node was taken from. The
+/// numbering is per node type, in the order for_each_child() uses.
+using AstField = uint8_t;
+
+///
+/// Calls `fn(child, field)` for each non-null child of `node`, in
+/// the order they are dumped. This is the one place that knows
+/// which members of each node type hold children.
+template<typename Fn>
+auto for_each_child(const AstNode& node, Fn&& fn) -> void {
+  auto one = [&](const AstNode* child, const AstField field) {
+    if(child != nullptr) fn(child, field);
+  };
+
+  auto all = [&](const auto& list, const AstField field) {
+    for(const AstNode* child : list) one(child, field);
+  };
+
+  using T = AstNode::Type;
+  switch(node.type_) {
+  case T::BinExpr: {
+    const auto& n = static_cast<const AstBinExpr&>(node);
+    one(n.left_, 0);
+    one(n.right_, 1);
+    break;
+  }
+  case T::UnaryExpr:
+    one(static_cast<const AstUnaryExpr&>(node).operand_, 0);
+    break;
+  case T::AggregateLiteral:
+    all(static_cast<const AstAggregateLiteral&>(node).children_, 0);
+    break;
+  case T::If: {
+    const auto& n = static_cast<const AstIf&>(node);
+    one(n.condition_, 0);
+    all(n.body_, 1);
+    break;
+  }
+  case T::Else:
+    all(static_cast<const AstElse&>(node).body_, 0);
+    break;
+  case T::ConstIf: {
+    const auto& n = static_cast<const AstConstIf&>(node);
+    one(n.condition_, 0);
+    all(n.body_, 1);
+    break;
+  }
+  case T::ConstElse:
+    all(static_cast<const AstConstElse&>(node).body_, 0);
+    break;
+  case T::Branch: {
+    const auto& n = static_cast<const AstBranch&>(node);
+    one(n.if_, 0);
+    one(n.else_, 1);
+    break;
+  }
+  case T::ConstBranch: {
+    const auto& n = static_cast<const AstConstBranch&>(node);
+    one(n.if_, 0);
+    one(n.else_, 1);
+    break;
+  }
+  case T::Case: {
+    const auto& n = static_cast<const AstCase&>(node);
+    one(n.value_, 0);
+    all(n.children_, 1);
+    break;
+  }
+  case T::Default:
+    all(static_cast<const AstDefault&>(node).children_, 0);
+    break;
+  case T::Switch: {
+    const auto& n = static_cast<const AstSwitch&>(node);
+    one(n.target_, 0);
+    one(n.dflt_, 1);
+    all(n.cases_, 2);
+    break;
+  }
+  case T::ScopeBlock:
+    all(static_cast<const AstScopeBlock&>(node).children_, 0);
+    break;
+  case T::Namespace:
+    all(static_cast<const AstNamespace&>(node).body_, 0);
+    break;
+  case T::Call: {
+    const auto& n = static_cast<const AstCall&>(node);
+    all(n.arguments_, 0);
+    one(n.target_, 1);
+    break;
+  }
+  case T::Defer:
+    one(static_cast<const AstDefer&>(node).call_, 0);
+    break;
+  case T::DeferIf: {
+    const auto& n = static_cast<const AstDeferIf&>(node);
+    one(n.condition_, 0);
+    one(n.call_, 1);
+    break;
+  }
+  case T::Vardecl: {
+    const auto& n = static_cast<const AstVardecl&>(node);
+    one(n.name_, 0);
+    one(n.vartype_, 1);
+    break;
+  }
+  case T::ProcDecl: {
+    const auto& n = static_cast<const AstProcDecl&>(node);
+    all(n.arg_decls_, 0);
+    all(n.body_, 1);
+    break;
+  }
+  case T::Return:
+    one(static_cast<const AstReturn&>(node).value_, 0);
+    break;
+  case T::For: {
+    const auto& n = static_cast<const AstFor&>(node);
+    one(n.init_, 0);
+    one(n.cond_, 1);
+    one(n.update_, 2);
+    one(n.body_, 3);
+    break;
+  }
+  case T::While: {
+    const auto& n = static_cast<const AstWhile&>(node);
+    one(n.cond_, 0);
+    all(n.body_, 1);
+    break;
+  }
+  case T::Subscript: {
+    const auto& n = static_cast<const AstSubscript&>(node);
+    one(n.operand_, 0);
+    one(n.value_, 1);
+    break;
+  }
+  default: break;   /// Leaves.
+  }
+}
+
+///
+/// What a visitor hook wants to happen next.
+enum class VisitAction : uint8_t {
+  Continue,   /// Carry on.
+  Skip,       /// Don't descend into this node. Only meaningful from a pre hook.
+  Stop,       /// End the walk now. No further hooks are called.
+};
+
+///
+/// Where a visited node sits, as seen by the hooks.
+struct AstVisitFrame {
+  const AstNode* parent = nullptr;  /// Null for the node a walk started at.
+  AstField field        = 0;        /// Which of the parent's members this is in.
+  uint32_t depth        = 0;        /// Relative to where the walk started.
+  uint32_t ordinal      = 1;        /// 1-based, among siblings in the same field.
+};
+
+///
+/// CRTP visitor over the AstNode hierarchy. For every entry in
+/// RL_ASTNODE_TYPE_LIST there is a pre_NAME and a post_NAME hook, which
+/// fall back to pre_node / post_node. A derived class defines the ones
+/// it cares about. Hooks are reached through a table indexed by the
+/// node's type_ and a static_cast, so there are no virtual calls.
+///
+/// walk() keeps its own stack rather than recursing, so deeply nested
+/// expressions can't overflow the native one. Post hooks run after all
+/// of a node's children, including for nodes whose pre hook said Skip.
+template<typename Derived>
+class AstVisitor {
+public:
+  /// Returns false if a hook stopped the walk.
+  auto walk(const AstNode* root, const AstVisitFrame& frame = {}) -> bool;
+  auto walk(std::span<const AstNode::Ptr<>> roots) -> bool;
+
+  auto dispatch_pre(const AstNode& node, const AstVisitFrame& frame) -> VisitAction {
+    return pre_hook_(node.type_)(self_(), node, frame);
+  }
+
+  auto dispatch_post(const AstNode& node, const AstVisitFrame& frame) -> VisitAction {
+    return post_hook_(node.type_)(self_(), node, frame);
+  }
+
+  // Hooks //
+  //////////////////////////////////////////
+  auto pre_node(const AstNode&, const AstVisitFrame&) -> VisitAction {
+    return VisitAction::Continue;
+  }
+
+  auto post_node(const AstNode&, const AstVisitFrame&) -> VisitAction {
+    return VisitAction::Continue;
+  }
+
+  #define ASTNODE_X(NAME)                                                            \
+  auto pre_##NAME(const Ast##NAME& node, const AstVisitFrame& frame) -> VisitAction { \
+    return self_().pre_node(node, frame);                                            \
+  }                                                                                  \
+  auto post_##NAME(const Ast##NAME& node, const AstVisitFrame& frame) -> VisitAction {\
+    return self_().post_node(node, frame);                                           \
+  }
+
+  RL_ASTNODE_TYPE_LIST
+  #undef ASTNODE_X
+  //////////////////////////////////////////
+
+protected:
+  AstVisitor() = default;
+  ~AstVisitor() = default;
+
+private:
+  using Hook_ = VisitAction(*)(Derived&, const AstNode&, const AstVisitFrame&);
+
+  struct Entry_ {
+    const AstNode* node;
+    AstVisitFrame frame;
+    bool post;
+  };
+
+  auto self_() -> Derived& { return static_cast<Derived&>(*this); }
+
+  static auto pre_hook_(const AstNode::Type type) -> Hook_ {
+    #define ASTNODE_X(NAME)                                                    \
+    +[](Derived& self, const AstNode& node, const AstVisitFrame& frame) {      \
+      return self.pre_##NAME(static_cast<const Ast##NAME&>(node), frame);      \
+    },
+
+    static constexpr Hook_ table[] = { RL_ASTNODE_TYPE_LIST };
+    #undef ASTNODE_X
+    return table[ static_cast<uint16_t>(type) ];
+  }
+
+  static auto post_hook_(const AstNode::Type type) -> Hook_ {
+    #define ASTNODE_X(NAME)                                                    \
+    +[](Derived& self, const AstNode& node, const AstVisitFrame& frame) {      \
+      return self.post_##NAME(static_cast<const Ast##NAME&>(node), frame);     \
+    },
+
+    static constexpr Hook_ table[] = { RL_ASTNODE_TYPE_LIST };
+    #undef ASTNODE_X
+    return table[ static_cast<uint16_t>(type) ];
+  }
+
+  std::vector<Entry_> stack_;
+};
+
+template<typename Derived>
+auto AstVisitor<Derived>::walk(const AstNode* root, const AstVisitFrame& frame) -> bool {
+  if(root == nullptr) return true;
+
+  /// Hooks may start walks of their own, which share
+  /// the stack. Only ever look above where this one began.
+  const size_t base = stack_.size();
+  stack_.push_back({ root, frame, false });
+
+  while(stack_.size() > base) {
+    const Entry_ entry = stack_.back();
+    stack_.pop_back();
+
+    if(entry.post) {
+      if(dispatch_post(*entry.node, entry.frame) == VisitAction::Stop) {
+        stack_.resize(base);
+        return false;
+      }
+      continue;
+    }
+
+    const VisitAction action = dispatch_pre(*entry.node, entry.frame);
+    if(action == VisitAction::Stop) {
+      stack_.resize(base);
+      return false;
+    }
+
+    stack_.push_back({ entry.node, entry.frame, true });
+    if(action == VisitAction::Skip) continue;
+
+    /// Children go on in reverse, so they come off in order.
+    const size_t first  = stack_.size();
+    AstField last_field = 0;
+    uint32_t ordinal    = 0;
+    for_each_child(*entry.node, [&](const AstNode* child, const AstField field) {
+      ordinal    = ordinal != 0 && field == last_field ? ordinal + 1 : 1;
+      last_field = field;
+      stack_.push_back({ child, { entry.node, field, entry.frame.depth + 1, ordinal }, false });
+    });
+
+    std::reverse(stack_.begin() + static_cast<ptrdiff_t>(first), stack_.end());
+  }
+
+  return true;
+}
+
+template<typename Derived>
+auto AstVisitor<Derived>::walk(const std::span<const AstNode::Ptr<>> roots) -> bool {
+  for(const AstNode* root : roots) {
+    if(!walk(root)) return false;
+  }
+
+  return true;
+}
+
+END_NAMESPACE(rl);
@@ -4,21 +4,27 @@
 */
 
 #include <n19/Frontend/AST/ASTNodes.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <n19/Frontend/AST/AstImage.hpp>
+#include <n19/Frontend/AST/AstVisitor.hpp>
+#include <bit>
 #include <cctype>
+#include <vector>
 BEGIN_NAMESPACE(rl);
 
-auto AstNode::print_(
+static auto print_header_(
   const uint32_t depth,
   OStream& stream,
-  const std::string& node_name ) const -> void
+  const std::string_view node_name,
+  const InputFile::ID file,
+  const uint32_t line,
+  const SourcePos pos ) -> void
 {
   for(uint32_t i = 0; i < depth; i++) 
     stream << "  |";
   if(depth) 
     stream << "__ ";
 
-  auto file_name = Context::the().get_input_by_id(file_);
-  
   stream              ////////////////////////////////////
     << Con::Bold      // Begin "title":
     << Con::MagentaFG // Bold, magenta.
@@ -27,635 +33,534 @@ auto AstNode::print_(
     << " "            // Empty space.
     << "FileID="      // Show the file ID.
     << Con::YellowFG  // On a yellow foreground.
-    << file_          // ...
+    << file           // ...
     << Con::Reset;    // Reset colour.
   stream              //
     << " <"           // Line, position info.
     << Con::YellowFG  // Line number: yellow.
-    << this->line_    //
+    << line           //
     << Con::Reset     //
     << ','            // Reset colour for ','.
     << Con::YellowFG  //
-    << this->pos_     // Print position in yellow.
+    << pos            // Print position in yellow.
     << Con::Reset     // Reset the console once more.
     << "> :: ";       ////////////////////////////////////
 }
 
-auto AstBranch::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Branch");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-  
+static auto print_alias_(OStream& stream, const std::string_view alias) -> void {
   stream
-    << Con::WhiteFG
-    << "has_else = "
-    << (else_ ? "true" : "false")
+    << Con::GreenFG
+    << fmt("\"{}\" ", alias)
     << Con::Reset;
-
-  if_->print(depth + 1, stream, "Branch.If");
-  if(else_) else_->print(depth + 1, stream, "Branch.Else");
 }
 
-auto AstConstBranch::print(
-  const uint32_t depth,
+///
+/// Prints the label a child gets from the field of its
+/// parent it sits in, e.g. "Binexpr.Left" or "Call.Args.2".
+static auto print_field_alias_(
   OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
+  const AstNode::Type parent,
+  const AstField field,
+  const uint32_t ordinal ) -> void
 {
-  print_(depth, stream, "ConstBranch");
-  if(alias.has_value())
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream
-    << Con::WhiteFG
-    << "has_else = "
-    << (else_ ? "true" : "false")
-    << Con::Reset;
-
-  if_->print(depth + 1, stream, "ConstBranch.If");
-  if(else_ != nullptr)
-    else_->print(depth + 1, stream, "ConstBranch.Else");
+  const auto name = FlatAst::field_name(parent, field);
+  if(name.numbered) {
+    print_alias_(stream, fmt("{}.{}", name.alias, ordinal));
+  } else if(!name.alias.empty()) {
+    print_alias_(stream, name.alias);
+  }
 }
 
-auto AstIf::print(
-  const uint32_t depth,
+static auto print_scalar_(
   OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
+  const uint8_t scalar_type,
+  const std::string_view value,
+  const uint64_t bits ) -> void    /// int_value_, or float_value_'s bits.
 {
-  print_(depth, stream, "If");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream << '\n';
-  condition_->print(depth + 1, stream, "If.Condition");
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
-}
+  /// Btw we need to do this so it doesn't fuck the output.
+  auto get_ch = [](const char ch) -> Maybe<std::string_view> {
+    switch (ch) {
+    case '\v': return "\\v";
+    case '\n': return "\\n";
+    case '\t': return "\\t";
+    case '\b': return "\\b";
+    case '\a': return "\\a";
+    default: return Nothing;
+    }
+  };
 
-auto AstElse::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Else");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+  stream << Con::BlueFG;
+  if(scalar_type == AstScalarLiteral::StringLit || scalar_type == AstScalarLiteral::U8Lit) {
+    for(const char ch : value) {
+      auto val = get_ch(ch);
+      if(val) { stream << *val;}
+      else    { stream << ch;  }
+    }
+  }
+  else if(scalar_type == AstScalarLiteral::IntLit) {
+    stream << fmt("{}", bits);
+  }
+  else if(scalar_type == AstScalarLiteral::FloatLit) {
+    stream << fmt("{}", std::bit_cast<double>(bits));
+  }
+  else if(scalar_type == AstScalarLiteral::BoolLit) {
+    stream << (bits ? "true" : "false");
+  }
 
-  stream << '\n';
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
-}
+  stream
+    << Con::Reset
+    << " (Type="
+    << Con::WhiteFG;
 
-auto AstConstIf::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ConstIf");
-  if(alias.has_value())
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+  switch (scalar_type) {
+  case AstScalarLiteral::IntLit:
+    stream << "IntLit";
+    break;
+  case AstScalarLiteral::FloatLit:
+    stream << "FloatLit";
+    break;
+  case AstScalarLiteral::BoolLit:
+    stream << "BoolLit";
+    break;
+  case AstScalarLiteral::NullLit:
+    stream << "NullLit";
+    break;
+  case AstScalarLiteral::StringLit:
+    stream << "StringLit";
+    break;
+  case AstScalarLiteral::U8Lit:
+    stream << "U8Lit";
+    break;
+  default:
+    stream << "???";
+    break;
+  }
 
-  stream << '\n';
-  condition_->print(depth + 1, stream, "ConstIf.Condition");
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
+  stream << Con::Reset << ")\n";
 }
 
-auto AstConstElse::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ConstElse");
-  if(alias.has_value())
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream << '\n';
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
+static auto node_name_(const AstNode::Type kind) -> std::string_view {
+  using T = AstNode::Type;
+  switch(kind) {
+  case T::EntityRef:        return "EntityRef";
+  case T::Vardecl:          return "VarDecl";
+  case T::ProcDecl:         return "ProcDecl";
+  case T::EntityRefThunk:   return "EntityRefThunk";
+  case T::QualifiedRef:     return "TypeRef";
+  case T::ScalarLiteral:    return "ScalarLit";
+  case T::AggregateLiteral: return "AggregateLit";
+  case T::BinExpr:          return "BinExpr";
+  case T::UnaryExpr:        return "UnaryExpr";
+  case T::Branch:           return "Branch";
+  case T::If:               return "If";
+  case T::Else:             return "Else";
+  case T::Switch:           return "Switch";
+  case T::Case:             return "Case";
+  case T::Default:          return "Default";
+  case T::For:              return "For";
+  case T::While:            return "While";
+  case T::ConstBranch:      return "ConstBranch";
+  case T::ConstIf:          return "ConstIf";
+  case T::ConstElse:        return "ConstElse";
+  case T::ScopeBlock:       return "ScopeBlock";
+  case T::Namespace:        return "NamespaceBlock";
+  case T::Call:             return "Call";
+  case T::Break:            return "BreakStmt";
+  case T::Continue:         return "ContinueStmt";
+  case T::Return:           return "ReturnStmt";
+  case T::Defer:            return "Defer";
+  case T::DeferIf:          return "DeferIf";
+  case T::Subscript:        return "Subscript";
+  default:                  return "Node";
+  }
 }
 
-auto AstBreak::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "BreakStmt");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+///
+/// Dumps a tree of AstNodes, one line per node plus its
+/// children. Each hook prints the node's header and alias,
+/// then whatever is particular to that node type.
+class AstDumper final : public AstVisitor<AstDumper> {
+public:
+  AstDumper(OStream& stream, const uint32_t depth, const Maybe<std::string>& alias)
+    : stream_(stream), depth_(depth), alias_(alias) {}
+
+  auto pre_node(const AstNode& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_ << '\n';
+    return VisitAction::Continue;
+  }
+
+  auto pre_Branch(const AstBranch& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::WhiteFG
+      << "has_else = "
+      << (node.else_ ? "true" : "false")
       << Con::Reset;
-  stream << '\n';
-}
+    return VisitAction::Continue;
+  }
 
-auto AstContinue::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ContinueStmt");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+  auto pre_ConstBranch(const AstConstBranch& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::WhiteFG
+      << "has_else = "
+      << (node.else_ ? "true" : "false")
       << Con::Reset;
-  stream << '\n';
-}
+    return VisitAction::Continue;
+  }
 
-auto AstReturn::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ReturnStmt");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+  auto pre_Return(const AstReturn& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::WhiteFG
+      << "has_value = "
+      << (node.value_ ? "true\n" : "false\n")
       << Con::Reset;
+    return VisitAction::Continue;
+  }
 
-  stream
-    << Con::WhiteFG
-    << "has_value = "
-    << (value_ ? "true\n" : "false\n")
-    << Con::Reset;
+  auto pre_ProcDecl(const AstProcDecl& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    print_entity_id_(node.id_);
+    return VisitAction::Continue;
+  }
 
-  if(value_ != nullptr)
-    value_->print(depth + 1, stream, "Return.Value");
-}
+  auto pre_Namespace(const AstNamespace& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    print_entity_id_(node.id_);
+    return VisitAction::Continue;
+  }
 
-auto AstCall::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Call");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+  auto pre_Case(const AstCase& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::WhiteFG
+      << "is_fallthrough = "
+      << (node.is_fallthrough ? "True\n" : "False\n")
       << Con::Reset;
-
-  stream << '\n';
-  for(size_t i = 0; i < arguments_.size(); i++) {
-    arguments_.at(i)->print(depth + 1, stream, fmt("Call.Args.{}", i + 1));
+    return VisitAction::Continue;
   }
-  target_->print(depth + 1, stream, "Call.Target");
-}
 
-auto AstDefer::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Defer");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+  auto pre_Switch(const AstSwitch& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << "num_cases = "
+      << Con::BlueFG
+      << node.cases_.size()
+      << Con::Reset
+      << Endl;
+    return VisitAction::Continue;
+  }
 
-  stream << '\n';
-  call_->print(depth + 1, stream, "Defer.Target");
-}
+  auto pre_For(const AstFor& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_ << Con::WhiteFG;
+    if(node.init_)   stream_ << "Init ";
+    if(node.cond_)   stream_ << "Cond ";
+    if(node.update_) stream_ << "Update ";
+    stream_ << Con::Reset << '\n';
+    return VisitAction::Continue;
+  }
 
-auto AstDeferIf::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "DeferIf");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+  auto pre_While(const AstWhile& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::WhiteFG
+      << "is_dowhile = "
+      << (node.is_dowhile ? "True\n" : "False\n")
       << Con::Reset;
+    return VisitAction::Continue;
+  }
 
-  stream << '\n';
-  condition_->print(depth + 1, stream, "DeferIf.Condition");
-  call_->print(depth + 1, stream, "DeferIf.Target");
-}
+  auto pre_BinExpr(const AstBinExpr& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::BlueFG
+      << node.op_type_.name()
+      << Con::Reset
+      << '\n';
+    return VisitAction::Continue;
+  }
 
-auto AstVardecl::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "VarDecl");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+  auto pre_UnaryExpr(const AstUnaryExpr& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::BlueFG
+      << node.op_type_.name()
+      << Con::Reset
+      << Con::WhiteFG
+      << " is_postfix = "
+      << (node.is_postfix_ ? "True\n" : "False\n")
       << Con::Reset;
+    return VisitAction::Continue;
+  }
 
-  stream << '\n';
-  name_->print(depth + 1, stream, "VarDecl.Name");
-  vartype_->print(depth + 1, stream, "Vardecl.Type");
-}
-
-auto AstProcDecl::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ProcDecl");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+  auto pre_ScalarLiteral(const AstScalarLiteral& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    const uint64_t bits = node.scalar_type_ == AstScalarLiteral::FloatLit
+      ? std::bit_cast<uint64_t>(node.float_value_)
+      : node.int_value_;
+    print_scalar_(stream_, node.scalar_type_, node.value_, bits);
+    return VisitAction::Continue;
+  }
 
-  stream
-    << "EntityID="
-    << Con::BlueFG
-    << id_
-    << Con::Reset
-    << '\n';
+  auto pre_EntityRef(const AstEntityRef& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_
+      << Con::BlueFG
+      << "ID = "
+      << node.id_
+      << Con::Reset
+      << Endl;
+    return VisitAction::Continue;
+  }
 
-  for(size_t i = 0; i < arg_decls_.size(); i++)
-    arg_decls_.at(i)->print(depth + 1, stream, fmt("ProcDecl.Arg.{}", i + 1));
+  auto pre_EntityRefThunk(const AstEntityRefThunk& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    stream_ << Con::BlueFG;
+    stream_ << node.name_;
+    stream_ << Con::Reset << '\n';
+    return VisitAction::Continue;
+  }
 
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
-}
+  auto pre_QualifiedRef(const AstQualifiedRef& node, const AstVisitFrame& frame) -> VisitAction {
+    begin_(node, frame);
+    const auto formatted = node.descriptor_.format();
+    stream_ << formatted << '\n';
+    return VisitAction::Continue;
+  }
 
-auto AstCase::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Case");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+private:
+  auto begin_(const AstNode& node, const AstVisitFrame& frame) -> void {
+    print_header_(depth_ + frame.depth, stream_, node_name_(node.type_), node.file_, node.line_, node.pos_);
+    if(frame.parent != nullptr) {
+      print_field_alias_(stream_, frame.parent->type_, frame.field, frame.ordinal);
+    } else if(alias_.has_value()) {
+      print_alias_(stream_, *alias_);
+    }
+  }
 
-  stream
-    << Con::WhiteFG
-    << "is_fallthrough = "
-    << (is_fallthrough ? "True\n" : "False\n")
-    << Con::Reset;
+  auto print_entity_id_(const Entity::ID id) -> void {
+    stream_
+      << "EntityID="
+      << Con::BlueFG
+      << id
+      << Con::Reset
+      << '\n';
+  }
 
-  value_->print(depth + 1, stream, "Case.Value");
-  for(const auto& child : children_)
-    child->print(depth + 1, stream, Nothing);
-}
+  OStream& stream_;
+  uint32_t depth_;
+  const Maybe<std::string>& alias_;
+};
 
-auto AstDefault::print(
+auto AstNode::print(
   const uint32_t depth,
   OStream& stream,
   const Maybe<std::string> &alias ) const -> void
 {
-  print_(depth, stream, "Default");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream << '\n';
-  for(const auto& child : children_)
-    child->print(depth + 1, stream, Nothing);
+  AstDumper(stream, depth, alias).walk(this);
 }
 
-auto AstSwitch::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Switch");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream
-    << "num_cases = "
-    << Con::BlueFG
-    << cases_.size()
-    << Con::Reset
-    << Endl;
-
-  target_->print(depth + 1, stream, "Switch.Target");
-  dflt_->print(depth + 1, stream, "Switch.Default");
-
-  for(size_t i = 0; i < cases_.size(); i++)
-    cases_.at(i)->print(depth + 1, stream, fmt("Switch.Case.{}", i + 1));
+///
+/// The side tables FlatAst and AstImage store differently.
+/// Everything else the dumper reads has the same shape in both.
+static auto flat_string_(const FlatAst& ast, const FlatAst::Index i) -> std::string_view {
+  return ast.strings_[i];
 }
 
-auto AstScopeBlock::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ScopeBlock");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+static auto flat_string_(const AstImage& ast, const FlatAst::Index i) -> std::string_view {
+  return ast.string(i);
+}
 
-  stream << '\n';
-  for(const auto& child : children_)
-    child->print(depth + 1, stream, Nothing);
+static auto flat_thunk_(const FlatAst& ast, const FlatAst::Index i) -> std::string_view {
+  return ast.thunks_[i].name;
 }
 
-auto AstFor::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "For");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+static auto flat_thunk_(const AstImage& ast, const FlatAst::Index i) -> std::string_view {
+  return ast.thunk_name(i);
+}
 
-  stream << Con::WhiteFG;
-  if(init_) stream   << "Init ";
-  if(cond_) stream   << "Cond ";
-  if(update_) stream << "Update ";
-  stream << Con::Reset;
+static auto flat_qualifier_(const FlatAst& ast, const FlatAst::Index i) -> std::string {
+  return ast.qualifiers_[i].format();
+}
 
-  stream << '\n';
-  if(init_) init_->print(depth + 1, stream, "For.Init");
-  if(cond_) cond_->print(depth + 1, stream, "For.Cond");
-  if(update_) update_->print(depth + 1, stream, "For.Update");
+static auto flat_qualifier_(const AstImage& ast, const FlatAst::Index i) -> std::string {
+  return ast.qualifier(i).format();
 }
 
-auto AstWhile::print(
+///
+/// Everything a node prints after its alias, matching the
+/// corresponding AstNode::print(). Children are printed by
+/// the caller, since they follow in pre-order anyway.
+template<typename Ast>
+static auto dump_flat_node_(
+  const Ast& ast,
+  const FlatAst::Index i,
   const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
+  const uint32_t ordinal,
+  OStream& stream ) -> void
 {
-  print_(depth, stream, "While");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream
-    << Con::WhiteFG
-    << "is_dowhile = "
-    << (is_dowhile ? "True\n" : "False\n")
-    << Con::Reset;
+  using T = AstNode::Type;
+  const T kind = ast.kinds_[i];
+  print_header_(depth, stream, node_name_(kind), ast.files_[i], ast.lines_[i], ast.pos_[i]);
+  if(ast.parents_[i] != FlatAst::none_) {
+    print_field_alias_(stream, ast.kinds_[ ast.parents_[i] ], ast.fields_[i], ordinal);
+  }
 
-  cond_->print(depth + 1, stream, "While.Cond");
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
-}
+  /// Which fields are present, and how many nodes each holds.
+  uint32_t fields[4] = { 0, 0, 0, 0 };
+  for(auto c = ast.first_child_[i]; c != FlatAst::none_; c = ast.next_sibling_[c]) {
+    if(ast.fields_[c] < 4) ++fields[ ast.fields_[c] ];
+  }
 
-auto AstSubscript::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "Subscript");
-  if(alias.has_value()) 
+  switch(kind) {
+  case T::Branch:
+  case T::ConstBranch:
     stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+      << Con::WhiteFG
+      << "has_else = "
+      << (fields[1] ? "true" : "false")
       << Con::Reset;
-  
-  stream << '\n';
-  operand_->print(depth + 1, stream, "Subscript.Operand");
-  value_->print(depth + 1, stream, "Subscript.Value");
-}
-
-auto AstBinExpr::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "BinExpr");
-  if(alias.has_value()) 
+    break;
+  case T::Return:
     stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+      << Con::WhiteFG
+      << "has_value = "
+      << (fields[0] ? "true\n" : "false\n")
       << Con::Reset;
-  
-  const auto as_str = op_type_.to_string();
-  stream
-    << Con::BlueFG
-    << as_str
-    << Con::Reset
-    << '\n';
-
-  left_->print(depth + 1, stream, "Binexpr.Left");
-  right_->print(depth + 1, stream, "Binexpr.Right");
-}
-
-auto AstUnaryExpr::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "UnaryExpr");
-  if(alias.has_value()) 
+    break;
+  case T::ProcDecl:
+  case T::Namespace:
     stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+      << "EntityID="
+      << Con::BlueFG
+      << ast.payload_[i]
+      << Con::Reset
+      << '\n';
+    break;
+  case T::Case:
+    stream
+      << Con::WhiteFG
+      << "is_fallthrough = "
+      << (ast.payload_[i] ? "True\n" : "False\n")
       << Con::Reset;
-
-  const auto as_str = op_type_.to_string();
-
-  stream // -------------
-    << Con::BlueFG
-    << as_str
-    << Con::Reset
-    << Con::WhiteFG
-    << " is_postfix = "
-    << (is_postfix_ ? "True\n" : "False\n")
-    << Con::Reset;
-
-  operand_->print(depth + 1, stream, "UnaryExpr.Operand");
-}
-
-auto AstScalarLiteral::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "ScalarLit");
-  if(alias.has_value()) 
+    break;
+  case T::Switch:
     stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
+      << "num_cases = "
+      << Con::BlueFG
+      << fields[2]
+      << Con::Reset
+      << Endl;
+    break;
+  case T::For:
+    stream << Con::WhiteFG;
+    if(fields[0]) stream << "Init ";
+    if(fields[1]) stream << "Cond ";
+    if(fields[2]) stream << "Update ";
+    stream << Con::Reset << '\n';
+    break;
+  case T::While:
+    stream
+      << Con::WhiteFG
+      << "is_dowhile = "
+      << (ast.payload_[i] ? "True\n" : "False\n")
       << Con::Reset;
-
-  /// Btw we need to do this so it doesn't fuck the output.
-  auto get_ch = [](const char ch) -> Maybe<std::string_view> {
-    switch (ch) {
-    case '\v': return "\\v";
-    case '\n': return "\\n";
-    case '\t': return "\\t";
-    case '\b': return "\\b";
-    case '\a': return "\\a";
-    default: return Nothing;
-    }
-  };
-
-  stream << Con::BlueFG;
-  if(scalar_type_ == StringLit || scalar_type_ == U8Lit) {
-    for(const char ch : value_) {
-      auto val = get_ch(ch);
-      if(val) { stream << *val;}
-      else    { stream << ch;  }
-    }
-  }
-  else {
-    stream << value_;
-  }
-
-  stream
-    << Con::Reset
-    << " (Type="
-    << Con::WhiteFG;
-
-  switch (scalar_type_) {
-  case IntLit:
-    stream << "IntLit";
     break;
-  case FloatLit:
-    stream << "FloatLit";
+  case T::BinExpr: {
+    const auto& op = ast.ops_[ ast.payload_[i] ];
+    stream
+      << Con::BlueFG
+      << op.type.name()
+      << Con::Reset
+      << '\n';
     break;
-  case BoolLit:
-    stream << "BoolLit";
+  }
+  case T::UnaryExpr: {
+    const auto& op = ast.ops_[ ast.payload_[i] ];
+    stream
+      << Con::BlueFG
+      << op.type.name()
+      << Con::Reset
+      << Con::WhiteFG
+      << " is_postfix = "
+      << (op.is_postfix ? "True\n" : "False\n")
+      << Con::Reset;
     break;
-  case NullLit:
-    stream << "NullLit";
+  }
+  case T::ScalarLiteral: {
+    const auto& scalar = ast.scalars_[ ast.payload_[i] ];
+    const std::string_view value = scalar.string != FlatAst::none_
+      ? flat_string_(ast, scalar.string)
+      : std::string_view();
+    print_scalar_(stream, scalar.type, value, scalar.bits);
     break;
-  case StringLit:
-    stream << "StringLit";
+  }
+  case T::EntityRef:
+    stream
+      << Con::BlueFG
+      << "ID = "
+      << ast.payload_[i]
+      << Con::Reset
+      << Endl;
     break;
-  case U8Lit:
-    stream << "U8Lit";
+  case T::EntityRefThunk:
+    stream << Con::BlueFG;
+    stream << flat_thunk_(ast, ast.payload_[i]);
+    stream << Con::Reset << '\n';
     break;
+  case T::QualifiedRef: {
+    const auto formatted = flat_qualifier_(ast, ast.payload_[i]);
+    stream << formatted << '\n';
+    break;
+  }
   default:
-    stream << "???";
+    stream << '\n';
     break;
   }
-
-  stream << Con::Reset << ")\n";
 }
 
-auto AstAggregateLiteral::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "AggregateLit");
-  if(alias.has_value())
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream << '\n';
-  for(const auto& child : children_)
-    child->print(depth + 1, stream, Nothing);
-}
-
-auto AstEntityRef::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "EntityRef");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+///
+/// Walks a FlatAst or an AstImage in pre-order, working out
+/// each node's depth and field ordinal from the parent links.
+template<typename Ast>
+static auto dump_flat_(const Ast& ast, OStream& stream) -> void {
+  struct Frame {
+    FlatAst::Index node;
+    FlatAst::Field field;
+    uint32_t count;   /// Children of this node seen so far in `field`.
+  };
 
-  stream
-    << Con::BlueFG
-    << "ID = "
-    << id_
-    << Con::Reset
-    << Endl;
-}
+  /// Nodes are in pre-order, so the ancestors of node i
+  /// are always a prefix of the ancestors of node i - 1.
+  std::vector<Frame> ancestors;
+  for(FlatAst::Index i = 0; i < ast.size(); i++) {
+    const FlatAst::Index parent = ast.parents_[i];
+    while(!ancestors.empty() && ancestors.back().node != parent) {
+      ancestors.pop_back();
+    }
 
-auto AstEntityRefThunk::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "EntityRefThunk");
-  if(alias.has_value())
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
+    uint32_t ordinal = 1;
+    if(!ancestors.empty()) {
+      auto& frame = ancestors.back();
+      frame.count = frame.count != 0 && frame.field == ast.fields_[i] ? frame.count + 1 : 1;
+      frame.field = ast.fields_[i];
+      ordinal     = frame.count;
+    }
 
-  stream << Con::BlueFG;
-  stream << this->name_;
-  stream << Con::Reset << '\n';
+    dump_flat_node_(ast, i, static_cast<uint32_t>(ancestors.size()), ordinal, stream);
+    ancestors.push_back({ i, 0, 0 });
+  }
 }
 
-auto AstQualifiedRef::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "TypeRef");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  const auto formatted = descriptor_.format();
-  stream << formatted << '\n';
+auto FlatAst::dump(OStream& stream) const -> void {
+  dump_flat_(*this, stream);
 }
 
-auto AstNamespace::print(
-  const uint32_t depth,
-  OStream& stream,
-  const Maybe<std::string> &alias ) const -> void
-{
-  print_(depth, stream, "NamespaceBlock");
-  if(alias.has_value()) 
-    stream
-      << Con::GreenFG
-      << fmt("\"{}\" ", *alias)
-      << Con::Reset;
-
-  stream
-    << "EntityID="
-    << Con::BlueFG
-    << id_
-    << Con::Reset;
-
-  stream << '\n';
-  for(const auto& child : body_)
-    child->print(depth + 1, stream, Nothing);
+auto AstImage::dump(OStream& stream) const -> void {
+  dump_flat_(*this, stream);
 }
 
 END_NAMESPACE(rl);
@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <n19/Core/Panic.hpp>
+#include <algorithm>
+#include <bit>
+BEGIN_NAMESPACE(rl);
+
+struct PendingNode_ {
+  const AstNode* node;
+  FlatAst::Index parent;
+  FlatAst::Field field;
+};
+
+///
+/// Fills in payload_ for node `i`, adding to
+/// whichever side table its kind uses.
+static auto store_payload_(FlatAst& ast, const AstNode* node, const FlatAst::Index i) -> void {
+  using T = AstNode::Type;
+  uint32_t& payload = ast.payload_[i];
+
+  switch(node->type_) {
+  case T::BinExpr: {
+    const auto* n = static_cast<const AstBinExpr*>(node);
+    payload = static_cast<uint32_t>(ast.ops_.size());
+    ast.ops_.push_back({ n->op_type_, n->op_cat_, false });
+    break;
+  }
+  case T::UnaryExpr: {
+    const auto* n = static_cast<const AstUnaryExpr*>(node);
+    payload = static_cast<uint32_t>(ast.ops_.size());
+    ast.ops_.push_back({ n->op_type_, n->op_cat_, n->is_postfix_ });
+    break;
+  }
+  case T::ScalarLiteral: {
+    const auto* n = static_cast<const AstScalarLiteral*>(node);
+    FlatAst::Scalar scalar;
+    scalar.type = n->scalar_type_;
+    scalar.bits = n->scalar_type_ == AstScalarLiteral::FloatLit
+      ? std::bit_cast<uint64_t>(n->float_value_)
+      : n->int_value_;
+    if(n->scalar_type_ == AstScalarLiteral::StringLit || n->scalar_type_ == AstScalarLiteral::U8Lit) {
+      scalar.string = static_cast<FlatAst::Index>(ast.strings_.size());
+      ast.strings_.push_back(n->value_);
+    }
+
+    payload = static_cast<uint32_t>(ast.scalars_.size());
+    ast.scalars_.push_back(scalar);
+    break;
+  }
+  case T::EntityRefThunk: {
+    const auto* n = static_cast<const AstEntityRefThunk*>(node);
+    payload = static_cast<uint32_t>(ast.thunks_.size());
+    ast.thunks_.push_back({ n->name_, n->name_id_ });
+    break;
+  }
+  case T::QualifiedRef:
+    payload = static_cast<uint32_t>(ast.qualifiers_.size());
+    ast.qualifiers_.push_back(static_cast<const AstQualifiedRef*>(node)->descriptor_);
+    break;
+  case T::EntityRef: payload = static_cast<const AstEntityRef*>(node)->id_;    break;
+  case T::ProcDecl:  payload = static_cast<const AstProcDecl*>(node)->id_;     break;
+  case T::Namespace: payload = static_cast<const AstNamespace*>(node)->id_;    break;
+  case T::Case:      payload = static_cast<const AstCase*>(node)->is_fallthrough; break;
+  case T::While:     payload = static_cast<const AstWhile*>(node)->is_dowhile;    break;
+  default:           payload = 0; break;
+  }
+}
+
+auto FlatAst::from_tree(const std::span<const AstNode::Ptr<>> roots) -> FlatAst {
+  FlatAst ast;
+  std::vector<PendingNode_> stack;
+  std::vector<Index> last_child;      /// Per node, while it's being filled in.
+  Index last_root = none_;
+
+  for(auto it = roots.rbegin(); it != roots.rend(); ++it) {
+    if(*it != nullptr) stack.push_back({ *it, none_, 0 });
+  }
+
+  while(!stack.empty()) {
+    const PendingNode_ curr = stack.back();
+    stack.pop_back();
+
+    const auto i = static_cast<Index>(ast.kinds_.size());
+    ASSERT(i != none_, "FlatAst: too many nodes.");
+    ast.kinds_.push_back(curr.node->type_);
+    ast.fields_.push_back(curr.field);
+    ast.pos_.emplace_back(curr.node->pos_);
+    ast.lines_.push_back(curr.node->line_);
+    ast.files_.push_back(curr.node->file_);
+    ast.parents_.push_back(curr.parent);
+    ast.first_child_.push_back(none_);
+    ast.next_sibling_.push_back(none_);
+    ast.payload_.push_back(0);
+    last_child.push_back(none_);
+    store_payload_(ast, curr.node, i);
+
+    /// Link to the previous sibling, or become the first child.
+    Index& prev = curr.parent == none_ ? last_root : last_child[curr.parent];
+    if(prev != none_) {
+      ast.next_sibling_[prev] = i;
+    } else if(curr.parent != none_) {
+      ast.first_child_[curr.parent] = i;
+    }
+    prev = i;
+
+    /// Pushed in reverse, so they come off the stack in order.
+    const size_t first = stack.size();
+    for_each_child(*curr.node, [&](const AstNode* child, const Field field) {
+      stack.push_back({ child, i, field });
+    });
+    std::reverse(stack.begin() + static_cast<ptrdiff_t>(first), stack.end());
+  }
+
+  return ast;
+}
+
+auto FlatAst::field_name(const AstNode::Type parent, const Field field) -> FieldName {
+  using T = AstNode::Type;
+  switch(parent) {
+  case T::BinExpr:     return { field == 0 ? "Binexpr.Left" : "Binexpr.Right" };
+  case T::UnaryExpr:   return { "UnaryExpr.Operand" };
+  case T::If:          return { field == 0 ? "If.Condition" : "" };
+  case T::ConstIf:     return { field == 0 ? "ConstIf.Condition" : "" };
+  case T::Branch:      return { field == 0 ? "Branch.If" : "Branch.Else" };
+  case T::ConstBranch: return { field == 0 ? "ConstBranch.If" : "ConstBranch.Else" };
+  case T::Case:        return { field == 0 ? "Case.Value" : "" };
+  case T::Call:        return { field == 0 ? "Call.Args" : "Call.Target", field == 0 };
+  case T::Defer:       return { "Defer.Target" };
+  case T::DeferIf:     return { field == 0 ? "DeferIf.Condition" : "DeferIf.Target" };
+  case T::Vardecl:     return { field == 0 ? "VarDecl.Name" : "Vardecl.Type" };
+  case T::ProcDecl:    return { field == 0 ? "ProcDecl.Arg" : "", field == 0 };
+  case T::Return:      return { "Return.Value" };
+  case T::While:       return { field == 0 ? "While.Cond" : "" };
+  case T::Subscript:   return { field == 0 ? "Subscript.Operand" : "Subscript.Value" };
+  case T::Switch: {
+    constexpr std::string_view names[] = { "Switch.Target", "Switch.Default", "Switch.Case" };
+    return { names[field], field == 2 };
+  }
+  case T::For: {
+    constexpr std::string_view names[] = { "For.Init", "For.Cond", "For.Update", "For.Body" };
+    return { names[field] };
+  }
+  default: return {};
+  }
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,104 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Core/Stream.hpp>
+#include <n19/Core/StringPool.hpp>
+#include <n19/Frontend/AST/ASTNodes.hpp>
+#include <n19/Frontend/AST/AstVisitor.hpp>
+#include <n19/Frontend/Common/SourcePos.hpp>
+#include <n19/Frontend/Entities/Entity.hpp>
+#include <n19/Frontend/Lexer/Token.hpp>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+BEGIN_NAMESPACE(rl);
+
+///
+/// The same AST as the AstNode hierarchy, stored as parallel arrays
+/// indexed by 32-bit node handles. Nodes are laid out in pre-order,
+/// so a full walk is a linear scan. Children are linked through
+/// first_child_ / next_sibling_, and top-level nodes are siblings
+/// of each other starting at index 0.
+///
+/// Kind-specific data lives in side tables. What payload_ holds
+/// depends on the node's kind:
+///   BinExpr, UnaryExpr      -> index into ops_
+///   ScalarLiteral           -> index into scalars_
+///   EntityRefThunk          -> index into thunks_
+///   QualifiedRef            -> index into qualifiers_
+///   EntityRef, ProcDecl,
+///   Namespace               -> the Entity::ID itself
+///   Case, While             -> is_fallthrough / is_dowhile
+///   anything else           -> 0
+class FlatAst {
+public:
+  using Index = uint32_t;
+  using Field = AstField;
+  static constexpr Index none_ = std::numeric_limits<Index>::max();
+
+  struct Op {
+    TokenType type     = TokenType::None;
+    TokenCategory cat  = TokenCategory::NonCategorical;
+    bool is_postfix    = false;
+  };
+
+  struct Scalar {
+    uint64_t bits      = 0;      /// int_value_, or float_value_'s bits.
+    Index string       = none_;  /// Into strings_, StringLit and U8Lit only.
+    uint8_t type       = 0;      /// AstScalarLiteral::scalar_type_
+  };
+
+  struct Thunk {
+    std::string_view name;
+    StringPool::Index name_id{};
+  };
+
+  /// How a child is labelled when dumped, from its parent's
+  /// kind and the field it was taken from. Empty for plain
+  /// body members. Numbered fields get ".1", ".2"... appended.
+  struct FieldName {
+    std::string_view alias;
+    bool numbered = false;
+  };
+
+  NODISCARD_ static auto from_tree(std::span<const AstNode::Ptr<>> roots) -> FlatAst;
+  NODISCARD_ static auto field_name(AstNode::Type parent, Field field) -> FieldName;
+
+  /// Writes the same text AstNode::print() does. Implemented in DumpAST.cpp.
+  auto dump(OStream& stream) const -> void;
+
+  NODISCARD_ auto size()  const -> size_t { return kinds_.size(); }
+  NODISCARD_ auto empty() const -> bool   { return kinds_.empty(); }
+
+  // Node columns //
+  //////////////////////////////////////////
+  std::vector<AstNode::Type> kinds_;
+  std::vector<Field> fields_;          /// Which field of the parent this came from.
+  std::vector<PackedPos> pos_;
+  std::vector<uint32_t> lines_;
+  std::vector<InputFile::ID> files_;
+  std::vector<Index> parents_;
+  std::vector<Index> first_child_;
+  std::vector<Index> next_sibling_;
+  std::vector<uint32_t> payload_;
+
+  // Side tables //
+  //////////////////////////////////////////
+  std::vector<Op> ops_;
+  std::vector<Scalar> scalars_;
+  std::vector<std::string> strings_;
+  std::vector<Thunk> thunks_;
+  std::vector<EntityQualifier> qualifiers_;
+  //////////////////////////////////////////
+};
+
+END_NAMESPACE(rl);
@@ -6,34 +6,106 @@
 #include <n19/Frontend/Common/CompilationCycle.hpp>
 #include <n19/Frontend/FrontendContext.hpp>
 #include <n19/Frontend/Parser/Parser.hpp>
+#include <n19/Frontend/AST/AstCache.hpp>
+#include <n19/Frontend/AST/FlatAst.hpp>
+#include <n19/Frontend/Lexer/TokenCache.hpp>
+#include <n19/System/MappedFile.hpp>
+#include <n19/System/Time.hpp>
 #include <n19/Core/Console.hpp>
+#include <n19/Core/Fmt.hpp>
 #include <n19/Core/Panic.hpp>
 #include <n19/Core/Defer.hpp>
 #include <n19/Core/Platform.hpp>
+#include <n19/Core/ThreadPool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <vector>
 BEGIN_NAMESPACE(rl);
 
 using namespace n19;
 
-bool begin_global_compilation_cycles() {
-  [[maybe_unused]] auto& inputs  = Context::the().inputs_;
-  [[maybe_unused]] auto& outputs = Context::the().outputs_;
-  
-  ASSERT(inputs.size() == outputs.size());
-  ASSERT(!outputs.empty() && !inputs.empty());
-  
-  /// Note: only handle a single input/output file for now.
-  /// Ignore any additional passed ones. Parallel compilation
-  /// is an undecided issue.
-
-  [[maybe_unused]] InputFile& in  = inputs[0];
-  [[maybe_unused]] OutputFile& out = outputs[0];
-
-  ASSERT(in.kind == InputFileKind::CoreUnit);
-  in.state = InputFileState::Finished;
+///
+/// What compiling one input left behind. Filled in on a
+/// worker thread, printed on the main one in input order.
+struct CycleOutput_ {
+  StringOStream out;
+  StringOStream err;
+  std::chrono::nanoseconds cpu{};
+  bool ok = false;
+};
+
+///
+/// The on-disk caches, opened once per run and
+/// shared by every input, whichever thread compiles it.
+struct CycleCaches_ {
+  Maybe<TokenCache> tokens;
+  Maybe<AstCache> trees;
+};
+
+///
+/// An eager lexer over `ref`, through the token cache if there
+/// is one. A mapping of the file that was already made is reused.
+static auto lex_input_(
+  sys::File& ref,
+  Maybe<sys::MappedFile>& mapped,
+  Maybe<TokenCache>& cache ) -> Result<std::shared_ptr<Lexer>>
+{
+  if(mapped.has_value()) {
+    return cache.has_value()
+      ? cache->lex(ref, std::move(*mapped))
+      : Lexer::create_shared(ref, std::move(*mapped));
+  }
+
+  return cache.has_value()
+    ? cache->lex(ref)
+    : Lexer::create_shared(ref);
+}
 
+///
+/// A cache directory that can't be used only costs a warning. Nothing
+/// but --dump-ast reads the tree yet, so that's the only time the AST
+/// cache is worth opening.
+static auto open_caches_(OStream& err) -> CycleCaches_ {
+  CycleCaches_ caches;
+  const auto warn = [&err](const char* what, const Error& error) {
+    err
+      << Con::YellowFG
+      << "Warning:"
+      << Con::Reset
+      << " " << what << " cache disabled. "
+      << error.msg
+      << "\n";
+  };
+
+  if(!Context::the().token_cache_.empty()) {
+    auto opened = TokenCache::open(Context::the().token_cache_);
+    if(opened) caches.tokens.emplace(opened.release_value());
+    else warn("Token", opened.error());
+  }
+
+  if(!Context::the().ast_cache_.empty() && (Context::the().flags_ & Context::DumpAST)) {
+    auto opened = AstCache::open(Context::the().ast_cache_);
+    if(opened) caches.trees.emplace(opened.release_value());
+    else warn("AST", opened.error());
+  }
+
+  return caches;
+}
+
+///
+/// Lexes and parses one input. Everything it prints goes to `out`
+/// and `err`, and everything it builds (lexer, entity table, AST)
+/// is its own, so several of these can run at once.
+static auto compile_input_(
+  const InputFile& in,
+  CycleCaches_& caches,
+  OStream& out,
+  OStream& err ) -> bool
+{
   auto ref = sys::File::open(in.name, false, sys::File::Read);
   if (!ref.has_value()) {
-    errs()
+    err
       << Con::RedFG
       << "Error:"
       << Con::Reset
@@ -49,9 +121,51 @@ bool begin_global_compilation_cycles() {
     ref->close();
   });
 
-  auto lxr = Lexer::create_shared(*ref);
+  /// A source too large to map whole is streamed. Neither
+  /// cache applies to it, both need the whole file resident.
+  const auto fsize     = ref->size();
+  const bool streaming = fsize.has_value() && *fsize >= Lexer::max_resident;
+
+  /// With --ast-cache, dumping the AST of an unchanged source
+  /// skips lexing and parsing, and the tree is printed straight
+  /// off the mapped entry. The source is mapped once to hash it,
+  /// and on a miss the lexer takes that same mapping over.
+  const auto flags = Context::the().flags_;
+  Maybe<sys::MappedFile> mapped;
+  Murmur3_128 source_hash{};
+  bool hashed = false;
+  if(!streaming && caches.trees.has_value()) {
+    auto mapping = sys::MappedFile::map(*ref, Lexer::padding);
+    if(mapping) {
+      source_hash = AstCache::hash(mapping->chars());
+      mapped.emplace(mapping.release_value());
+      hashed = true;
+    }
+  }
+
+  const bool tree_only = !(flags & (Context::DumpToks | Context::DumpToksBin | Context::DumpEnts));
+  if(hashed && tree_only) {
+    auto image = caches.trees->load(source_hash, in.id);
+    if(image.has_value()) {
+      if(!image->empty()) {
+        out
+          << Con::Bold
+          << "---- Abstract Syntax Tree\n"
+          << Con::Reset;
+        image->dump(out);
+        out << "\n";
+      }
+
+      return true;
+    }
+  }
+
+  auto lxr = streaming
+    ? Lexer::create_shared(*ref, LexMode::Streaming)
+    : lex_input_(*ref, mapped, caches.tokens);
+
   if (!lxr) {
-    errs()
+    err
       << Con::RedFG
       << "Error:"
       << Con::Reset
@@ -63,16 +177,13 @@ bool begin_global_compilation_cycles() {
     return false;
   }
 
-  if(Context::the().flags_ & Context::DumpCtx) {
-    outs()
-      << Con::Bold
-      << "---- Frontend Context\n"
-      << Con::Reset;
-    Context::the().dump(outs());
+  if(Context::the().flags_ & Context::DumpToksBin) {
+    (*lxr)->dump_binary(out);
+    return true;
   }
 
   if(Context::the().flags_ & Context::DumpToks) {
-    (*lxr)->dump(outs());
+    (*lxr)->dump(out);
     return true;
   }
 
@@ -83,36 +194,179 @@ bool begin_global_compilation_cycles() {
   EntityTable tbl(std::filesystem::absolute(ref->path()).string());
 #endif
 
-  ParseContext ctx(in.id, errs(), errors, *(*lxr), tbl);
+  ParseContext ctx(in.id, err, errors, *(*lxr), tbl);
+
+  /// Only with --skim-bodies: a skimmed body's syntax errors are
+  /// never seen, and neither is anything it would have declared.
+  /// The AST dump needs every body, so it overrides the flag.
+  ctx.skim_bodies = (flags & Context::SkimBodies) && !(flags & Context::DumpAST);
 
-  if (!parse(ctx)) 
+  const bool parsed = parse(ctx);
+  if((Context::the().flags_ & Context::Verbose) && ctx.includes.stats().files != 0) {
+    const auto stats = ctx.includes.stats();
+    out
+      << Con::Bold
+      << "Include prefetch: "
+      << Con::Reset
+      << fmt("{} file(s), {} ready on arrival, {:.2f}ms saved.\n",
+        stats.files, stats.ready, std::chrono::duration<double, std::milli>(stats.saved).count());
+  }
+
+  if (!parsed)
     return false;
 
-  if ((Context::the().flags_ & Context::DumpAST) && !ctx.toplevel_decls_.empty()) {
-    outs()
+  if (Context::the().flags_ & Context::Verbose) {
+    out
       << Con::Bold
-      << "---- Abstract Syntax Tree\n"
+      << "---- AST Arena\n"
       << Con::Reset;
-    for (const auto& decl : ctx.toplevel_decls_) {
-      decl->print(0, outs(), Nothing);
+    ctx.arena.dump(out);
+  }
+
+  if (Context::the().flags_ & Context::DumpAST) {
+    const auto flat = FlatAst::from_tree(ctx.toplevel_decls_);
+    if (!flat.empty()) {
+      out
+        << Con::Bold
+        << "---- Abstract Syntax Tree\n"
+        << Con::Reset;
+      flat.dump(out);
+      out << "\n";
+    }
+
+    /// A tree that pulled in @include'd files depends on
+    /// more than this file's bytes, so it can't be keyed by them.
+    if (hashed && !ctx.saw_include) {
+      (void)caches.trees->store(source_hash, in.id, flat);
     }
-    outs() << "\n";
   }
-  
+
   if (Context::the().flags_ & Context::DumpEnts) {
-    outs()
+    out
       << Con::Bold
       << "---- Pre Check Phase Entity Table\n"
       << Con::Reset;
-    ctx.entities.dump(outs());
-    ctx.entities.dump_structures(outs());
+    ctx.entities.dump(out);
+    ctx.entities.dump_structures(out);
   }
 
-  /// TODO: once the rest of the compiler is finished, 
-  /// handle other compilation tasks like checking, codegen, 
+  /// TODO: once the rest of the compiler is finished,
+  /// handle other compilation tasks like checking, codegen,
   /// etc here.
 
   return true;
 }
 
+bool begin_global_compilation_cycles() {
+  return begin_global_compilation_cycles(outs(), errs());
+}
+
+bool begin_global_compilation_cycles(OStream& out, OStream& err) {
+  auto& ctx_inputs = Context::the().inputs_;
+  auto& outputs    = Context::the().outputs_;
+
+  ASSERT(ctx_inputs.size() == outputs.size());
+  ASSERT(!outputs.empty() && !ctx_inputs.empty());
+
+  for(InputFile& in : ctx_inputs) {
+    ASSERT(in.kind == InputFileKind::CoreUnit);
+    in.state = InputFileState::Finished;
+  }
+
+  /// Workers append @include'd files to Context::inputs_
+  /// through add_include(), which can reallocate it, so
+  /// the cycles run off a copy taken before any start.
+  const std::vector<InputFile> inputs = ctx_inputs;
+
+  if(Context::the().flags_ & Context::DumpCtx) {
+    out
+      << Con::Bold
+      << "---- Frontend Context\n"
+      << Con::Reset;
+    Context::the().dump(out);
+  }
+
+  const size_t requested = Context::the().jobs_ != 0
+    ? Context::the().jobs_
+    : ThreadPool::hardware_threads();
+  const size_t jobs = std::min(requested, inputs.size());
+
+  CycleCaches_ caches = open_caches_(err);
+  const auto wall_begin = std::chrono::steady_clock::now();
+  std::chrono::nanoseconds cpu{};
+  bool all_ok = true;
+
+  if(jobs <= 1) {
+    /// Nothing to overlap, so print as we go.
+    for(const InputFile& in : inputs) {
+      const auto cpu_begin = sys::thread_cpu_time();
+      all_ok &= compile_input_(in, caches, out, err);
+      cpu += sys::thread_cpu_time() - cpu_begin;
+    }
+  } else {
+    std::vector<CycleOutput_> results(inputs.size());
+    std::vector<std::promise<void>> done(inputs.size());
+    std::vector<std::future<void>> ready;
+    ready.reserve(inputs.size());
+    for(auto& promise : done) ready.emplace_back(promise.get_future());
+
+    ThreadPool pool(jobs);
+    for(size_t i = 0; i < inputs.size(); i++) {
+      pool.submit([&, i] {
+        CycleOutput_& result = results[i];
+        const auto cpu_begin = sys::thread_cpu_time();
+        result.ok  = compile_input_(inputs[i], caches, result.out, result.err);
+        result.cpu = sys::thread_cpu_time() - cpu_begin;
+        done[i].set_value();
+      });
+    }
+
+    /// Diagnostics come out in input order, each
+    /// file's as soon as every file before it is done.
+    for(size_t i = 0; i < inputs.size(); i++) {
+      ready[i].wait();
+      CycleOutput_& result = results[i];
+      out << result.out.str();
+      err << result.err.str();
+      cpu    += result.cpu;
+      all_ok &= result.ok;
+
+      result.out.clear();
+      result.err.clear();
+    }
+
+    pool.wait();
+  }
+
+  if(Context::the().flags_ & Context::Verbose) {
+    const auto wall = std::chrono::steady_clock::now() - wall_begin;
+    const auto ms   = [](const auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+    out
+      << Con::Bold
+      << "---- Compilation\n"
+      << Con::Reset
+      << fmt("{} input(s) on {} thread(s): {:.2f}ms wall, {:.2f}ms cpu\n",
+        inputs.size(), std::max<size_t>(jobs, 1), ms(wall), ms(cpu));
+
+    if(caches.tokens.has_value()) {
+      const auto stats = caches.tokens->stats();
+      out
+        << Con::Bold
+        << "Token cache: "
+        << Con::Reset
+        << fmt("{} hit(s), {} miss(es).\n", stats.hits, stats.misses);
+    }
+    if(caches.trees.has_value()) {
+      const auto stats = caches.trees->stats();
+      out
+        << Con::Bold
+        << "AST cache: "
+        << Con::Reset
+        << fmt("{} hit(s), {} miss(es).\n", stats.hits, stats.misses);
+    }
+  }
+
+  return all_ok;
+}
+
 END_NAMESPACE(rl);
@@ -6,8 +6,13 @@
 #pragma once
 
 #include <n19/Core/Common.hpp>
+#include <n19/Core/Stream.hpp>
 BEGIN_NAMESPACE(rl);
 
 auto begin_global_compilation_cycles() -> bool;
 
+/// The same, with everything that would go to outs() and errs()
+/// written to `out` and `err` instead, in input order.
+auto begin_global_compilation_cycles(n19::OStream& out, n19::OStream& err) -> bool;
+
 END_NAMESPACE(rl);
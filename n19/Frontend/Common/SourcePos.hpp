@@ -0,0 +1,55 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <cstdint>
+BEGIN_NAMESPACE(rl);
+
+///
+/// An absolute byte offset into an input file. Always 64 bits wide,
+/// so tokens, AST nodes and entities agree on positions even past
+/// 4 GiB (see LexMode::Streaming). Paired with an InputFile::ID
+/// and a line number wherever a full location is needed.
+using SourcePos = uint64_t;
+
+///
+/// A SourcePos squeezed into 48 bits and 2-byte alignment, so it
+/// can share a word with a 16-bit field (see Token). Converts to
+/// and from SourcePos implicitly. 48 bits still covers 256 TiB.
+class PackedPos {
+public:
+  constexpr static SourcePos max = (SourcePos{1} << 48) - 1;
+
+  constexpr PackedPos(const SourcePos pos = 0)
+    : words_{ static_cast<uint16_t>(pos),
+              static_cast<uint16_t>(pos >> 16),
+              static_cast<uint16_t>(pos >> 32) } {}
+
+  constexpr operator SourcePos() const {
+    return SourcePos{words_[0]}
+      | SourcePos{words_[1]} << 16
+      | SourcePos{words_[2]} << 32;
+  }
+
+  constexpr auto operator+=(const SourcePos other) -> PackedPos& {
+    return *this = PackedPos(SourcePos(*this) + other);
+  }
+private:
+  uint16_t words_[3];
+};
+
+static_assert(sizeof(PackedPos) == 6 && alignof(PackedPos) == 2);
+
+///
+/// A SourcePos resolved against a line index. Both fields are
+/// 1-based, and the column counts bytes rather than characters.
+struct LineCol {
+  uint32_t line   = 1;
+  uint32_t column = 1;
+};
+
+END_NAMESPACE(rl);
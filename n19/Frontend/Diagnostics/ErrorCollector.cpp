@@ -19,19 +19,21 @@ BEGIN_NAMESPACE(rl);
 auto ErrorCollector::store_error(
   const std::string& msg,
   const sys::String& file_name,
-  const size_t pos,
+  const SourcePos pos,
   const uint32_t line ) -> ErrorCollector&
 {
   ASSERT(line);
-  ++error_count_;
-  errs_[file_name].emplace_back( msg, pos, line, false );
+  if(++error_count_ <= N19_MAX_ERRORS) {
+    errs_[file_name].emplace_back( msg, pos, line, false );
+  }
+
   return *this;
 }
 
 auto ErrorCollector::store_warning(
   const std::string& msg,
   const sys::String& file_name,
-  const size_t pos,
+  const SourcePos pos,
   const uint32_t line ) -> ErrorCollector&
 {
   ASSERT(line);
@@ -45,10 +47,10 @@ auto ErrorCollector::store_error_or_warning(
   const ErrorLocation& err ) -> ErrorCollector&
 {
   ASSERT(err.line);
-  if(!err.is_warning) {
-    ++error_count_;
-  } else {
+  if(err.is_warning) {
     ++warning_count_;
+  } else if(++error_count_ > N19_MAX_ERRORS) {
+    return *this;
   }
 
   errs_[file_name].emplace_back(err);
@@ -61,15 +63,7 @@ auto ErrorCollector::display_error(
   OStream& stream,
   const bool is_warn ) -> void
 {
-  const auto current = lxr.current();
-  display_error(
-    msg,             /// forward message
-    lxr.file_name_,  ///
-    lxr.src_,        ///
-    stream,          /// Forward provided output stream.
-    current.pos_,    /// assume current token's position.
-    current.line_,   /// assume current token's line.
-    is_warn);        ///
+  display_error(msg, lxr, lxr.current(), stream, is_warn);
 }
 
 auto ErrorCollector::display_error(
@@ -79,21 +73,24 @@ auto ErrorCollector::display_error(
   OStream& stream,
   const bool is_warn ) -> void
 {
-  display_error(
-    msg,             /// forward message
-    lxr.file_name_,  ///
-    lxr.src_,        ///
-    stream,          /// Forward provided output stream.
-    tok.pos_,        /// error on passed token's position.
-    tok.line_,       /// error on passed token's line #.
-    is_warn);        ///
+  /// The lexer already knows where every line starts,
+  /// so there's no need to go looking for it.
+  const LineCol where = lxr.line_col(tok.pos_);
+  display_line_(
+    msg,
+    lxr.file_name_,
+    lxr.line_span(where.line),
+    stream,
+    where.column - 1,
+    where.line,
+    is_warn);
 }
 
 auto ErrorCollector::display_error(
   const std::string& msg,
   sys::File& file,
   OStream& stream,
-  const size_t pos,
+  const SourcePos pos,
   const uint32_t line,
   const bool is_warn ) -> void
 {
@@ -117,59 +114,61 @@ auto ErrorCollector::display_error(
 auto ErrorCollector::display_error(
   const std::string& msg,
   const sys::String& fname,
-  const std::vector<char8_t>& buff,
+  const std::span<const char8_t> buff,
   OStream& stream,
-  size_t pos,
+  SourcePos pos,
   const uint32_t line,
   const bool is_warn ) -> void
 {
   ASSERT(!buff.empty());
-  std::string before;        /// The bytes that appear before "pos"
-  std::string after;         /// The byte at "pos", and the ones after it.
-  std::string filler;        /// The squiggly lines and pointy arrow.
-  std::string spaces;        /// The spaces to the left of the message.
-
   if(pos >= buff.size()) {   /// Sanity check the position.
     pos = buff.size() - 1;   ///
   }
 
-  Maybe<char> ch = '\0';
-  auto access = [&buff](size_t index) -> Maybe<char> {
-    if(index < buff.size()) return buff[index];
-    return Nothing;
-  };
-
-  for(size_t i = pos - 1; ch && *ch != '\n'; i--) {
-    ch = access(i);
-    if(!ch.has_value()) break;
-    if(std::iscntrl(static_cast<uint8_t>(*ch))) continue;
-    before += ch.value();
-    filler += '~';
-  }
+  const auto begin = buff.begin();
+  const auto first = std::find(std::make_reverse_iterator(begin + pos), buff.rend(), u8'\n').base();
+  const auto last  = std::find(begin + pos, buff.end(), u8'\n');
+  display_line_(
+    msg,
+    fname,
+    { first, last },
+    stream,
+    static_cast<size_t>(begin + pos - first),
+    line,
+    is_warn);
+}
 
-  ch = '\0';
-  for(size_t i = pos; ch && *ch != '\n'; i++) {
-    ch = access(i);
-    if(!ch.has_value()) break;
-    if(std::iscntrl(static_cast<uint8_t>(*ch))) continue;
-    after += ch.value();
-    filler += i == pos ? '^' : '~';
-  }
+auto ErrorCollector::display_line_(
+  const std::string& msg,
+  const sys::String& fname,
+  const std::span<const char8_t> text,
+  OStream& stream,
+  const size_t column,
+  const uint32_t line,
+  const bool is_warn ) -> void
+{
+  std::string before;        /// The line's text, minus control characters.
+  std::string filler;        /// The squiggly lines and pointy arrow.
 
-  std::ranges::reverse(before);
-  before += after;
-  for(const auto character : filler) {
-    if(character == '^') break;
-    spaces += ' ';
+  before.reserve(text.size());
+  filler.reserve(text.size());
+  for(size_t i = 0; i < text.size(); i++) {
+    const auto ch = static_cast<char>(text[i]);
+    if(std::iscntrl(static_cast<uint8_t>(ch))) continue;
+    before += ch;
+    filler += i == column ? '^' : '~';
   }
 
+  /// The message lines up with the arrow.
+  const size_t spaces = std::min(filler.find('^'), filler.size());
+
   stream
     << Con::Bold  << _nstr("In ") << fname << ':' << line
     << ":\n  |\t" << Con::Reset << before << "\n  |\t"
     << filler        /// Filler contents, tildes below line.
     << "\n  |\t"     ///
     << (is_warn ? Con::YellowFG : Con::RedFG)
-    << spaces        ///
+    << std::string(spaces, ' ')
     << msg           /// Display user-provided message in red or yellow.
     << Con::Reset    /// Reset console.
     << "\n\n";       ///
@@ -202,4 +201,23 @@ auto ErrorCollector::emit(OStream& stream) const -> Result<void> {
   return Result<void>::create();
 }
 
+auto ErrorCollector::emit(OStream& stream, const Lexer& lxr) -> void {
+  const auto it = errs_.find(lxr.file_name_);
+  if(it == errs_.end()) return;
+
+  for(const auto& err : it->second) {
+    const LineCol where = lxr.line_col(err.file_pos);
+    display_line_(
+      err.message,
+      lxr.file_name_,
+      lxr.line_span(where.line),
+      stream,
+      where.column - 1,
+      where.line,
+      err.is_warning);
+  }
+
+  errs_.erase(it);
+}
+
 END_NAMESPACE(rl);
@@ -9,11 +9,13 @@
 #include <n19/Core/ClassTraits.hpp>
 #include <n19/Core/Platform.hpp>
 #include <n19/System/File.hpp>
+#include <n19/Frontend/Common/SourcePos.hpp>
 #include <n19/Core/Stream.hpp>
 #include <n19/Core/Bytes.hpp>
 #include <n19/System/String.hpp>
 #include <string>
 #include <vector>
+#include <span>
 #include <cstdint>
 #include <unordered_map>
 
@@ -24,7 +26,7 @@ using namespace n19;
 
 struct ErrorLocation {
   std::string message;
-  size_t file_pos;
+  SourcePos file_pos;
   uint32_t line;
   bool is_warning;
 };
@@ -36,7 +38,7 @@ public:
     const std::string &msg,
     sys::File &file,
     OStream& stream,
-    const size_t pos,
+    const SourcePos pos,
     const uint32_t line,
     bool is_warn = false
   ) -> void;
@@ -44,9 +46,9 @@ public:
   static auto display_error(
     const std::string& msg,
     const sys::String& fname,
-    const std::vector<char8_t>& buff,
+    std::span<const char8_t> buff,
     OStream& stream,
-    const size_t pos,
+    const SourcePos pos,
     const uint32_t line,
     bool is_warn = false
   ) -> void;
@@ -69,14 +71,14 @@ public:
   auto store_warning(
     const std::string &msg,
     const sys::String& file_name,
-    const size_t pos,
+    const SourcePos pos,
     const uint32_t line
   ) -> ErrorCollector&;
 
   auto store_error(
     const std::string &msg,
     const sys::String& file_name,
-    const size_t pos,
+    const SourcePos pos,
     const uint32_t line
   ) -> ErrorCollector&;
 
@@ -86,18 +88,35 @@ public:
   ) -> ErrorCollector&;
 
   auto emit(OStream& stream) const -> Result<void>;
-  auto has_errors()  const -> bool;
+
+  /// Displays, then forgets, everything stored for the lexer's
+  /// file. The source text comes from the lexer, not the disk.
+  auto emit(OStream& stream, class Lexer const& lxr) -> void;
+
+  auto has_errors()    const -> bool;
+  auto error_count()   const -> uint32_t;
+  auto warning_count() const -> uint32_t;
 
   ErrorCollector() = default;
   ~ErrorCollector() = default;
 private:
+  static auto display_line_(
+    const std::string& msg,
+    const sys::String& fname,
+    std::span<const char8_t> text,
+    OStream& stream,
+    size_t column,
+    uint32_t line,
+    bool is_warn
+  ) -> void;
+
   std::unordered_map<
     sys::String,
     std::vector<ErrorLocation>
   > errs_; // The stored errors.
   uint32_t warning_count_ = 0;
-  uint8_t error_count_    = 0;
-};
+  uint32_t error_count_   = 0;  // Keeps counting past N19_MAX_ERRORS,
+};                              // only the first N19_MAX_ERRORS are stored.
 
 /////////////////////////////////////////////////////////////////////
 
@@ -105,6 +124,14 @@ FORCEINLINE_ auto ErrorCollector::has_errors() const -> bool {
   return error_count_ > 0;
 }
 
+FORCEINLINE_ auto ErrorCollector::error_count() const -> uint32_t {
+  return error_count_;
+}
+
+FORCEINLINE_ auto ErrorCollector::warning_count() const -> uint32_t {
+  return warning_count_;
+}
+
 /////////////////////////////////////////////////////////////////////
 
 END_NAMESPACE(rl);
@@ -12,7 +12,9 @@
 #include <n19/Core/ClassTraits.hpp>
 #include <n19/Core/Panic.hpp>
 #include <n19/Core/Console.hpp>
+#include <n19/Core/StringPool.hpp>
 #include <n19/Frontend/FrontendContext.hpp>
+#include <n19/Frontend/Common/SourcePos.hpp>
 #include <n19/System/String.hpp>
 #include <cstdint>
 #include <string>
@@ -97,12 +99,13 @@ public:
   Entity::ID    id_     = RL_INVALID_ENTITY_ID;
   Entity::ID    parent_ = RL_INVALID_ENTITY_ID;
   uint32_t      line_   = 0;
-  size_t        pos_    = 0;
+  SourcePos     pos_    = 0;
   EntityType    type_   = EntityType::None;
   InputFile::ID file_   = RL_INVALID_INFILE_ID;
   std::string   lname_;
   std::string   name_;
   Children      chldrn_;
+  Maybe<StringPool::Index> lname_id_;  /// lname_ in the lexer's StringPool.
 
   template<typename To, typename From>
   static auto cast(Entity::Ptr<From> p) -> Entity::Ptr<To> {
@@ -26,7 +26,7 @@ public:
   template<typename T, typename ...Args>
   auto insert(
     Entity::ID parent_id,
-    size_t pos,
+    SourcePos pos,
     uint32_t line,
     InputFile::ID file,
     const std::string& lname,
@@ -36,7 +36,7 @@ public:
   template<typename T, typename ...Args>
   auto insert(
     const Entity::Ptr<>& parent,
-    size_t pos,
+    SourcePos pos,
     uint32_t line,
     InputFile::ID file,
     const std::string& lname,
@@ -47,7 +47,7 @@ public:
   auto swap_entity(
     Entity::ID id_of,
     Entity::ID parent_id,
-    size_t new_pos,
+    SourcePos new_pos,
     uint32_t new_line,
     InputFile::ID new_file,
     Args&&... args
@@ -57,7 +57,7 @@ public:
   auto swap_entity(
     Entity::ID id_of,
     const Entity::Ptr<>& parent_ptr,
-    size_t new_pos,
+    SourcePos new_pos,
     uint32_t new_line,
     InputFile::ID new_file,
     Args&&... args
@@ -67,7 +67,7 @@ public:
   auto swap_placeholder(
     Entity::ID id_of,
     Entity::ID parent_id,
-    size_t new_pos,
+    SourcePos new_pos,
     uint32_t new_line,
     InputFile::ID new_file,
     Args&&... args
@@ -77,7 +77,7 @@ public:
   auto swap_placeholder(
     Entity::ID id_of,
     const Entity::Ptr<>& parent_ptr,
-    size_t new_pos,
+    SourcePos new_pos,
     uint32_t new_line,
     InputFile::ID new_file,
     Args&&... args
@@ -106,7 +106,7 @@ private:
 template<typename T, typename ...Args>
 auto EntityTable::insert(
   const Entity::Ptr<>& parent,
-  const size_t pos,
+  const SourcePos pos,
   const uint32_t line,
   const InputFile::ID file,
   const std::string& lname,
@@ -142,7 +142,7 @@ auto EntityTable::insert(
 template<typename T, typename ...Args>
 auto EntityTable::insert(
   const Entity::ID parent_id,
-  const size_t pos,
+  const SourcePos pos,
   const uint32_t line,
   const InputFile::ID file,
   const std::string& lname,
@@ -181,7 +181,7 @@ template<typename T, typename... Args>
 auto EntityTable::swap_entity(
   const Entity::ID id_of,
   const Entity::Ptr<>& parent_ptr,
-  const size_t new_pos,
+  const SourcePos new_pos,
   const uint32_t new_line,
   const InputFile::ID new_file,
   Args&&... args ) -> Entity::Ptr<T>
@@ -210,6 +210,7 @@ auto EntityTable::swap_entity(
   map_[id_of]->chldrn_ = std::move(old->chldrn_);
   map_[id_of]->name_   = std::move(old->name_);
   map_[id_of]->lname_  = std::move(old->lname_);
+  map_[id_of]->lname_id_ = old->lname_id_;
 
   return Entity::cast<T>(map_[id_of]);
 }
@@ -218,7 +219,7 @@ template<typename T, typename... Args>
 auto EntityTable::swap_entity(
   const Entity::ID id_of,
   const Entity::ID parent_id,
-  const size_t new_pos,
+  const SourcePos new_pos,
   const uint32_t new_line,
   const InputFile::ID new_file,
   Args &&... args ) -> Entity::Ptr<T>
@@ -247,6 +248,7 @@ auto EntityTable::swap_entity(
   map_[id_of]->chldrn_ = std::move(old->chldrn_);
   map_[id_of]->name_   = std::move(old->name_);
   map_[id_of]->lname_  = std::move(old->lname_);
+  map_[id_of]->lname_id_ = old->lname_id_;
 
   return Entity::cast<T>(map_[id_of]);
 }
@@ -255,7 +257,7 @@ template<typename T, typename... Args>
 auto EntityTable::swap_placeholder(
   const Entity::ID id_of,
   const Entity::Ptr<>& parent_ptr,
-  const size_t new_pos,
+  const SourcePos new_pos,
   const uint32_t new_line,
   const InputFile::ID new_file,
   Args&&... args ) -> Result<Entity::Ptr<T>>
@@ -303,7 +305,7 @@ template<typename T, typename... Args>
 auto EntityTable::swap_placeholder(
   const Entity::ID id_of,
   const Entity::ID parent_id,
-  const size_t new_pos,
+  const SourcePos new_pos,
   const uint32_t new_line,
   const InputFile::ID new_file,
   Args&&... args ) -> Result<Entity::Ptr<T>>
@@ -4,6 +4,7 @@
 */
 
 #include <n19/Frontend/FrontendContext.hpp>
+#include <atomic>
 #include <bitset>
 
 #ifdef N19_WIN32
@@ -14,10 +15,10 @@
 
 namespace {
   constinit
-  rl::InputFile::ID g_inputfile_id_  = RL_INVALID_INFILE_ID + 1;
+  std::atomic<rl::InputFile::ID> g_inputfile_id_  = RL_INVALID_INFILE_ID + 1;
 
   constinit
-  rl::OutputFile::ID g_outputfile_id_ = RL_INVALID_OUTFILE_ID + 1;
+  std::atomic<rl::OutputFile::ID> g_outputfile_id_ = RL_INVALID_OUTFILE_ID + 1;
 }
 
 BEGIN_NAMESPACE(rl);
@@ -101,6 +102,28 @@ OutputFile::OutputFile(sys::String&& n) : name(n) {
   this->id = Context::get_next_output_id();
 }
 
+auto Context::add_include(sys::String&& name) -> InputFile::ID {
+  std::lock_guard guard(inputs_lock_);
+  const auto known = std::ranges::find_if(inputs_, [&name](const InputFile& f) {
+    return f.name == name;
+  });
+
+  if(known != inputs_.end()) return known->id;
+  InputFile& added = inputs_.emplace_back(std::move(name));
+  added.kind = InputFileKind::Included;
+  return added.id;
+}
+
+auto Context::set_input_state(const InputFile::ID id, const InputFileState state) -> void {
+  std::lock_guard guard(inputs_lock_);
+  auto it = std::ranges::find_if(inputs_, [id](const InputFile& f) {
+    return f.id == id;
+  });
+
+  ASSERT(it != inputs_.end(), "Unknown input file ID.");
+  it->state = state;
+}
+
 auto Context::dump(OStream& stream) -> void {
   stream
     << Con::MagentaFG
@@ -161,6 +184,13 @@ auto Context::dump(OStream& stream) -> void {
       << "\"\n";
   }
 
+  stream
+    << Con::MagentaFG
+    << "Jobs: "
+    << Con::Reset
+    << jobs_
+    << "\n";
+
   stream
     << Con::MagentaFG
     << "RawFlags: "
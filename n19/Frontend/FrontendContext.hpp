@@ -13,6 +13,7 @@
 #include <n19/Core/Console.hpp>
 #include <vector>
 #include <algorithm>
+#include <mutex>
 #include <cstdint>
 
 #define RL_INVALID_INFILE_ID  0
@@ -59,15 +60,17 @@ struct OutputFile {
   OutputFile(sys::String&& n);
 };
 
-#define RL_FRONTEND_CONTEXT_FLAG_LIST                             \
-  X(None,     0x00 << 0) /* Default flag value.               */  \
-  X(Verbose,  0x01 << 0) /* Enable verbose output.            */  \
-  X(Colours,  0x01 << 1) /* Pretty colours!                   */  \
-  X(DumpIR,   0x01 << 2) /* Dump intermediate representation. */  \
-  X(DumpAST,  0x01 << 3) /* Dump the abstract syntax tree.    */  \
-  X(DumpEnts, 0x01 << 4) /* Dump the entity table.            */  \
-  X(DumpToks, 0x01 << 5) /* Dump tokens, do not compile.      */  \
-  X(DumpCtx,  0x01 << 6) /* Dump the frontend context object. */  \
+#define RL_FRONTEND_CONTEXT_FLAG_LIST                                \
+  X(None,        0x00 << 0) /* Default flag value.               */  \
+  X(Verbose,     0x01 << 0) /* Enable verbose output.            */  \
+  X(Colours,     0x01 << 1) /* Pretty colours!                   */  \
+  X(DumpIR,      0x01 << 2) /* Dump intermediate representation. */  \
+  X(DumpAST,     0x01 << 3) /* Dump the abstract syntax tree.    */  \
+  X(DumpEnts,    0x01 << 4) /* Dump the entity table.            */  \
+  X(DumpToks,    0x01 << 5) /* Dump tokens, do not compile.      */  \
+  X(DumpCtx,     0x01 << 6) /* Dump the frontend context object. */  \
+  X(DumpToksBin, 0x01 << 7) /* Dump tokens as binary records.    */  \
+  X(SkimBodies,  0x01 << 8) /* Don't parse procedure bodies.     */  \
 
 class Context {
   N19_MAKE_NONMOVABLE(Context);
@@ -84,6 +87,13 @@ public:
   static auto get_next_input_id()  -> InputFile::ID;
   auto dump(OStream& stream = outs()) -> void;
 
+  /// The ID of an @include'd file, registering it as a Pending
+  /// input the first time any compilation includes it. Whether it
+  /// gets parsed is up to each compilation. These two lock inputs_,
+  /// so they're safe to call while inputs compile in parallel.
+  auto add_include(sys::String&& name) -> InputFile::ID;
+  auto set_input_state(InputFile::ID id, InputFileState state) -> void;
+
   FORCEINLINE_ static auto the() -> Context& {
     static Context the_context;
     return the_context;
@@ -108,8 +118,12 @@ public:
   }
 
   std::underlying_type_t<Flags> flags_{};
+  sys::String token_cache_{};        /// Token cache directory, empty if disabled.
+  sys::String ast_cache_{};          /// AST cache directory, empty if disabled.
+  uint32_t jobs_{};                  /// Inputs compiled at once, 0 for one per hardware thread.
   std::vector<InputFile> inputs_{};
   std::vector<OutputFile> outputs_{};
+  std::mutex inputs_lock_;           /// Held by add_include() and set_input_state().
 
  ~Context() = default;
 private:
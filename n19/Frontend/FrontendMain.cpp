@@ -13,10 +13,11 @@
 #include <n19/Frontend/Common/CompilationCycle.hpp>
 #include <n19/System/BackTrace.hpp>
 #include <n19/System/SharedRegion.hpp>
+#include <cstdint>
 #include <cstdlib>
 #include <utility>
 
-#define ARGNUM_HARD_LIMIT 40
+#define ARGNUM_HARD_LIMIT 4096
 
 using namespace rl;
 
@@ -41,10 +42,11 @@ struct MainArgParser : argp::Parser {
     _nstr("-dump-ast"),
     _nstr("Dump the program's AST."));
 
-  bool& dump_toks = arg<bool>(
+  sys::String& dump_toks = arg<sys::String>(
     _nstr("--dump-tokens"),
     _nstr("-dump-tokens"),
-    _nstr("Dump the program's tokens only, do not compile it."));
+    _nstr("Dump the program's tokens only, do not compile it. =bin for binary records."),
+    sys::String(_nstr("none")));
 
   bool& dump_ents = arg<bool>(
     _nstr("--dump-entities"),
@@ -67,6 +69,26 @@ struct MainArgParser : argp::Parser {
     _nstr("-dump-context"),
     _nstr("Dump the frontend Context object."));
 
+  sys::String& token_cache = arg<sys::String>(
+    _nstr("--token-cache"),
+    _nstr("-token-cache"),
+    _nstr("Cache lexed tokens in this directory, keyed by source hash."));
+
+  sys::String& ast_cache = arg<sys::String>(
+    _nstr("--ast-cache"),
+    _nstr("-ast-cache"),
+    _nstr("Cache parsed ASTs in this directory, keyed by source hash."));
+
+  bool& skim_bodies = arg<bool>(
+    _nstr("--skim-bodies"),
+    _nstr("-skim-bodies"),
+    _nstr("Skip procedure bodies when only declarations are needed. Errors inside them go unreported."));
+
+  int64_t& jobs = arg<int64_t>(
+    _nstr("--jobs"),
+    _nstr("-j"),
+    _nstr("Compile up to this many inputs at once. Defaults to one per hardware thread."));
+
   bool& show_help = arg<bool>(
     _nstr("--help"),
     _nstr("-h"),
@@ -136,11 +158,37 @@ static auto verify_args(MainArgParser& parser) -> bool {
   auto& context = Context::the();
   if (parser.dump_ast)  context.flags_ |= Context::DumpAST;
   if (parser.dump_ents) context.flags_ |= Context::DumpEnts;
-  if (parser.dump_toks) context.flags_ |= Context::DumpToks;
+  if (parser.skim_bodies) context.flags_ |= Context::SkimBodies;
+  if (parser.dump_toks == _nstr("bin")) {
+    context.flags_ |= Context::DumpToks | Context::DumpToksBin;
+  } else if (parser.dump_toks.empty() || parser.dump_toks == _nstr("text")) {
+    context.flags_ |= Context::DumpToks;
+  } else if (parser.dump_toks != _nstr("none")) {
+    outs()
+      << Con::RedFG
+      << "Error:"
+      << Con::Reset
+      << " Unknown token dump format. Expected \"text\" or \"bin\"."
+      << "\n";
+    return false;
+  }
   if (parser.dump_ir)   context.flags_ |= Context::DumpIR;
   if (parser.verbose)   context.flags_ |= Context::Verbose;
   if (parser.dump_ctx)  context.flags_ |= Context::DumpCtx;
   if (parser.colours)   context.flags_ |= Context::Colours;
+  if (parser.jobs < 0 || parser.jobs > UINT32_MAX) {
+    outs()
+      << Con::RedFG
+      << "Error:"
+      << Con::Reset
+      << " --jobs is out of range."
+      << "\n";
+    return false;
+  }
+
+  context.token_cache_ = parser.token_cache;
+  context.ast_cache_   = parser.ast_cache;
+  context.jobs_        = static_cast<uint32_t>(parser.jobs);
 
   context.inputs_.reserve(parser.inputs.size());
   context.outputs_.reserve(parser.outputs.size());
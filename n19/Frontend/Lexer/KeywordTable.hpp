@@ -0,0 +1,143 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Core/Maybe.hpp>
+#include <n19/Frontend/Lexer/Keywords.hpp>
+#include <n19/Frontend/Lexer/Token.hpp>
+#include <string_view>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+BEGIN_NAMESPACE(rl);
+
+struct Keyword {
+  TokenType type;
+  TokenCategory cat;
+};
+
+///
+/// A perfect hash over LR_KEYWORDS, built entirely at compile time.
+/// A lookup is a length and first/last byte prefilter, one
+/// multiplicative hash, and a single string compare to verify the hit.
+/// Identifiers that aren't keywords usually fail the prefilter.
+class KeywordTable {
+public:
+  struct Entry {
+    std::u8string_view name;
+    Keyword kw;
+  };
+
+  static auto lookup(std::u8string_view str) -> Maybe<Keyword>;
+  static constexpr auto find(std::u8string_view str) -> const Entry*;
+
+  constexpr static size_t count = 0
+#define KEYWORD_X(NAME, TYPE, CAT) + 1
+    LR_KEYWORDS;
+#undef KEYWORD_X
+
+  static const std::array<Entry, count> entries;
+  KeywordTable() = delete;
+private:
+  constexpr static uint32_t slot_bits_ = 6;
+  constexpr static uint8_t  empty_     = 0xFF;
+  using Slots_ = std::array<uint8_t, 1u << slot_bits_>;
+
+  struct Layout_ {
+    uint32_t seed = 0;
+    Slots_ slots{};
+    size_t min_len = SIZE_MAX;
+    size_t max_len = 0;
+    uint32_t first_mask = 0;  /// Bit N set: some keyword starts with 'a' + N.
+    uint32_t last_mask  = 0;  /// Bit N set: some keyword ends with 'a' + N.
+  };
+
+  /// Length, first, middle and last byte packed into one word.
+  /// The middle byte is what separates "continue" from "compeval".
+  constexpr static auto key_of_(const std::u8string_view str) -> uint32_t {
+    return static_cast<uint32_t>(str.front())
+      | static_cast<uint32_t>(str.back()) << 8
+      | static_cast<uint32_t>(str[str.size() / 2]) << 16
+      | static_cast<uint32_t>(str.size()) << 24;
+  }
+
+  constexpr static auto hash_(const uint32_t key, const uint32_t seed) -> uint32_t {
+    return (key * seed) >> (32 - slot_bits_);
+  }
+
+  static const Layout_ layout_;
+};
+
+constexpr std::array<KeywordTable::Entry, KeywordTable::count> KeywordTable::entries = []() consteval {
+  using enum TokenCategory::Value;
+  return std::array<Entry, count>{{
+#define KEYWORD_X(NAME, TYPE, CAT) {u8##NAME, rl::Keyword{TokenType::TYPE, CAT}},
+    LR_KEYWORDS
+#undef KEYWORD_X
+  }};
+}();
+
+constexpr KeywordTable::Layout_ KeywordTable::layout_ = []() consteval -> Layout_ {
+  Layout_ out;
+  for(const Entry& e : entries) {
+    const auto first = static_cast<uint32_t>(e.name.front() - u8'a');
+    const auto last  = static_cast<uint32_t>(e.name.back() - u8'a');
+    if(first >= 26 || last >= 26) throw "Keywords must start and end with [a-z].";
+
+    out.first_mask |= 1u << first;
+    out.last_mask  |= 1u << last;
+    out.min_len = std::min(out.min_len, e.name.size());
+    out.max_len = std::max(out.max_len, e.name.size());
+  }
+
+  for(uint32_t attempt = 0; attempt < (1u << 16); attempt++) {
+    const uint32_t seed = 0x9E3779B1 + attempt * 2;
+    out.slots.fill(empty_);
+    bool ok = true;
+    for(size_t i = 0; i < entries.size() && ok; i++) {
+      uint8_t& slot = out.slots[ hash_(key_of_(entries[i].name), seed) ];
+      ok   = slot == empty_;
+      slot = static_cast<uint8_t>(i);
+    }
+
+    if(ok) { out.seed = seed; return out; }
+  }
+
+  throw "No perfect hash seed for LR_KEYWORDS.";
+}();
+
+constexpr auto KeywordTable::find(const std::u8string_view str) -> const Entry* {
+  if(str.size() < layout_.min_len || str.size() > layout_.max_len) {
+    return nullptr;
+  }
+
+  const auto first = static_cast<uint32_t>(str.front() - u8'a');
+  const auto last  = static_cast<uint32_t>(str.back() - u8'a');
+  if(first >= 26 || !(layout_.first_mask >> first & 1)) return nullptr;
+  if(last >= 26  || !(layout_.last_mask >> last & 1))   return nullptr;
+
+  const uint8_t slot = layout_.slots[ hash_(key_of_(str), layout_.seed) ];
+  if(slot == empty_ || entries[slot].name != str) {
+    return nullptr;
+  }
+
+  return &entries[slot];
+}
+
+FORCEINLINE_ auto KeywordTable::lookup(const std::u8string_view str) -> Maybe<Keyword> {
+  if(const Entry* e = find(str)) return e->kw;
+  return Nothing;
+}
+
+static_assert(KeywordTable::find(u8"continue") != nullptr);
+static_assert(KeywordTable::find(u8"compeval") != nullptr);
+static_assert(KeywordTable::find(u8"continue") != KeywordTable::find(u8"compeval"));
+static_assert(KeywordTable::find(u8"contine") == nullptr);
+
+END_NAMESPACE(rl);
@@ -4,226 +4,23 @@
 */
 
 #include <n19/Core/Try.hpp>
-#include <n19/Core/Murmur3.hpp>
 #include <n19/Frontend/Lexer/Lexer.hpp>
 #include <n19/Frontend/Diagnostics/ErrorCollector.hpp>
 #include <n19/Frontend/Lexer/Keywords.hpp>
+#include <n19/Core/StringUtil.hpp>
+#include <n19/Core/TokenDump.hpp>
 #include <filesystem>
 #include <algorithm>
 #include <limits>
-#include <functional>
+#include <cstring>
+#include <charconv>
 #include <array>
+#include <utility>
 
 BEGIN_NAMESPACE(rl);
 
-inline auto Lexer::token_hyphen_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-
-  switch(peek_char_()) {
-  case u8'=': // '-='
-    curr_tok.type_ = TokenType::SubEq;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.cat_ |= TokenCategory::PointerArithOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  case u8'-': // '--'
-    curr_tok.type_ = TokenType::Dec;
-    curr_tok.cat_  = TokenCategory::UnaryOp;
-    curr_tok.cat_ |= TokenCategory::PointerArithOp;
-    curr_tok.cat_ |= TokenCategory::ValidPostfix;
-    curr_tok.cat_ |= TokenCategory::ValidPrefix;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  case u8'>': // '->'
-    curr_tok.type_ = TokenType::SkinnyArrow;
-    curr_tok.cat_ |= TokenCategory::BinaryOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  default: // '-'
-    curr_tok.type_ = TokenType::Sub;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.cat_ |= TokenCategory::PointerArithOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-    break;
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_ampersand_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-  curr_tok.cat_  = TokenCategory::BinaryOp;
-
-  switch(peek_char_()) {
-  case u8'=': // '&='
-    curr_tok.type_ = TokenType::BitwiseAndEq;
-    curr_tok.cat_ |= TokenCategory::BitwiseAssignOp;
-    curr_tok.cat_ |= TokenCategory::BitwiseOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  case u8'&': // '&&'
-    curr_tok.type_ = TokenType::LogicalAnd;
-    curr_tok.cat_ |= TokenCategory::LogicalOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  default: // '&'
-    curr_tok.type_  = TokenType::BitwiseAnd;
-    curr_tok.cat_  |= TokenCategory::BitwiseOp;
-    curr_tok.cat_  |= TokenCategory::UnaryOp;
-    curr_tok.cat_  |= TokenCategory::ValidPrefix;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-    break;
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_dot_() -> Token {
-  Token curr_tok;
-  curr_tok.line_ = line_;
-  curr_tok.cat_  = TokenCategory::NonCategorical;
-  curr_tok.pos_  = index_;
-
-  if(peek_char_(1) == u8'.' && peek_char_(2) == u8'.') { // '...'
-    curr_tok.type_ = TokenType::DotThree;
-    curr_tok.len_  = 3;
-    consume_char_(3);
-  } else if(peek_char_(1) == u8'.') { // '..'
-    curr_tok.type_ = TokenType::DotTwo;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '.'
-    curr_tok.type_ = TokenType::Dot;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_equals_() -> Token {
-  Token curr_tok;
-  curr_tok.line_ = line_;
-  curr_tok.pos_ = index_;
-
-  switch(peek_char_()) {
-  case u8'=': // '=='
-    curr_tok.type_ = TokenType::Eq;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::LogicalOp;
-    curr_tok.cat_ |= TokenCategory::ComparisonOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  case u8'>': // '=>'
-    curr_tok.type_ = TokenType::FatArrow;
-    curr_tok.cat_  = TokenCategory::NonCategorical;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  default: // '='
-    curr_tok.type_ = TokenType::ValueAssignment;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-    break;
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_plus_() -> Token {
-  Token curr_tok;
-  curr_tok.line_ = line_;
-  curr_tok.pos_ = index_;
-
-  switch(peek_char_()) {
-  case u8'=': // '+='
-    curr_tok.type_ = TokenType::PlusEq;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.cat_ |= TokenCategory::PointerArithOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  case u8'+': // '++'
-    curr_tok.type_ = TokenType::Inc;
-    curr_tok.cat_  = TokenCategory::UnaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.cat_ |= TokenCategory::PointerArithOp;
-    curr_tok.cat_ |= TokenCategory::ValidPostfix;
-    curr_tok.cat_ |= TokenCategory::ValidPrefix;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-    break;
-  default: // '+'
-    curr_tok.type_ = TokenType::Plus;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::UnaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.cat_ |= TokenCategory::PointerArithOp;
-    curr_tok.cat_ |= TokenCategory::ValidPrefix;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-    break;
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_gthan_() -> Token {
-  Token curr_tok;
-  curr_tok.cat_  = TokenCategory::BinaryOp;
-  curr_tok.line_ = line_;
-  curr_tok.pos_  = index_;
-
-  if(peek_char_(1) == u8'=') { // '>='
-    curr_tok.type_ = TokenType::Gte;
-    curr_tok.cat_ |= TokenCategory::LogicalOp | TokenCategory::ComparisonOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else if(peek_char_(1) == u8'>' && peek_char_(2) == u8'=') { // '>>='
-    curr_tok.type_ = TokenType::RshiftEq;
-    curr_tok.cat_ |= TokenCategory::BitwiseOp | TokenCategory::BitwiseAssignOp;
-    curr_tok.len_  = 3;
-    consume_char_(3);
-  } else if(peek_char_(1) == u8'>') { // '>>'
-    curr_tok.type_ = TokenType::Rshift;
-    curr_tok.cat_ |= TokenCategory::BitwiseOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '>'
-    curr_tok.type_ = TokenType::Gt;
-    curr_tok.cat_ |= TokenCategory::LogicalOp | TokenCategory::ComparisonOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
 inline auto Lexer::token_squote_() -> Token {
   Token curr_tok;
-  curr_tok.line_ = line_;
   curr_tok.pos_  = index_;
 
   ///
@@ -243,12 +40,10 @@ inline auto Lexer::token_squote_() -> Token {
   } else if(current_char_() == u8'\'') {
     consume_char_(1);
     curr_tok.type_ = TokenType::ByteLiteral;
-    curr_tok.cat_  = TokenCategory::Literal;
     curr_tok.len_  = index_ - curr_tok.pos_;
     return curr_tok;
   } else if(UTF8_LEADING(current_char_()) || current_char_() == u8'\n') {
     curr_tok.type_ = TokenType::Illegal;
-    curr_tok.cat_  = TokenCategory::NonCategorical;
     curr_tok.len_  = index_ - curr_tok.pos_;
     return curr_tok;
   } else {
@@ -263,393 +58,66 @@ inline auto Lexer::token_squote_() -> Token {
   if(current_char_() == u8'\'') {
     consume_char_(1);
     curr_tok.type_ = TokenType::ByteLiteral;
-    curr_tok.cat_  = TokenCategory::Literal;
     curr_tok.len_  = index_ - curr_tok.pos_;
   } else {
     curr_tok.type_ = TokenType::Illegal;
-    curr_tok.cat_  = TokenCategory::NonCategorical;
     curr_tok.len_  = index_ - curr_tok.pos_;
   }
 
   return curr_tok;
 }
 
-inline auto Lexer::token_asterisk_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-
-  if(peek_char_() == u8'=') { // '*='
-    curr_tok.type_ = TokenType::MulEq;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.len_ = 2;
-    consume_char_(2);
-  } else { // '*'
-    curr_tok.type_ = TokenType::Mul;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::UnaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.cat_ |= TokenCategory::ValidPrefix;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_colon_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-
-  if(peek_char_() == u8':') { // '::'
-    curr_tok.type_  = TokenType::NamespaceOperator;
-    curr_tok.cat_  |= TokenCategory::UnaryOp;
-    curr_tok.cat_  |= TokenCategory::ValidPrefix;
-    curr_tok.cat_  |= TokenCategory::BinaryOp;
-    curr_tok.len_   = 2;
-    consume_char_(2);
-  } else { // ':'
-    curr_tok.type_  = TokenType::TypeAssignment;
-    curr_tok.cat_   = TokenCategory::NonCategorical;
-    curr_tok.len_   = 1;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
-auto Lexer::token_bang_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-
-  if(peek_char_() == u8'=') { // '!='
-    curr_tok.type_ = TokenType::Neq;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::LogicalOp;
-    curr_tok.cat_ |= TokenCategory::ComparisonOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '!'
-    curr_tok.type_ = TokenType::LogicalNot;
-    curr_tok.cat_  = TokenCategory::UnaryOp;
-    curr_tok.cat_ |= TokenCategory::ValidPrefix;
-    curr_tok.cat_ |= TokenCategory::LogicalOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_percent_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-  curr_tok.cat_  = TokenCategory::BinaryOp | TokenCategory::ArithmeticOp;
-
-  if(peek_char_() == u8'=') { // '%='
-    curr_tok.type_ = TokenType::ModEq;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '%'
-    curr_tok.type_ = TokenType::Mod;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_uparrow_() -> Token {
-  Token curr_tok;
-  curr_tok.cat_  = TokenCategory::BinaryOp | TokenCategory::BitwiseOp;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-
-  if(peek_char_() == u8'=') { // '^='
-    curr_tok.type_ = TokenType::XorEq;
-    curr_tok.cat_ |= TokenCategory::BitwiseAssignOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '^'
-    curr_tok.type_ = TokenType::Xor;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-  }
-
-  return curr_tok;
-}
-
-inline auto Lexer::token_pipe_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.len_  = 2;
-  curr_tok.line_ = line_;
-  curr_tok.cat_  = TokenCategory::BinaryOp;
-
-  switch(peek_char_()) {
-  case u8'|': // '||'
-    curr_tok.type_ = TokenType::LogicalOr;
-    curr_tok.cat_ |= TokenCategory::LogicalOp;
-    consume_char_(2);
-    break;
-  case u8'=': // '|='
-    curr_tok.type_  = TokenType::BitwiseOrEq;
-    curr_tok.cat_  |= TokenCategory::BitwiseOp | TokenCategory::BitwiseAssignOp;
-    consume_char_(2);
-    break;
-  default: // '|'
-    curr_tok.type_ = TokenType::BitwiseOr;
-    curr_tok.cat_  = TokenCategory::BitwiseOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-    break;
-  }
-
-  return curr_tok;
-}
+/// Every punctuator and operator: one walk over the
+/// OperatorTable DFA, and the category comes from the type.
+FORCEINLINE_ auto Lexer::token_operator_() -> Token {
+  const auto match = OperatorTable::match(src_.data() + index_);
+  ASSERT(match.len > 0, "Operator DFA accepted nothing.");
 
-inline auto Lexer::token_lthan_() -> Token {
   Token curr_tok;
   curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-  curr_tok.cat_  = TokenCategory::BinaryOp;
-
-  if(peek_char_(1) == u8'=') { // '<='
-    curr_tok.type_ = TokenType::Lte;
-    curr_tok.cat_ |= TokenCategory::LogicalOp | TokenCategory::ComparisonOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else if(peek_char_(1) == u8'<' && peek_char_(2) == u8'=') [[unlikely]] { // <<=
-    curr_tok.type_ = TokenType::LshiftEq;
-    curr_tok.cat_ |= TokenCategory::BitwiseOp | TokenCategory::BitwiseAssignOp;
-    curr_tok.len_  = 3;
-    consume_char_(3);
-  } else if(peek_char_(1) == u8'<') { // '<<'
-    curr_tok.type_ = TokenType::Lshift;
-    curr_tok.cat_ |= TokenCategory::BitwiseOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '<'
-    curr_tok.type_ = TokenType::Lt;
-    curr_tok.cat_ |= TokenCategory::LogicalOp | TokenCategory::ComparisonOp;
-    curr_tok.len_  = 1;
-    consume_char_(1);
-  }
-
+  curr_tok.len_  = match.len;
+  curr_tok.type_ = match.type;
+  consume_char_(match.len);
   return curr_tok;
 }
 
 FORCEINLINE_ auto Lexer::token_null_()  -> Token {
   Token curr_tok;
   curr_tok.type_ = TokenType::EndOfFile;
-  curr_tok.cat_  = TokenCategory::NonCategorical;
   curr_tok.len_  = 0;
   curr_tok.pos_  = src_.size() - 1;
   return curr_tok;
 }
 
-FORCEINLINE_ auto Lexer::token_tilde_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::BitwiseNot;
-  curr_tok.cat_  = TokenCategory::UnaryOp | TokenCategory::BitwiseOp | TokenCategory::ValidPrefix;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_at_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::At;
-  curr_tok.cat_  = TokenCategory::Punctuator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_money_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::Money;
-  curr_tok.cat_  = TokenCategory::NonCategorical;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_lsqbrckt_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::LeftSqBracket;
-  curr_tok.cat_  = TokenCategory::Punctuator | TokenCategory::ValidPostfix;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_rsqbrckt_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::RightSqBracket;
-  curr_tok.cat_  = TokenCategory::Punctuator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_semicolon_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::Semicolon;
-  curr_tok.cat_  = TokenCategory::Punctuator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_lparen_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::LeftParen;
-  curr_tok.cat_  = TokenCategory::Punctuator | TokenCategory::ValidPostfix;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_rparen_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::RightParen;
-  curr_tok.cat_  = TokenCategory::Punctuator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_lbrace_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::LeftBrace;
-  curr_tok.cat_  = TokenCategory::Punctuator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_rbrace_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::RightBrace;
-  curr_tok.cat_  = TokenCategory::Punctuator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
-FORCEINLINE_ auto Lexer::token_comma_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.type_ = TokenType::Comma;
-  curr_tok.cat_  = TokenCategory::Punctuator | TokenCategory::Terminator;
-  curr_tok.line_ = line_;
-  curr_tok.len_  = 1;
-  consume_char_(1);
-  return curr_tok;
-}
-
 auto Lexer::produce_impl_() -> Token {
   if(index_ >= src_.size()) {
-    return Token::eof(src_.size() - 1, line_);
+    return Token::eof(src_.size() - 1);
   }
 
   SWITCH_BEGIN:
   switch(current_char_()) {
     case u8'\\'  : FALLTHROUGH_; // illegal character! fallthrough.
-    case u8'?'   : return Token::illegal(index_, 1, line_);
+    case u8'?'   : consume_char_(1); return Token::illegal(index_ - 1, 1);
     case u8'#'   : skip_comment_();         goto SWITCH_BEGIN;
-    case u8'\n'  : advance_consume_line_(); goto SWITCH_BEGIN;
-    case u8' '   : FALLTHROUGH_; // skip character.
-    case u8'\r'  : FALLTHROUGH_; // skip character.
-    case u8'\b'  : FALLTHROUGH_; // skip character.
-    case u8'\a'  : FALLTHROUGH_; // skip character.
-    case u8'\v'  : FALLTHROUGH_; // skip character.
-    case u8'\t'  : consume_char_(1);        goto SWITCH_BEGIN;
-    case u8'/'   : return token_fwdslash_();
+    case u8'\n'  : FALLTHROUGH_; // skip whitespace.
+    case u8' '   : FALLTHROUGH_; // skip whitespace.
+    case u8'\r'  : FALLTHROUGH_; // skip whitespace.
+    case u8'\b'  : FALLTHROUGH_; // skip whitespace.
+    case u8'\a'  : FALLTHROUGH_; // skip whitespace.
+    case u8'\v'  : FALLTHROUGH_; // skip whitespace.
+    case u8'\t'  : skip_space_();           goto SWITCH_BEGIN;
     case u8'\0'  : return token_null_();
-    case u8'~'   : return token_tilde_();
-    case u8'@'   : return token_at_();
-    case u8'$'   : return token_money_();
-    case u8'['   : return token_lsqbrckt_();
-    case u8']'   : return token_rsqbrckt_();
-    case u8';'   : return token_semicolon_();
-    case u8'('   : return token_lparen_();
-    case u8')'   : return token_rparen_();
-    case u8'{'   : return token_lbrace_();
-    case u8'}'   : return token_rbrace_();
-    case u8','   : return token_comma_();
-    case u8'-'   : return token_hyphen_();
-    case u8'&'   : return token_ampersand_();
-    case u8'.'   : return token_dot_();
-    case u8'!'   : return token_bang_();
-    case u8'<'   : return token_lthan_();
-    case u8'>'   : return token_gthan_();
-    case u8'+'   : return token_plus_();
-    case u8'*'   : return token_asterisk_();
-    case u8'%'   : return token_percent_();
-    case u8'='   : return token_equals_();
-    case u8'|'   : return token_pipe_();
-    case u8'^'   : return token_uparrow_();
     case u8'\''  : return token_squote_();
     case u8'"'   : return token_quote_();
     case u8'`'   : return token_quote_();
-    case u8':'   : return token_colon_();
-    default      : return token_ambiguous_();
+    default      : break;
   }
 
-  UNREACHABLE_ASSERTION; // assertion
-}
-
-inline auto Lexer::token_fwdslash_() -> Token {
-  Token curr_tok;
-  curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
-
-  if(peek_char_() == u8'=') { // '/='
-    curr_tok.type_ = TokenType::DivEq;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithAssignOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.len_  = 2;
-    consume_char_(2);
-  } else { // '/'
-    curr_tok.type_ = TokenType::Div;
-    curr_tok.cat_  = TokenCategory::BinaryOp;
-    curr_tok.cat_ |= TokenCategory::UnaryOp;
-    curr_tok.cat_ |= TokenCategory::ArithmeticOp;
-    curr_tok.cat_ |= TokenCategory::ValidPrefix;
-    curr_tok.len_  = 1;
-    consume_char_(1);
+  if(OperatorTable::starts(current_char_())) {
+    return token_operator_();
   }
 
-  return curr_tok;
+  return token_ambiguous_();
 }
 
 inline auto Lexer::token_quote_() -> Token {
@@ -661,23 +129,20 @@ inline auto Lexer::token_quote_() -> Token {
   while(true) {
     if(current_char_() == u8'\0' || current_char_() == u8'\n') {
       curr_tok.type_ = TokenType::Illegal;
-      curr_tok.cat_  = TokenCategory::NonCategorical;
       curr_tok.pos_  = string_start;
       break;
     } if(current_char_() == opening_quote) {
       consume_char_(1);
       curr_tok.type_ = TokenType::StringLiteral;
-      curr_tok.cat_  = TokenCategory::Literal;
       curr_tok.pos_  = string_start;
       curr_tok.len_  = index_ - string_start;
+      intern_(curr_tok);
       break;
     }
 
     /// skip escaped quote.
     if(current_char_() == u8'\\' && peek_char_() == opening_quote) {
       consume_char_(2);
-    } else if(UTF8_LEADING(current_char_())) {
-      skip_utf8_sequence_();
     } else {
       consume_char_(1);
     }
@@ -692,21 +157,20 @@ inline auto Lexer::token_hex_lit_() -> Token {
 
   const auto start = index_;
   consume_char_(2); // move past "0x"
-  skip_chars_until_([](const char8_t ch) {
-    return !CH_IS_XDIGIT(ch);
-  });
+
+  const char8_t* begin = src_.data();
+  index_ = static_cast<uint32_t>(
+    ByteScanner::find_non_xdigit(begin + index_, begin + src_.size()) - begin);
 
   Token token;
   token.pos_  = start;
-  token.line_ = line_;
   token.len_  = index_ - start;
 
   if(index_ - start < 3) {
     token.type_ = TokenType::Illegal;
-    token.cat_  = TokenCategory::NonCategorical;
   } else {
     token.type_ = TokenType::HexLiteral;
-    token.cat_  = TokenCategory::Literal;
+    decode_literal_(token);
   }
 
   return token;
@@ -719,9 +183,7 @@ inline auto Lexer::token_num_lit_() -> Token {
   bool seen_dot      = false;
 
   Token curr_tok;
-  curr_tok.line_ = line_;
   curr_tok.pos_  = start;
-  curr_tok.cat_  = TokenCategory::Literal;
 
   while(true) {
     const char8_t curr = current_char_();
@@ -734,7 +196,6 @@ inline auto Lexer::token_num_lit_() -> Token {
         break;
       } if(seen_dot || seen_exponent) {
         curr_tok.type_ = TokenType::Illegal;
-        curr_tok.cat_  = TokenCategory::NonCategorical;
         return curr_tok;
       }
 
@@ -746,11 +207,9 @@ inline auto Lexer::token_num_lit_() -> Token {
     else if(curr == u8'e' || curr == u8'E') {
       if(seen_exponent) {
         curr_tok.type_ = TokenType::Illegal;
-        curr_tok.cat_  = TokenCategory::NonCategorical;
         return curr_tok;
       } if((next == u8'-' || next == u8'+') && !CH_IS_DIGIT(peek_char_(2))) {
         curr_tok.type_ = TokenType::Illegal;
-        curr_tok.cat_  = TokenCategory::NonCategorical;
         return curr_tok;
       } if((next == u8'-' || next == u8'+') && CH_IS_DIGIT(peek_char_(2))) {
         consume_char_(1);
@@ -777,6 +236,7 @@ inline auto Lexer::token_num_lit_() -> Token {
     curr_tok.len_  = index_ - start;
   }
 
+  decode_literal_(curr_tok);
   return curr_tok;
 }
 
@@ -786,9 +246,7 @@ inline auto Lexer::token_oct_lit_() -> Token {
 
   Token curr_tok;
   curr_tok.pos_  = index_;
-  curr_tok.line_ = line_;
   curr_tok.type_ = TokenType::OctalLiteral;
-  curr_tok.cat_  = TokenCategory::Literal;
 
   auto is_octal_digit = [](const char c) -> bool {
     return c >= u8'0' && c <= u8'7';
@@ -799,13 +257,13 @@ inline auto Lexer::token_oct_lit_() -> Token {
       break;
     } if(!is_octal_digit(current_char_())) {
       curr_tok.type_ = TokenType::Illegal;
-      curr_tok.cat_  = TokenCategory::NonCategorical;
       return curr_tok;
     }
     consume_char_(1);
   }
 
   curr_tok.len_ = index_ - curr_tok.pos_;
+  decode_literal_(curr_tok);
   return curr_tok;
 }
 
@@ -825,94 +283,606 @@ inline auto Lexer::token_ambiguous_() -> Token {
   }
 
   const auto start = index_;
-  skip_chars_until_([](const char8_t ch) {
-    return CH_IS_SPACE(ch) || CH_IS_CTRL(ch) || is_reserved_byte(ch);
-  });
+  const char8_t* begin = src_.data();
+  index_ = static_cast<uint32_t>(
+    ByteScanner::find_delimiter(begin + index_, begin + src_.size()) - begin);
+
+  /// A control byte that isn't skipped as whitespace would
+  /// otherwise produce an empty identifier and stall the lexer.
+  if(index_ == start) {
+    consume_char_(1);
+    return Token::illegal(start, 1);
+  }
 
   Token curr_tok;
   curr_tok.pos_  = start;
   curr_tok.len_  = index_ - start;
-  curr_tok.line_ = line_;
 
   const std::u8string_view val = {&src_[start], index_ - start};
   const auto keyword = Lexer::get_keyword(val);
 
   if(keyword.has_value()) {
     curr_tok.type_ = keyword->type;
-    curr_tok.cat_  = keyword->cat;
   } else {
     curr_tok.type_ = TokenType::Identifier;
-    curr_tok.cat_  = TokenCategory::Identifier;
+    intern_(curr_tok);
   }
 
   return curr_tok;
 }
 
-inline auto Lexer::get_keyword(const std::u8string_view& str) -> Maybe<Keyword> {
-  if(str.size() > 15) return Nothing;
-  auto tok_cat  = TokenCategory::from_keyword(str);       /// Try and get the category
-  auto tok_type = TokenType::from_keyword(str);           /// Try and get the type
-  if(!tok_cat || !tok_type) return Nothing;               /// Verify they actually exist
-  return Keyword{.type = *tok_type, .cat = *tok_cat};
+auto Lexer::is_reserved_byte(const char8_t c) -> bool {
+  return ByteClass::table[ c ] & ByteClass::Reserved;
 }
 
-inline auto Lexer::skip_chars_until_(std::function<bool(char8_t)> cb) -> bool {
-  while(!cb(current_char_()) && current_char_() != u8'\0') {
-    const char8_t curr = current_char_();
+/// Converts a numeric literal that was just scanned and stores it
+/// in literals_. The token's position is still window-relative.
+/// Tokens that get lexed more than once (lookahead, revert_before)
+/// are only decoded the first time.
+auto Lexer::decode_literal_(const Token& tok) -> void {
+  const SourcePos pos = base_ + tok.pos_;
+  if(!literals_.empty() && pos <= literals_.back().pos) {
+    return;
+  }
+
+  const char* first = reinterpret_cast<const char*>(src_.data()) + SourcePos(tok.pos_);
+  const char* last  = first + tok.len_;
+
+  LiteralValue lit;
+  lit.pos = pos;
 
-    if(curr == '\n')            advance_consume_line_();  /// line feed
-    else if(UTF8_LEADING(curr)) skip_utf8_sequence_();    /// UTF8 codepoint begin
-    else consume_char_(1);                                /// ASCII character
+  std::from_chars_result res{};
+  switch(tok.type_.value) {
+  case TokenType::FloatLiteral:
+    res = std::from_chars(first, last, lit.floating);
+    break;
+  case TokenType::HexLiteral:
+    res = std::from_chars(first + 2, last, lit.integer, 16);
+    break;
+  case TokenType::OctalLiteral:
+    res = std::from_chars(first, last, lit.integer, 8);
+    break;
+  default:
+    ASSERT(tok == TokenType::IntLiteral);
+    res = std::from_chars(first, last, lit.integer, 10);
+    break;
   }
 
-  return current_char_() != u8'\0';
+  lit.in_range = res.ec != std::errc::result_out_of_range;
+  literals_.emplace_back(lit);
 }
 
-auto Lexer::is_reserved_byte(const char8_t c) -> bool {
-  constexpr static auto bytes = []() consteval -> auto {
-    constexpr char8_t chars[] = {
-      u8';', u8'(',  u8')',  u8'{', u8'}', u8',', u8'-', u8'+', u8'*',
-      u8'/', u8'%',  u8'=',  u8'<', u8'>', u8'&', u8'|', u8'!', u8'~',
-      u8'^', u8'\'', u8'"',  u8'`', u8'[', u8']', u8'?', u8':', u8'#',
-      u8'@', u8'.',  u8'\\', u8'$', u8'\0'
-    };
+auto Lexer::literal(const Token& tok) const -> Maybe<LiteralValue> {
+  const SourcePos pos = tok.pos_;
+  const auto it = std::lower_bound(
+    literals_.begin(), literals_.end(), pos,
+    [](const LiteralValue& lit, const SourcePos p) { return lit.pos < p; });
+
+  if(it == literals_.end() || it->pos != pos) return Nothing;
+  return *it;
+}
 
-    std::array<bool, 256> table = { false };
-    for(const char8_t ch : chars) { table[ch] = true; }
-    return table;
-  }();
+/// Interns an identifier or string literal that was just scanned,
+/// with the same first-time-only rule as decode_literal_().
+auto Lexer::intern_(const Token& tok) -> void {
+  const SourcePos pos = base_ + tok.pos_;
+  if(!interning_ || (!interned_.empty() && pos <= interned_.back().pos)) {
+    return;
+  }
+
+  const char* data = reinterpret_cast<const char*>(src_.data()) + SourcePos(tok.pos_);
+  std::string_view text{ data, tok.len_ };
+  std::string unescaped;
+
+  /// Strings without escapes or UTF-8 can skip
+  /// the unescaping step, that's most of them.
+  if(tok == TokenType::StringLiteral) {
+    text = text.substr(1, text.size() - 2);
+    const bool plain = std::ranges::none_of(text, [](const char ch) {
+      return ch == '\\' || static_cast<uint8_t>(ch) >= 0x80;
+    });
+
+    if(!plain) {
+      auto res = unescape_quoted_string({ data, tok.len_ });
+      if(!res.has_value()) return;        /// The parser reports it.
+      unescaped = std::move(res.value());
+      text = unescaped;
+    }
+  }
+
+  if(text.empty() || text.size() + 1 > string_block) {
+    return;
+  }
 
-  return bytes[ c ] == true;
+  InternedString str;
+  str.pos   = pos;
+  str.hash  = strings().hash_of(text);
+  str.index = strings().get_index(text, str.hash);
+  interned_.emplace_back(str);
 }
 
-inline auto Lexer::skip_utf8_sequence_() -> bool {
-  const auto ch = static_cast<uint8_t>(current_char_());
+auto Lexer::interned(const Token& tok) const -> Maybe<InternedString> {
+  const SourcePos pos = tok.pos_;
+  const auto it = std::lower_bound(
+    interned_.begin(), interned_.end(), pos,
+    [](const InternedString& str, const SourcePos p) { return str.pos < p; });
 
-  if ((ch & 0xE0) == 0xC0)      consume_char_(2); /// 2 byte codepoint.
-  else if ((ch & 0xF0) == 0xE0) consume_char_(3); /// 3 byte codepoint.
-  else if ((ch & 0xF8) == 0xF0) consume_char_(4); /// 4 byte codepoint.
-  else return false;                              /// Something's wrong?
+  if(it == interned_.end() || it->pos != pos) return Nothing;
+  return *it;
+}
+
+auto Lexer::strings() -> StringPool& {
+  if(strings_ == nullptr) {
+    strings_ = std::make_unique<StringPool>(string_block, string_seed);
+  }
+
+  return *strings_;
+}
+
+FORCEINLINE_ auto Lexer::produce_() -> Token {
+  return mode_ == LexMode::Streaming
+    ? produce_streaming_()
+    : produce_impl_();
+}
+
+auto Lexer::note_newlines_(const uint32_t from, const uint32_t to) -> void {
+  if(base_ + to <= line_starts_.back()) {
+    return;                               /// Already recorded.
+  }
+
+  const char8_t* data = src_.data();
+  const char8_t* p    = data + from;
+  const char8_t* end  = data + to;
+  while((p = static_cast<const char8_t*>(std::memchr(p, '\n', end - p))) != nullptr) {
+    ++p;
+    note_line_start_(base_ + (p - data));
+  }
+}
+
+auto Lexer::line_col(const SourcePos pos) const -> LineCol {
+  const auto it   = std::upper_bound(line_starts_.begin(), line_starts_.end(), pos);
+  const auto line = static_cast<size_t>(it - line_starts_.begin());
+  return LineCol{
+    .line   = static_cast<uint32_t>(line),
+    .column = static_cast<uint32_t>(pos - line_starts_[line - 1] + 1),
+  };
+}
+
+/// The text of a line, without its newline. Lines that have
+/// already slid out of the streaming window come back empty.
+auto Lexer::line_span(const uint32_t line) const -> std::span<const char8_t> {
+  if(line == 0 || line > line_starts_.size()) return {};
+  const SourcePos begin = line_starts_[line - 1];
+  if(begin < base_ || begin - base_ > src_.size()) return {};
+
+  const char8_t* data  = src_.data();
+  const char8_t* first = data + (begin - base_);
+  const char8_t* last  = line < line_starts_.size()
+    ? data + std::min<size_t>(offset_in_window(line_starts_[line] - 1), src_.size())
+    : ByteScanner::find_line_end(first, data + src_.size());
+
+  return { first, static_cast<size_t>(last - first) };
+}
+
+auto Lexer::tokenize_() -> void {
+  toks_.clear();                          /// Rough guess: one token
+  toks_.reserve(src_.size() / 8 + 1);     /// per eight bytes of source.
+  tok_index_ = 0;
+
+  while(true) {
+    const Token tok = produce_impl_();
+    toks_.emplace_back(tok);
+    if(tok == TokenType::EndOfFile) break;
+  }
+
+  curr_ = toks_.front();
+}
+
+/// Lexes one chunk with a throwaway lexer that shares src_.
+/// Lexing depends on nothing but the byte offset it starts at, so
+/// a chunk that starts where the previous one's exit token does
+/// produces exactly the tokens a single serial pass would.
+auto Lexer::lex_chunk_(Chunk_& chunk, const uint32_t from) const -> void {
+  Lexer sub;
+  sub.src_   = src_;
+  sub.index_ = from;
+  sub.interning_ = false;
+
+  chunk.toks.clear();
+  chunk.toks.reserve((chunk.end - chunk.begin) / 8 + 1);
+
+  Token tok   = sub.produce_impl_();
+  chunk.first = tok;
+  while(tok != TokenType::EndOfFile && tok.pos_ < chunk.end) {
+    chunk.toks.emplace_back(tok);
+    tok = sub.produce_impl_();
+  }
+
+  chunk.exit  = tok;
+  chunk.lines = std::move(sub.line_starts_);
+  chunk.literals = std::move(sub.literals_);
+}
+
+///
+/// Splits the buffer at newlines and lexes every chunk speculatively,
+/// as if the chunk start were a token boundary with no open string or
+/// comment. Stitching then checks that each chunk picks up exactly
+/// where the one before it stopped. A chunk that doesn't is lexed again
+/// from the correct offset (on this thread) before it's used. Each chunk
+/// also brings the line starts it saw, which are merged into one index.
+/// Identifiers and strings are interned while stitching, since the
+/// StringPool isn't thread safe.
+auto Lexer::tokenize_parallel_(ThreadPool& pool, const size_t chunk) -> void {
+  ASSERT(chunk > 0);
+  const char8_t* data = src_.data();
+  const size_t size   = src_.size();
+
+  std::vector<Chunk_> chunks;
+  for(size_t begin = 0; begin < size;) {
+    size_t end = std::min(begin + chunk, size);
+    if(end < size) {
+      end = ByteScanner::find_line_end(data + end, data + size) - data;
+      end = std::min(end + 1, size);
+    }
+
+    Chunk_& c = chunks.emplace_back();
+    c.begin = static_cast<uint32_t>(begin);
+    c.end   = static_cast<uint32_t>(end);
+    begin   = end;
+  }
+
+  pool.parallel_for(chunks.size(), [&](const size_t i) {
+    lex_chunk_(chunks[i], chunks[i].begin);
+  });
+
+  size_t total = 1;
+  for(const Chunk_& c : chunks) total += c.toks.size();
+
+  toks_.clear();
+  toks_.reserve(total);
+  tok_index_ = 0;
+
+  for(size_t i = 0; i < chunks.size(); i++) {
+    Chunk_& c = chunks[i];
+    if(i > 0 && c.first.pos_ != chunks[i - 1].exit.pos_) {
+      lex_chunk_(c, static_cast<uint32_t>(chunks[i - 1].exit.pos_));
+    }
+
+    toks_.insert(toks_.end(), c.toks.begin(), c.toks.end());
+    for(const Token& tok : c.toks) {
+      if(tok == TokenType::Identifier || tok == TokenType::StringLiteral) intern_(tok);
+    }
+
+    for(const SourcePos start : c.lines) {
+      note_line_start_(start);            /// Chunks overlap up to their exit
+    }                                     /// token, this drops the repeats.
+
+    for(const LiteralValue& lit : c.literals) {
+      note_literal_(lit);
+    }
+
+    if(c.exit == TokenType::EndOfFile) {
+      toks_.emplace_back(c.exit);
+      break;
+    }
+  }
+
+  curr_ = toks_.front();
+}
+
+auto Lexer::skip_braces() -> const Token& {
+  ASSERT(curr_ == TokenType::LeftBrace);
+  size_t depth = 0;
+
+  if(mode_ == LexMode::Eager) {
+    const size_t eof = toks_.size() - 1;
+    for(; tok_index_ < eof; tok_index_++) {
+      const Token& tok = toks_[tok_index_];
+      if(tok == TokenType::LeftBrace) ++depth;
+      else if(tok == TokenType::RightBrace && --depth == 0) break;
+    }
 
-  return index_ - 1 < src_.size();
+    curr_ = toks_[tok_index_];
+    return curr_;
+  }
+
+  while(curr_ != TokenType::EndOfFile) {
+    if(curr_ == TokenType::LeftBrace) ++depth;
+    else if(curr_ == TokenType::RightBrace && --depth == 0) break;
+    consume(1);
+  }
+
+  return curr_;
+}
+
+auto Lexer::token_index_of_(const Token& tok) const -> size_t {
+  ASSERT(!toks_.empty());
+  if(tok == TokenType::EndOfFile) {       /// EOF sits at src_.size() - 1, which
+    return toks_.size() - 1;              /// may overlap the token before it.
+  }
+
+  const auto end = toks_.end() - 1;       /// Every other token is strictly
+  const auto it  = std::lower_bound(      /// ordered by its offset.
+    toks_.begin(), end, tok.pos_,
+    [](const Token& t, const SourcePos pos) { return t.pos_ < pos; });
+
+  ASSERT(it != end && it->pos_ == tok.pos_, "Token is not part of this stream.");
+  return static_cast<size_t>(it - toks_.begin());
+}
+
+/// Splices the edit into owned_, copying a mapped file
+/// into it first. The zero padding is restored afterwards.
+auto Lexer::patch_source_(
+  const size_t offset,
+  const size_t removed,
+  const std::span<const char8_t> inserted ) -> void
+{
+  if(src_.data() != owned_.data()) {
+    owned_.assign(src_.begin(), src_.end());
+    mapped_.close();
+  }
+
+  owned_.resize(src_.size());
+  const auto at = owned_.begin() + static_cast<ptrdiff_t>(offset);
+  owned_.erase(at, at + static_cast<ptrdiff_t>(removed));
+  owned_.insert(owned_.begin() + static_cast<ptrdiff_t>(offset), inserted.begin(), inserted.end());
+
+  const size_t size = owned_.size();
+  owned_.resize(size + padding, u8'\0');
+  src_    = { owned_.data(), size };
+  window_ = size;
+}
+
+///
+/// Lexing a token only depends on the bytes from where it starts,
+/// so an edit can't change anything before the first token whose
+/// lookahead reaches it. Re-lexing starts one token earlier than that
+/// (the scan for a token runs up to where the next one starts) and
+/// stops at the first new token that lands on an old token past
+/// the edit. From there on, the old stream is still valid, only shifted.
+/// The line index and the literal and interned-string side tables are
+/// patched the same way: kept before the restart, re-derived up to the
+/// resync point, shifted after it.
+auto Lexer::apply_edit(
+  const size_t offset,
+  const size_t removed,
+  const std::span<const char8_t> inserted ) -> Result<TokenRange>
+{
+  ASSERT(mode_ == LexMode::Eager, "apply_edit() needs a stored token stream.");
+  ASSERT(!toks_.empty());
+
+  const size_t old_size = src_.size();
+  if(offset > old_size || removed > old_size - offset) {
+    return Error(ErrC::InvalidArg, "Edit is out of range.");
+  }
+
+  const size_t new_size = old_size - removed + inserted.size();
+  if(new_size == 0) {
+    return Error(ErrC::InvalidArg, "Edit would leave the source empty.");
+  }
+  if(new_size >= std::numeric_limits<uint32_t>::max()) {
+    return Error(ErrC::InvalidArg, "Edit would make the source too large.");
+  }
+
+  /// The rest of the source is already valid, so an edit can only
+  /// break UTF-8 between the sequences it starts and ends inside of.
+  size_t lo = offset, hi = offset + removed;
+  while(lo > 0 && offset - lo < 3 && (src_[lo] & 0xC0) == 0x80) --lo;
+  while(hi < old_size && hi - (offset + removed) < 3 && (src_[hi] & 0xC0) == 0x80) ++hi;
+
+  std::vector<char8_t> seam(src_.begin() + lo, src_.begin() + offset);
+  seam.insert(seam.end(), inserted.begin(), inserted.end());
+  seam.insert(seam.end(), src_.begin() + offset + removed, src_.begin() + hi);
+  const char8_t* bad = ByteScanner::find_invalid_utf8(seam.data(), seam.data() + seam.size());
+  if(bad != seam.data() + seam.size()) {
+    const size_t at = lo + static_cast<size_t>(bad - seam.data());
+    return Error(ErrC::InvalidArg, fmt("Edit would leave invalid UTF-8 at byte offset {}.", at));
+  }
+
+  /// First token whose scan could have read a byte at `offset`.
+  const auto reach = std::lower_bound(
+    toks_.begin(), toks_.end(), offset,
+    [](const Token& t, const size_t off) { return SourcePos(t.pos_) + lookahead_ < off; });
+
+  const size_t first     = reach == toks_.begin() ? 0 : static_cast<size_t>(reach - toks_.begin()) - 1;
+  const SourcePos restart = first == 0 ? 0 : SourcePos(toks_[first].pos_);
+  const SourcePos edit_end = offset + removed;     /// Old coordinates.
+  const SourcePos new_end  = offset + inserted.size();
+
+  /// Everything at or past the restart point gets re-derived
+  /// or shifted, so take it out of the side tables for now.
+  auto split_at = [restart](auto& table) {
+    const auto it = std::partition_point(table.begin(), table.end(),
+      [restart](const auto& entry) { return entry.pos < restart; });
+    std::remove_cvref_t<decltype(table)> tail(it, table.end());
+    table.erase(it, table.end());
+    return tail;
+  };
+
+  auto old_literals = split_at(literals_);
+  auto old_interned = split_at(interned_);
+
+  /// A line that starts right at the restart point was
+  /// noted before it, so that one stays.
+  const auto kept_lines = std::upper_bound(line_starts_.begin(), line_starts_.end(), restart);
+  const std::vector<SourcePos> old_lines(kept_lines, line_starts_.end());
+  line_starts_.erase(kept_lines, line_starts_.end());
+
+  patch_source_(offset, removed, inserted);
+  index_ = static_cast<uint32_t>(restart);
+  line_  = line_col(restart).line;
+
+  std::vector<Token> fresh;
+  size_t resync = toks_.size();           /// Old index the streams meet at.
+  const size_t old_eof = toks_.size() - 1;
+
+  /// Old position + inserted == new position + removed, written
+  /// this way around so that nothing goes negative.
+  const auto shifted = [&](const Token& t) { return SourcePos(t.pos_) + inserted.size(); };
+
+  for(size_t j = first;;) {
+    const Token tok = produce_impl_();
+    if(tok == TokenType::EndOfFile) {
+      fresh.emplace_back(tok);
+      break;
+    }
+
+    if(SourcePos(tok.pos_) >= new_end) {
+      const SourcePos want = SourcePos(tok.pos_) + removed;
+      while(j < old_eof && shifted(toks_[j]) < want) ++j;
+      if(j < old_eof && shifted(toks_[j]) == want && SourcePos(toks_[j].pos_) >= edit_end) {
+        resync = j;
+        break;
+      }
+    }
+
+    fresh.emplace_back(tok);
+  }
+
+  /// Past the resync point the old stream holds, moved over.
+  const SourcePos resync_pos = resync < toks_.size() ? SourcePos(toks_[resync].pos_) : UINT64_MAX;
+  const auto move_pos = [&](const SourcePos pos) { return pos + inserted.size() - removed; };
+
+  for(size_t i = resync; i < toks_.size(); i++) {
+    toks_[i].pos_ = move_pos(toks_[i].pos_);
+  }
+
+  for(const SourcePos start : old_lines) {
+    if(start > resync_pos) note_line_start_(move_pos(start));
+  }
+
+  /// The resync token itself was already decoded and interned
+  /// again by produce_impl_(), so its old entries are dropped too.
+  for(LiteralValue lit : old_literals) {
+    if(lit.pos <= resync_pos) continue;
+    lit.pos = move_pos(lit.pos);
+    literals_.emplace_back(lit);
+  }
+
+  for(InternedString str : old_interned) {
+    if(str.pos <= resync_pos) continue;
+    str.pos = move_pos(str.pos);
+    interned_.emplace_back(str);
+  }
+
+  const size_t replaced = resync - first;
+  const auto at = toks_.begin() + static_cast<ptrdiff_t>(first);
+  toks_.erase(at, at + static_cast<ptrdiff_t>(replaced));
+  toks_.insert(toks_.begin() + static_cast<ptrdiff_t>(first), fresh.begin(), fresh.end());
+
+  /// Keep the cursor on the same token if it survived,
+  /// otherwise put it at the start of the changed range.
+  if(tok_index_ >= first + replaced) tok_index_ = tok_index_ - replaced + fresh.size();
+  else if(tok_index_ >= first) tok_index_ = first;
+  tok_index_ = std::min(tok_index_, toks_.size() - 1);
+  curr_      = toks_[tok_index_];
+
+  return TokenRange{
+    .begin    = first,
+    .end      = first + fresh.size(),
+    .replaced = replaced,
+  };
 }
 
-auto Lexer::create_shared(std::vector<char8_t>&& buf) -> Result<std::shared_ptr<Lexer>> {
+auto Lexer::create_shared(std::vector<char8_t>&& buf, const LexMode mode)
+  -> Result<std::shared_ptr<Lexer>>
+{
   ASSERT(!buf.empty());
   auto lxr   = std::make_shared<Lexer>();
-  lxr->src_  = std::move(buf);
-  lxr->curr_ = lxr->produce_impl_();
+  lxr->mode_ = mode;
   lxr->file_name_ = _nstr("<buffer>");
+  TRY(lxr->adopt_(std::move(buf)));
+
+  if(mode == LexMode::Eager) lxr->tokenize_();
+  else lxr->curr_ = lxr->produce_();
+  return lxr;
+}
+
+auto Lexer::create_shared(
+  sys::File& ref,
+  const LexMode mode,
+  const size_t window ) -> Result<std::shared_ptr<Lexer>>
+{
+  auto lxr = std::make_shared<Lexer>();
+  lxr->mode_ = mode;
+  if(mode == LexMode::Streaming) TRY(lxr->adopt_stream_(ref, window));
+  else TRY(lxr->adopt_(ref));
+
+  if(mode == LexMode::Eager) lxr->tokenize_();
+  else lxr->curr_ = lxr->produce_();
+  return lxr;
+}
+
+auto Lexer::create_shared(
+  sys::File& ref,
+  sys::MappedFile&& mapped,
+  const LexMode mode ) -> Result<std::shared_ptr<Lexer>>
+{
+  ASSERT(mode != LexMode::Streaming, "A streaming lexer reads the file itself.");
+  auto lxr = std::make_shared<Lexer>();
+  lxr->mode_ = mode;
+  TRY(lxr->adopt_(ref, std::move(mapped)));
+
+  if(mode == LexMode::Eager) lxr->tokenize_();
+  else lxr->curr_ = lxr->produce_();
+  return lxr;
+}
+
+auto Lexer::create_detached(sys::File& ref) -> Result<std::shared_ptr<Lexer>> {
+  auto lxr = std::make_shared<Lexer>();
+  lxr->mode_ = LexMode::Eager;
+  lxr->interning_ = false;
+  TRY(lxr->adopt_(ref));
+  lxr->tokenize_();
   return lxr;
 }
 
-auto Lexer::create_shared(sys::File& ref) -> Result<std::shared_ptr<Lexer>> {
-  ref.seek(0, sys::FSeek::Beg);
+auto Lexer::create_parallel(
+  sys::File& ref,
+  ThreadPool& pool,
+  const size_t chunk ) -> Result<std::shared_ptr<Lexer>>
+{
+  auto lxr = std::make_shared<Lexer>();
+  lxr->mode_ = LexMode::Eager;
+  TRY(lxr->adopt_(ref));
+  lxr->tokenize_parallel_(pool, chunk);
+  return lxr;
+}
+
+auto Lexer::create_parallel(
+  std::vector<char8_t>&& buf,
+  ThreadPool& pool,
+  const size_t chunk ) -> Result<std::shared_ptr<Lexer>>
+{
+  ASSERT(!buf.empty());
+  auto lxr   = std::make_shared<Lexer>();
+  lxr->mode_ = LexMode::Eager;
+  lxr->file_name_ = _nstr("<buffer>");
+  TRY(lxr->adopt_(std::move(buf)));
+  lxr->tokenize_parallel_(pool, chunk);
+  return lxr;
+}
+
+auto Lexer::adopt_(std::vector<char8_t>&& buf) -> Result<void> {
+  const size_t size = buf.size();
+  mapped_.close();
+  owned_ = std::move(buf);
+  owned_.resize(size + padding, u8'\0');
+  src_ = { owned_.data(), size };
+
+  base_   = 0;                  /// The whole buffer is resident,
+  window_ = size;               /// so there's nothing to stream.
+  stream_done_ = true;
+  return check_utf8_(0);
+}
+
+auto Lexer::adopt_(sys::File& ref) -> Result<void> {
   const auto fsize = TRY(ref.size());
 
   /// Check against maximum allowed file size.
   /// No way this is ever true tbh.
-  if(fsize >= std::numeric_limits<uint32_t>::max()) {
-    return Error(ErrC::InvalidArg, "File is too large");
+  if(fsize >= max_resident) {
+    return Error(ErrC::InvalidArg, "File is too large, use LexMode::Streaming.");
   }
 
   /// Check for an empty file.
@@ -922,27 +892,170 @@ auto Lexer::create_shared(sys::File& ref) -> Result<std::shared_ptr<Lexer>> {
     return Error(ErrC::InvalidArg, "File is empty.");
   }
 
-  auto lxr = std::make_shared<Lexer>();
+  return adopt_(ref, TRY(sys::MappedFile::map(ref, padding)));
+}
+
+auto Lexer::adopt_(sys::File& ref, sys::MappedFile&& mapped) -> Result<void> {
+  if(mapped.size() >= max_resident) {
+    return Error(ErrC::InvalidArg, "File is too large, use LexMode::Streaming.");
+  }
+
+  owned_.clear();
+  owned_.shrink_to_fit();
+  mapped_ = std::move(mapped);
+  src_    = mapped_.chars();
+  base_   = 0;
+  window_ = src_.size();
+  stream_done_ = true;
+
 #ifdef N19_WIN32
-  lxr->file_name_ = std::filesystem::absolute(ref.name_).wstring();
+  this->file_name_ = std::filesystem::absolute(ref.name_).wstring();
 #else
-  lxr->file_name_ = std::filesystem::absolute(ref.name_).string();
+  this->file_name_ = std::filesystem::absolute(ref.name_).string();
 #endif
+  return check_utf8_(0);
+}
 
-  lxr->src_.resize(fsize);
-  auto wbytes = as_writable_bytes(lxr->src_);
-  TRY(ref.read_into(wbytes));
-  lxr->curr_ = lxr->produce_impl_();
-  return lxr;
+auto Lexer::adopt_stream_(sys::File& ref, const size_t window) -> Result<void> {
+  ASSERT(window > 0 && window <= std::numeric_limits<uint32_t>::max() / 4);
+  const auto fsize = TRY(ref.size());
+  if(fsize == 0) {
+    return Error(ErrC::InvalidArg, "File is empty.");
+  }
+
+  TRY(ref.seek(0, sys::FSeek::Beg));
+  mapped_.close();
+  stream_ = ref;
+  window_ = window;
+  base_   = 0;
+  index_  = 0;
+  stream_done_ = false;
+  utf8_checked_ = 0;
+  owned_.assign(window_ + padding, u8'\0');
+  src_ = { owned_.data(), 0 };
+  TRY(slide_window_(0));
+
+#ifdef N19_WIN32
+  this->file_name_ = std::filesystem::absolute(ref.name_).wstring();
+#else
+  this->file_name_ = std::filesystem::absolute(ref.name_).string();
+#endif
+  return Result<void>::create();
+}
+
+/// Discards everything in the window before `keep_from`, moves
+/// the rest to the front and tops the window up from the file.
+/// If nothing can be discarded (one token fills the entire window)
+/// the window doubles instead. Fails on a read error, or if
+/// the new bytes aren't valid UTF-8.
+auto Lexer::slide_window_(const uint32_t keep_from) -> Result<void> {
+  ASSERT(keep_from <= index_);
+  const size_t kept = src_.size() - keep_from;
+  if(keep_from > 0) {
+    std::memmove(owned_.data(), owned_.data() + keep_from, kept);
+  }
+
+  base_  += keep_from;
+  index_ -= keep_from;
+  if(kept == window_) {
+    window_ *= 2;
+    owned_.resize(window_ + padding);
+  }
+
+  size_t size = kept;
+  while(size < window_ && !stream_done_) {
+    auto* dest  = reinterpret_cast<Byte*>(owned_.data() + size);
+    auto  count = stream_.read_some(WritableBytes{ dest, window_ - size });
+    if(!count) return Error(ErrC::Native, "Failed to read from the source file.");
+    if(*count == 0) stream_done_ = true;
+    size += *count;
+  }
+
+  std::memset(owned_.data() + size, 0, padding);
+  src_ = { owned_.data(), size };
+  return check_utf8_(std::max(utf8_checked_, base_) - base_);
+}
+
+/// Validates src_ from `from` on. While there's more of the stream
+/// to come, a sequence cut off by the end of the window might just
+/// be incomplete, so it's left for the next slide to look at.
+auto Lexer::check_utf8_(const size_t from) -> Result<void> {
+  const char8_t* begin = src_.data();
+  const char8_t* end   = begin + src_.size();
+  const char8_t* bad   = ByteScanner::find_invalid_utf8(begin + from, end);
+
+  if(bad == end || (!stream_done_ && end - bad < 4)) {
+    utf8_checked_ = base_ + static_cast<SourcePos>(bad - begin);
+    return Result<void>::create();
+  }
+
+  /// Lines are counted on from the cursor, which is never past
+  /// anything unchecked, so streaming reports the same line eager does.
+  const SourcePos pos = base_ + static_cast<SourcePos>(bad - begin);
+  const char8_t* cursor = begin + std::min<size_t>(index_, static_cast<size_t>(bad - begin));
+  const auto line = line_ + std::count(cursor, bad, u8'\n');
+  return Error(ErrC::InvalidArg, fmt("Invalid UTF-8 on line {}, byte offset {}.", line, pos));
+}
+
+/// How far back the window has to reach when it slides. A quarter
+/// of it is kept as history for revert_before(), and a pinned
+/// position (an in-flight peek) is never slid out.
+auto Lexer::keep_from_() const -> uint32_t {
+  const size_t history = window_ / 4;
+  SourcePos keep = base_ + (index_ > history ? index_ - history : 0);
+  keep = std::max(std::min(keep, pin_), base_);
+  return static_cast<uint32_t>(keep - base_);
+}
+
+auto Lexer::produce_streaming_() -> Token {
+  /// A failed slide ends the stream. The error is kept
+  /// for stream_error(), the parser just sees Illegal.
+  const auto slide = [this]() -> bool {
+    auto slid = slide_window_(keep_from_());
+    if(!slid) stream_error_ = slid.release_error();
+    return slid.has_value();
+  };
+
+  while(true) {
+    if(stream_error_.has_value()) {
+      return Token::illegal(base_ + index_, 0);
+    }
+    if(!stream_done_ && src_.size() - index_ < window_ / 2) {
+      if(!slide()) return Token::illegal(base_ + index_, 0);
+    }
+
+    const uint32_t start = index_;
+    const uint32_t line  = line_;
+    Token tok = produce_impl_();
+    tok.pos_ += base_;
+
+    /// A token that ran into the end of the window might continue in
+    /// bytes we haven't read yet. Rewind, pull more in, and lex it again.
+    if(stream_done_ || index_ + lookahead_ < src_.size()) {
+      return tok;
+    }
+
+    /// Anything decoded from the cut-off token is stale.
+    while(!literals_.empty() && literals_.back().pos >= base_ + start) {
+      literals_.pop_back();
+    }
+    while(!interned_.empty() && interned_.back().pos >= base_ + start) {
+      interned_.pop_back();
+    }
+
+    index_ = start;
+    line_  = line;
+    if(!slide()) return Token::illegal(base_ + index_, 0);
+  }
 }
 
 auto Lexer::expect(const TokenCategory cat, const bool cons) -> Result<Token> {
-  if(!current().cat_.isa(cat)) {
+  if(!current().cat().isa(cat)) {
     const auto errc = ErrC::BadToken;
     const auto msg  = fmt(
       "Expected token of kind {}, got {} instead.",
       cat.to_string(),
-      current().cat_.to_string());
+      current().cat().to_string());
     return Error(errc, msg);
   }
 
@@ -967,11 +1080,17 @@ auto Lexer::expect_type(const TokenType type, const bool cons) -> Result<Token>
 }
 
 auto Lexer::consume(const uint32_t amnt) -> const Token& {
+  if(mode_ == LexMode::Eager) {
+    tok_index_ = std::min(tok_index_ + amnt, toks_.size() - 1);
+    curr_ = toks_[tok_index_];
+    return curr_;
+  }
+
   if(curr_ == TokenType::EndOfFile)
     return curr_;
 
   for(uint32_t i = 0; i < amnt; i++) {
-    curr_ = produce_impl_();
+    curr_ = produce_();
     if(curr_ == TokenType::EndOfFile) break;
   }
   
@@ -979,8 +1098,11 @@ auto Lexer::consume(const uint32_t amnt) -> const Token& {
 }
 
 auto Lexer::dump(OStream& stream) -> void {
+  std::string buffer;
   do {
-    stream << curr_.format(*this);
+    buffer.clear();
+    curr_.format_to(*this, buffer);
+    stream << buffer;
     consume(1);
   } while(curr_ != TokenType::EndOfFile && curr_ != TokenType::Illegal);
 
@@ -988,33 +1110,102 @@ auto Lexer::dump(OStream& stream) -> void {
     ErrorCollector::display_error("Illegal token!", *this, curr_, stream);
 }
 
-auto Lexer::reset(sys::File& ref) -> Result<void> {
-  src_.clear();
-  ref.seek(0, sys::FSeek::Beg);
+/// Same walk as dump(), as packed TokenRecords (see Core/TokenDump.hpp).
+/// The end of file or illegal token that stops it is written too,
+/// so a reader can tell how the stream ended.
+auto Lexer::dump_binary(OStream& stream) -> void {
+  const auto header = TokenDumpHeader::make();
+  stream.write(std::as_bytes(std::span{ &header, 1 }));
 
-  const auto fsize = TRY(ref.size());
-  if(fsize >= std::numeric_limits<uint32_t>::max()) {
-    return Error(ErrC::InvalidArg, "File is too large");
-  } if(fsize == 0) {
-    return Error(ErrC::InvalidArg, "File is empty");
+  while(true) {
+    TokenRecord rec{};
+    rec.offset   = SourcePos(curr_.pos_);
+    rec.category = curr_.cat().value;
+    rec.len      = curr_.len_;
+    rec.line     = line_of(curr_);
+    rec.type     = static_cast<uint16_t>(curr_.type_.value);
+    stream.write(std::as_bytes(std::span{ &rec, 1 }));
+
+    if(curr_ == TokenType::EndOfFile || curr_ == TokenType::Illegal) break;
+    consume(1);
   }
+}
 
-  this->src_.resize(fsize);
-  auto wbytes = n19::as_writable_bytes(src_);
-
-#ifdef N19_WIN32
-  this->file_name_ = std::filesystem::absolute(ref.name_).wstring();
-#else
-  this->file_name_ = std::filesystem::absolute(ref.name_).string();
-#endif
-
+auto Lexer::reset(sys::File& ref) -> Result<void> {
   this->curr_  = Token(); /// Reset data members
   this->index_ = 0;       ///
   this->line_  = 1;
+  this->line_starts_.assign(1, 0);
+  this->literals_.clear();
+  this->interned_.clear();
+  this->stream_error_.clear();
+
+  if(mode_ == LexMode::Streaming) TRY(adopt_stream_(ref, default_window));
+  else TRY(adopt_(ref));
 
-  TRY(ref.read_into(wbytes));
-  this->curr_ = produce_impl_();
+  if(mode_ == LexMode::Eager) tokenize_();
+  else this->curr_ = produce_();
   return Result<void>::create();
 }
 
+auto Lexer::reset(Lexer& detached) -> Result<void> {
+  if(mode_ != LexMode::Eager || detached.mode_ != LexMode::Eager) {
+    return Error(ErrC::InvalidArg, "Only eager lexers can swap sources.");
+  }
+
+  ASSERT(!detached.interning_, "Lexer was not created with create_detached().");
+  ASSERT(!detached.toks_.empty());
+
+  owned_       = std::move(detached.owned_);
+  mapped_      = std::move(detached.mapped_);
+  src_         = detached.src_;   /// Both backings keep their address when moved.
+  file_name_   = std::move(detached.file_name_);
+  toks_        = std::move(detached.toks_);
+  line_starts_ = std::move(detached.line_starts_);
+  literals_    = std::move(detached.literals_);
+  utf8_checked_ = detached.utf8_checked_;
+  base_        = 0;
+  window_      = detached.window_;
+  stream_done_ = true;
+  index_       = detached.index_;
+  line_        = detached.line_;
+  tok_index_   = 0;
+  curr_        = toks_.front();
+
+  /// Same as stitching in tokenize_parallel_(): the pool
+  /// isn't thread safe, so interning happens on this side.
+  interned_.clear();
+  for(const Token& tok : toks_) {
+    if(tok == TokenType::Identifier || tok == TokenType::StringLiteral) intern_(tok);
+  }
+
+  detached.src_ = {};
+  detached.curr_ = Token();
+  detached.line_starts_.assign(1, 0);
+  return Result<void>::create();
+}
+
+auto Lexer::swap_source(Lexer& other) -> void {
+  using std::swap;
+  swap(owned_, other.owned_);     /// Both backings keep their
+  swap(mapped_, other.mapped_);   /// address, so src_ stays valid.
+  swap(src_, other.src_);
+  swap(stream_, other.stream_);
+  swap(file_name_, other.file_name_);
+  swap(curr_, other.curr_);
+  swap(index_, other.index_);
+  swap(line_, other.line_);
+  swap(base_, other.base_);
+  swap(pin_, other.pin_);
+  swap(window_, other.window_);
+  swap(stream_done_, other.stream_done_);
+  swap(utf8_checked_, other.utf8_checked_);
+  swap(stream_error_, other.stream_error_);
+  swap(line_starts_, other.line_starts_);
+  swap(literals_, other.literals_);
+  swap(interned_, other.interned_);
+  swap(toks_, other.toks_);
+  swap(tok_index_, other.tok_index_);
+}
+
 END_NAMESPACE(rl);
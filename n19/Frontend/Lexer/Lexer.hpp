@@ -10,15 +10,21 @@
 #include <n19/Core/Platform.hpp>
 #include <n19/Core/ClassTraits.hpp>
 #include <n19/System/File.hpp>
+#include <n19/System/MappedFile.hpp>
 #include <n19/Core/Result.hpp>
 #include <n19/Core/Maybe.hpp>
 #include <n19/Core/Stream.hpp>
+#include <n19/Core/ThreadPool.hpp>
 #include <n19/Frontend/Lexer/Token.hpp>
+#include <n19/Frontend/Lexer/Scanner.hpp>
+#include <n19/Frontend/Lexer/KeywordTable.hpp>
+#include <n19/Frontend/Lexer/OperatorTable.hpp>
 #include <n19/System/String.hpp>
 #include <memory>
 #include <vector>
+#include <span>
 #include <array>
-#include <functional>
+#include <algorithm>
 #include <string_view>
 #include <cctype>
 #include <cstdint>
@@ -32,27 +38,146 @@
 BEGIN_NAMESPACE(rl);
 using namespace n19;
 
+///
+/// Eager:    the whole buffer is tokenized up front into a
+///           contiguous array. consume(), peek() and revert_before()
+///           become index moves over that array.
+/// OnDemand: tokens are produced one at a time as the parser asks for
+///           them. Lookahead re-lexes and throws the work away.
+/// Streaming: like OnDemand, but only a fixed-size window of the file
+///           is resident. The window slides forward as tokens are
+///           consumed, so memory stays bounded for any input size, files
+///           over 4 GiB included. revert_before() only reaches tokens
+///           that are still inside the window.
+enum class LexMode : uint8_t {
+  Eager     = 0,
+  OnDemand  = 1,
+  Streaming = 2,
+};
+
+///
+/// What Lexer::apply_edit() changed. Tokens [begin, end) of the
+/// new stream replace tokens [begin, begin + replaced) of the old
+/// one. Every token after that is the same as before, just moved
+/// by however many bytes the edit added or removed.
+struct TokenRange {
+  size_t begin    = 0;
+  size_t end      = 0;
+  size_t replaced = 0;
+};
+
 class Lexer final : public std::enable_shared_from_this<Lexer> {
   N19_MAKE_NONCOPYABLE(Lexer);
   N19_MAKE_COMPARABLE_MEMBER(Lexer, file_name_);
+  friend class TokenCache;
 public:
   auto current() const        -> const Token&;
   auto consume(uint32_t amnt) -> const Token&;
   auto get_bytes() const      -> Bytes;
   auto dump(OStream& stream)  -> void;
+  auto dump_binary(OStream& stream) -> void;
   auto revert_before(const Token&) -> void;
 
+  /// With the current token on a '{', moves to the '}' that
+  /// closes it without looking at anything in between. Stops
+  /// at EOF if the braces don't balance.
+  auto skip_braces() -> const Token&;
+
   template<size_t sz_>
   auto batched_peek()         -> std::array<Token, sz_>;
   auto peek(uint32_t amnt)    -> Token;
 
   auto reset(sys::File& ref) -> Result<void>;
+
+  /// Takes over the source and token stream of a lexer made by
+  /// create_detached(), leaving it empty. Identifiers and strings
+  /// are interned now, into this lexer's pool. LexMode::Eager only.
+  auto reset(Lexer& detached) -> Result<void>;
+
+  /// Trades sources, token streams and cursors with `other`, but
+  /// not string pools: interned entries keep pointing into this
+  /// lexer's pool, so `other` only holds a source until it's
+  /// swapped back. Lets a parser put a file aside and return to it.
+  auto swap_source(Lexer& other) -> void;
   auto expect(TokenCategory cat, bool cons = true)   -> Result<Token>;
   auto expect_type(TokenType type, bool cons = true) -> Result<Token>;
+  auto mode() const -> LexMode;
+  auto base() const -> SourcePos;
+  auto offset_in_window(SourcePos pos) const -> size_t;
+
+  /// Replaces `removed` bytes at `offset` with `inserted` and
+  /// re-lexes only as far as it takes for the token stream to
+  /// line up with the old one again. LexMode::Eager only.
+  auto apply_edit(
+    size_t offset,
+    size_t removed,
+    std::span<const char8_t> inserted
+  ) -> Result<TokenRange>;
+
+  /// Queries against the line index. It covers everything
+  /// lexed so far, which in LexMode::Eager is the whole file.
+  auto line_col(SourcePos pos) const -> LineCol;
+  auto line_span(uint32_t line) const -> std::span<const char8_t>;
+  auto line_count() const -> uint32_t;
+  auto line_of(const Token& tok) const -> uint32_t;
+
+  /// The decoded value of a numeric literal token,
+  /// or Nothing if `tok` isn't one.
+  auto literal(const Token& tok) const -> Maybe<LiteralValue>;
+
+  /// The interned spelling of an identifier or string literal
+  /// token. Nothing for other tokens, and for "" (the pool
+  /// doesn't hold empty strings).
+  auto interned(const Token& tok) const -> Maybe<InternedString>;
+  auto strings() -> StringPool&;
+
+  /// How many entries the two side tables above hold.
+  auto literal_count()  const -> size_t;
+  auto interned_count() const -> size_t;
+
+  /// Why a LexMode::Streaming lexer produced an Illegal token
+  /// where the source wasn't one: the window couldn't be refilled,
+  /// or the new bytes weren't valid UTF-8. Eager creation fails
+  /// with the same error instead.
+  auto stream_error() const -> const Maybe<Error>&;
+
+  /// Every source is checked to be valid UTF-8 once, up front (a
+  /// window at a time when streaming). Creation fails with the offset
+  /// of the first malformed sequence, and past that point the lexer
+  /// treats any byte >= 0x80 as part of an identifier or string.
+  static auto create_shared(
+    sys::File& ref,
+    LexMode mode  = LexMode::Eager,
+    size_t window = default_window
+  ) -> Result<std::shared_ptr<Lexer>>;
+
+  static auto create_shared(std::vector<char8_t>&& buf, LexMode = LexMode::Eager)
+    -> Result<std::shared_ptr<Lexer>>;
 
-  static auto create_shared(sys::File& ref)              -> Result<std::shared_ptr<Lexer>>;
-  static auto create_shared(std::vector<char8_t>&& buf)  -> Result<std::shared_ptr<Lexer>>;
-  static auto get_keyword(const std::u8string_view& str) -> Maybe<struct Keyword>;
+  /// Takes over a mapping of `ref` that the caller already made,
+  /// with at least `padding` bytes of padding. Not for streaming.
+  static auto create_shared(sys::File& ref, sys::MappedFile&& mapped, LexMode = LexMode::Eager)
+    -> Result<std::shared_ptr<Lexer>>;
+
+  /// An eager lexer that never touches a StringPool, so it can be
+  /// built on any thread. It's meant to be handed to reset(Lexer&).
+  static auto create_detached(sys::File& ref) -> Result<std::shared_ptr<Lexer>>;
+
+  /// Same result as LexMode::Eager, but the buffer is split
+  /// into line-aligned chunks that are tokenized on the pool.
+  static auto create_parallel(
+    sys::File& ref,
+    ThreadPool& pool,
+    size_t chunk = default_chunk
+  ) -> Result<std::shared_ptr<Lexer>>;
+
+  static auto create_parallel(
+    std::vector<char8_t>&& buf,
+    ThreadPool& pool,
+    size_t chunk = default_chunk
+  ) -> Result<std::shared_ptr<Lexer>>;
+
+  static auto get_keyword(const std::u8string_view& str) -> Maybe<Keyword>;
   static auto is_reserved_byte(char8_t c)                -> bool;
 
   Lexer() = default;
@@ -61,109 +186,200 @@ private:
   char8_t current_char_() const;
   void consume_char_(uint32_t);
   void advance_line_();
+  void note_line_start_(SourcePos pos);
+  void note_newlines_(uint32_t from, uint32_t to);
+  void note_literal_(const LiteralValue& lit);
+  void decode_literal_(const Token& tok);
+  void intern_(const Token& tok);
   void skip_comment_();
+  void skip_space_();
   void advance_consume_line_();
-  bool skip_chars_until_(std::function<bool(char8_t)> cb);
-  bool skip_utf8_sequence_();
   char8_t peek_char_(uint32_t amnt = 1) const;
 
+  struct Chunk_ {
+    uint32_t begin = 0;
+    uint32_t end   = 0;
+    std::vector<Token> toks;   /// Tokens that start inside [begin, end).
+    Token first;               /// First token lexed, may equal exit.
+    Token exit;                /// First token at or past end, or EOF.
+    std::vector<SourcePos> lines; /// Line starts seen while lexing.
+    std::vector<LiteralValue> literals;
+  };
+
+  auto tokenize_()        -> void;
+  auto tokenize_parallel_(ThreadPool& pool, size_t chunk) -> void;
+  auto lex_chunk_(Chunk_& chunk, uint32_t from) const -> void;
+  auto produce_()         -> Token;
+  auto produce_streaming_() -> Token;
+  auto slide_window_(uint32_t keep_from) -> Result<void>;
+  auto check_utf8_(size_t from) -> Result<void>;
+  auto keep_from_() const -> uint32_t;
+  auto token_index_of_(const Token&) const -> size_t;
+  auto patch_source_(size_t offset, size_t removed, std::span<const char8_t> inserted) -> void;
   auto produce_impl_()    -> Token;
-  auto token_hyphen_()    -> Token;
-  auto token_plus_()      -> Token;
-  auto token_asterisk_()  -> Token;
-  auto token_fwdslash_()  -> Token;
-  auto token_percent_()   -> Token;
-  auto token_equals_()    -> Token;
-  auto token_lthan_()     -> Token;
+  auto token_operator_()  -> Token;
   auto token_null_()      -> Token;
-  auto token_tilde_()     -> Token;
-  auto token_at_()        -> Token;
-  auto token_money_()     -> Token;
-  auto token_lsqbrckt_()  -> Token;
-  auto token_rsqbrckt_()  -> Token;
-  auto token_semicolon_() -> Token;
-  auto token_lparen_()    -> Token;
-  auto token_rparen_()    -> Token;
-  auto token_lbrace_()    -> Token;
-  auto token_rbrace_()    -> Token;
-  auto token_comma_()     -> Token;
-  auto token_gthan_()     -> Token;
-  auto token_ampersand_() -> Token;
-  auto token_pipe_()      -> Token;
-  auto token_bang_()      -> Token;
-  auto token_uparrow_()   -> Token;
   auto token_quote_()     -> Token;
   auto token_squote_()    -> Token;
-  auto token_colon_()     -> Token;
-  auto token_dot_()       -> Token;
   auto token_ambiguous_() -> Token;
   auto token_hex_lit_()   -> Token;
   auto token_num_lit_()   -> Token;
   auto token_oct_lit_()   -> Token;
 public:
-  std::vector<char8_t> src_;
+  /// Every source buffer is followed by at least this many
+  /// readable zero bytes, so '\0' acts as a sentinel and the
+  /// character accessors never need a bounds check.
+  constexpr static size_t padding = 64;
+
+  /// Files this large or larger only open in LexMode::Streaming,
+  /// the other modes keep whole-file offsets in 32 bits.
+  constexpr static size_t max_resident = UINT32_MAX;
+
+  /// Initial window size for LexMode::Streaming. Grows
+  /// only if a single token doesn't fit inside it.
+  constexpr static size_t default_window = 1 << 20;
+
+  /// Target chunk size for create_parallel(). Chunks are
+  /// extended to the next newline, so they're never smaller.
+  constexpr static size_t default_chunk = 256 * 1024;
+
+  /// Block size and hash seed for the StringPool. Longer
+  /// identifiers and strings just aren't interned.
+  constexpr static size_t string_block  = 64 * 1024;
+  constexpr static uint32_t string_seed = 0x6e313921;
+
+  std::span<const char8_t> src_;  /// Borrowed from owned_ or mapped_.
+                                  /// In streaming mode, only the window.
   Token curr_;
   sys::String file_name_;
   uint32_t index_  = 0;
   uint32_t line_   = 1;
-};
+private:
+  auto adopt_(std::vector<char8_t>&& buf) -> Result<void>;
+  auto adopt_(sys::File& file) -> Result<void>;
+  auto adopt_(sys::File& file, sys::MappedFile&& mapped) -> Result<void>;
+  auto adopt_stream_(sys::File& file, size_t window) -> Result<void>;
 
-struct Keyword {
-  TokenType type;
-  TokenCategory cat;
+  constexpr static SourcePos no_pin_ = UINT64_MAX;
+  constexpr static uint32_t lookahead_ = 4;  /// Bytes a token may inspect past its end.
+
+  std::vector<char8_t> owned_;    /// Backing storage for buffer sources.
+  sys::MappedFile mapped_;        /// Backing storage for file sources.
+  sys::File stream_;              /// Where new bytes come from (LexMode::Streaming).
+  SourcePos base_ = 0;            /// Absolute offset of src_[0].
+  SourcePos pin_  = no_pin_;      /// Bytes from here on can't be slid out.
+  size_t window_  = 0;            /// Streaming window capacity.
+  bool stream_done_ = true;       /// Nothing left to read into the window.
+  SourcePos utf8_checked_ = 0;    /// Everything before this is valid UTF-8.
+  Maybe<Error> stream_error_;     /// Set when a slide fails, see stream_error().
+  std::vector<SourcePos> line_starts_{ 0 }; /// Offset where line N + 1 begins.
+  std::vector<LiteralValue> literals_;      /// Ordered by position.
+  std::vector<InternedString> interned_;    /// Ordered by position.
+  std::unique_ptr<StringPool> strings_;     /// Created on first use.
+  bool interning_ = true;         /// Off for the chunk lexers in create_parallel().
+  std::vector<Token> toks_;       /// Token stream (LexMode::Eager only).
+  size_t tok_index_ = 0;          /// Cursor into toks_.
+  LexMode mode_ = LexMode::Eager; ///
 };
 
 FORCEINLINE_ auto Lexer::peek(const uint32_t amnt) -> Token {
-  const uint32_t line_tmp  = this->line_;
-  const size_t   index_tmp = this->index_;
-  const Token    tok_tmp   = this->curr_;
+  if(mode_ == LexMode::Eager) {
+    return toks_[ std::min(tok_index_ + amnt, toks_.size() - 1) ];
+  }
+
+  const uint32_t  line_tmp  = this->line_;
+  const SourcePos index_tmp = this->base_ + this->index_;
+  const Token     tok_tmp   = this->curr_;
 
+  pin_ = index_tmp;          /// Keep the window from sliding past us.
   consume(amnt);
   const Token peeked = curr_;
 
+  this->pin_   = no_pin_;
   this->line_  = line_tmp;   /// Restore line
-  this->index_ = index_tmp;  /// Restore index
+  this->index_ = static_cast<uint32_t>(index_tmp - base_);
   this->curr_  = tok_tmp;    /// Restore current token
   return peeked;             ///
 }
 
 template<size_t sz_>
 FORCEINLINE_ auto Lexer::batched_peek() -> std::array<Token, sz_> {
-  const uint32_t line_tmp  = this->line_;
-  const size_t   index_tmp = this->index_;
-  const Token    tok_tmp   = this->curr_;
+  if(mode_ == LexMode::Eager) {
+    std::array<Token, sz_> toks{};
+    for(size_t i = 0; i < toks.size(); i++) {
+      toks[i] = toks_[ std::min(tok_index_ + i + 1, toks_.size() - 1) ];
+    }
+    return toks;
+  }
+
+  const uint32_t  line_tmp  = this->line_;
+  const SourcePos index_tmp = this->base_ + this->index_;
+  const Token     tok_tmp   = this->curr_;
 
+  pin_ = index_tmp;          /// Keep the window from sliding past us.
   std::array<Token, sz_> toks{};
   for(size_t i = 0; i < toks.size(); i++) {
     toks[i] = consume(1);
   }
 
+  this->pin_   = no_pin_;
   this->line_  = line_tmp;   /// Restore line
-  this->index_ = index_tmp;  /// Restore index
+  this->index_ = static_cast<uint32_t>(index_tmp - base_);
   this->curr_  = tok_tmp;    /// Restore current token
   return toks;               /// possibly expensive copy
 }
 
 inline auto Lexer::revert_before(const Token& tok) -> void {
+  if(mode_ == LexMode::Eager) {
+    tok_index_   = token_index_of_(tok);
+    this->curr_  = toks_[tok_index_];
+    return;
+  }
+
+  /// Resume scanning just past the token, so that the next
+  /// consume() yields the one after it, same as in Eager mode.
+  ASSERT(tok.pos_ >= base_, "Token has already left the lexer's window.");
+  const SourcePos resume = tok.pos_ + tok.len_;
   this->curr_  = tok;
-  this->line_  = tok.line_;
-  this->index_ = tok.pos_;
+  this->line_  = line_col(resume).line;
+  this->index_ = static_cast<uint32_t>(resume - base_);
 }
 
 inline auto Lexer::skip_comment_() -> void {
-  skip_chars_until_([](const char8_t ch) {
-    return ch == '\n' || ch == '\0';
-  });
+  const char8_t* begin = src_.data();
+  const char8_t* end   = ByteScanner::find_line_end(begin + index_, begin + src_.size());
+  index_ = static_cast<uint32_t>(end - begin);
 }
 
-inline auto Lexer::current_char_() const -> char8_t {
-  return index_ >= src_.size()
-    ? u8'\0' : src_[index_];
+inline auto Lexer::skip_space_() -> void {
+  const uint32_t line  = line_;
+  const uint32_t from  = index_;
+  const char8_t* begin = src_.data();
+  const char8_t* end   = ByteScanner::skip_space(begin + index_, begin + src_.size(), line_);
+  index_ = static_cast<uint32_t>(end - begin);
+  if(line_ != line) note_newlines_(from, index_);
+}
+
+/// Line starts are only ever appended, so re-lexing a region
+/// after a revert or a peek doesn't record anything twice.
+inline auto Lexer::note_line_start_(const SourcePos pos) -> void {
+  if(pos > line_starts_.back()) line_starts_.emplace_back(pos);
 }
 
+inline auto Lexer::note_literal_(const LiteralValue& lit) -> void {
+  if(literals_.empty() || lit.pos > literals_.back().pos) literals_.emplace_back(lit);
+}
+
+FORCEINLINE_ auto Lexer::get_keyword(const std::u8string_view& str) -> Maybe<Keyword> {
+  return KeywordTable::lookup(str);
+}
+
+inline auto Lexer::current_char_() const -> char8_t {
+  return src_.data()[ index_ ];           /// Past the end we land in
+}                                         /// the zero padding.
+
 inline auto Lexer::peek_char_(const uint32_t amnt) const -> char8_t {
-  return (index_ + amnt) >= src_.size()
-    ? u8'\0' : src_[index_ + amnt];
+  return src_.data()[ index_ + amnt ];
 }
 
 inline auto Lexer::consume_char_(const uint32_t amnt) -> void {
@@ -171,11 +387,14 @@ inline auto Lexer::consume_char_(const uint32_t amnt) -> void {
 }
 
 inline auto Lexer::advance_line_() -> void {
-  if(index_ < src_.size()) ++line_;
+  if(index_ < src_.size()) {
+    ++line_;
+    note_line_start_(base_ + index_ + 1);
+  }
 }
 
 inline auto Lexer::advance_consume_line_() -> void {
-  if(index_ < src_.size()) ++line_;
+  advance_line_();
   consume_char_(1);
 }
 
@@ -187,4 +406,40 @@ inline auto Lexer::current() const -> const Token& {
   return curr_;
 }
 
+inline auto Lexer::mode() const -> LexMode {
+  return mode_;
+}
+
+inline auto Lexer::base() const -> SourcePos {
+  return base_;
+}
+
+/// Where an absolute position lands in src_. Positions
+/// that have already left the window clamp to its start.
+inline auto Lexer::offset_in_window(const SourcePos pos) const -> size_t {
+  return pos > base_ ? static_cast<size_t>(pos - base_) : 0;
+}
+
+inline auto Lexer::line_count() const -> uint32_t {
+  return static_cast<uint32_t>(line_starts_.size());
+}
+
+inline auto Lexer::stream_error() const -> const Maybe<Error>& {
+  return stream_error_;
+}
+
+inline auto Lexer::literal_count() const -> size_t {
+  return literals_.size();
+}
+
+inline auto Lexer::interned_count() const -> size_t {
+  return interned_.size();
+}
+
+/// Tokens don't carry a line number, it's
+/// looked up from where the token starts.
+inline auto Lexer::line_of(const Token& tok) const -> uint32_t {
+  return line_col(tok.pos_).line;
+}
+
 END_NAMESPACE(rl);
@@ -0,0 +1,119 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Frontend/Lexer/Token.hpp>
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+BEGIN_NAMESPACE(rl);
+
+///
+/// A DFA over every punctuator and operator spelled in
+/// RL_TOKEN_TYPE_LIST, built at compile time. States are the prefixes
+/// of those spellings. Bytes are first folded into a handful of
+/// columns, so the transition table stays a few hundred bytes.
+/// match() walks it for maximal munch; there is no per-operator code.
+class OperatorTable {
+public:
+  struct Match {
+    TokenType type;
+    uint32_t len = 0;
+  };
+
+  /// `p` must be followed by a zero sentinel (see Lexer::padding),
+  /// reads stop at the first byte that can't extend the match.
+  static constexpr auto match(const char8_t* p) -> Match;
+  static constexpr auto starts(char8_t c) -> bool;
+
+  OperatorTable() = delete;
+private:
+  constexpr static size_t max_states_  = 64;
+  constexpr static size_t max_columns_ = 32;
+  using Row_ = std::array<uint8_t, max_columns_>;
+
+  struct Dfa_ {
+    std::array<uint8_t, 256> column{};                 /// Byte -> column, 0 for "no operator".
+    std::array<Row_, max_states_> next{};              /// 0 is the dead state.
+    std::array<TokenType::Value, max_states_> accept{}; /// None if not accepting.
+    size_t states  = 1;                                 /// State 0 is the root.
+    size_t columns = 1;
+  };
+
+  /// Spellings made only of ASCII punctuation. This leaves out
+  /// keywords, the empty spellings, and EndOfFile's "\0".
+  constexpr static auto is_operator_spelling_(const std::string_view str) -> bool {
+    if(str.empty()) return false;
+    for(const char c : str) {
+      const bool punct = (c >= '!' && c <= '/') || (c >= ':' && c <= '@')
+        || (c >= '[' && c <= '`' && c != '_') || (c >= '{' && c <= '~');
+      if(!punct) return false;
+    }
+
+    return true;
+  }
+
+  static const Dfa_ dfa_;
+};
+
+constexpr OperatorTable::Dfa_ OperatorTable::dfa_ = []() consteval -> Dfa_ {
+  Dfa_ out;
+  auto add = [&out](const std::string_view spelling, const TokenType::Value type) {
+    if(!is_operator_spelling_(spelling)) return;
+    size_t state = 0;
+    for(const char c : spelling) {
+      uint8_t& col = out.column[static_cast<uint8_t>(c)];
+      if(col == 0) {
+        if(out.columns == max_columns_) throw "Too many distinct operator bytes.";
+        col = static_cast<uint8_t>(out.columns++);
+      }
+
+      uint8_t& next = out.next[state][col];
+      if(next == 0) {
+        if(out.states == max_states_) throw "Too many operator prefixes.";
+        next = static_cast<uint8_t>(out.states++);
+      }
+
+      state = next;
+    }
+
+    if(out.accept[state] != TokenType::None) throw "Duplicate operator spelling.";
+    out.accept[state] = type;
+  };
+
+#define X(TYPE, STR, CAT_UNUSED) add(STR, TokenType::TYPE);
+  RL_TOKEN_TYPE_LIST
+#undef X
+  return out;
+}();
+
+FORCEINLINE_ constexpr auto OperatorTable::match(const char8_t* p) -> Match {
+  Match best{ TokenType::None, 0 };
+  size_t state = 0;
+  for(uint32_t len = 1;; len++) {
+    state = dfa_.next[state][ dfa_.column[*p++] ];
+    if(state == 0) break;
+    if(dfa_.accept[state] != TokenType::None) {
+      best = { dfa_.accept[state], len };
+    }
+  }
+
+  return best;
+}
+
+FORCEINLINE_ constexpr auto OperatorTable::starts(const char8_t c) -> bool {
+  return dfa_.next[0][ dfa_.column[c] ] != 0;
+}
+
+static_assert(OperatorTable::match(u8"<<=x").type.value == TokenType::LshiftEq);
+static_assert(OperatorTable::match(u8"..x").len == 2);
+static_assert(OperatorTable::match(u8"->").type.value == TokenType::SkinnyArrow);
+static_assert(!OperatorTable::starts(u8'a') && !OperatorTable::starts(u8'\0'));
+
+END_NAMESPACE(rl);
@@ -0,0 +1,526 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/Lexer/Scanner.hpp>
+#include <n19/Core/Panic.hpp>
+#include <algorithm>
+#include <bit>
+
+#ifdef N19_X86_64
+#  include <immintrin.h>
+#endif
+
+BEGIN_NAMESPACE(rl);
+
+///
+/// Nibble lookup tables for testing a byte against a ByteClass
+/// in a SIMD register ("shufti"). Each distinct row of the class
+/// table (one row per high nibble) gets its own bucket bit.
+/// A byte is in the class iff lo[b & 0xF] & hi[b >> 4] != 0.
+struct NibbleLut {
+  alignas(16) std::array<uint8_t, 16> lo{};
+  alignas(16) std::array<uint8_t, 16> hi{};
+};
+
+template<ByteClass::Value cls_>
+consteval auto make_nibble_lut_() -> NibbleLut {
+  NibbleLut lut{};
+  std::array<uint16_t, 8> buckets{};
+  size_t bucket_count = 0;
+
+  for(size_t hi = 0; hi < 16; hi++) {
+    uint16_t row = 0;
+    for(size_t lo = 0; lo < 16; lo++) {
+      if(ByteClass::table[(hi << 4) | lo] & cls_) row |= (1 << lo);
+    }
+
+    if(row == 0) continue;
+    size_t b = 0;
+    while(b < bucket_count && buckets[b] != row) ++b;
+    if(b == bucket_count) {
+      if(bucket_count == buckets.size()) throw "ByteClass has too many distinct rows.";
+      buckets[bucket_count++] = row;
+    }
+
+    lut.hi[hi] = static_cast<uint8_t>(1 << b);
+  }
+
+  for(size_t b = 0; b < bucket_count; b++) {
+    for(size_t lo = 0; lo < 16; lo++) {
+      if(buckets[b] & (1 << lo)) lut.lo[lo] |= static_cast<uint8_t>(1 << b);
+    }
+  }
+
+  return lut;
+}
+
+constexpr NibbleLut delimiter_lut = make_nibble_lut_<ByteClass::Delimiter>();
+constexpr NibbleLut space_lut     = make_nibble_lut_<ByteClass::Space>();
+
+///
+/// Tables for the vectorized UTF-8 validator (Keiser & Lemire,
+/// "Validating UTF-8 In Less Than One Instruction Per Byte").
+/// Every byte is checked against the one before it with three
+/// nibble lookups: the high and low nibble of the previous byte
+/// and the high nibble of this one. Each bit is one kind of error,
+/// and it only survives the AND if all three lookups agree on it.
+/// Third and fourth bytes are checked separately, by looking two
+/// and three bytes back for a lead byte that needs them.
+struct Utf8Lut {
+  alignas(16) std::array<uint8_t, 16> byte_1_high{};
+  alignas(16) std::array<uint8_t, 16> byte_1_low{};
+  alignas(16) std::array<uint8_t, 16> byte_2_high{};
+};
+
+constexpr Utf8Lut utf8_lut = []() consteval -> Utf8Lut {
+  constexpr uint8_t too_short  = 1 << 0;  /// Lead byte followed by a non-continuation.
+  constexpr uint8_t too_long   = 1 << 1;  /// ASCII followed by a continuation.
+  constexpr uint8_t overlong_3 = 1 << 2;
+  constexpr uint8_t too_large  = 1 << 3;
+  constexpr uint8_t surrogate  = 1 << 4;
+  constexpr uint8_t overlong_2 = 1 << 5;
+  constexpr uint8_t too_large_1000 = 1 << 6;
+  constexpr uint8_t overlong_4 = 1 << 6;
+  constexpr uint8_t two_conts  = 1 << 7;  /// Two continuations in a row.
+  constexpr uint8_t carry = too_short | too_long | two_conts;
+
+  Utf8Lut lut{};
+  lut.byte_1_high = {
+    too_long, too_long, too_long, too_long,     /// 0xxx: ASCII
+    too_long, too_long, too_long, too_long,
+    two_conts, two_conts, two_conts, two_conts, /// 10xx: continuation
+    too_short | overlong_2,                     /// 1100
+    too_short,                                  /// 1101
+    too_short | overlong_3 | surrogate,         /// 1110
+    too_short | too_large | too_large_1000 | overlong_4, /// 1111
+  };
+
+  lut.byte_1_low = {
+    carry | overlong_3 | overlong_2 | overlong_4, /// xxxx0000
+    carry | overlong_2,                           /// xxxx0001
+    carry,
+    carry,
+    carry | too_large,                            /// xxxx0100
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate, /// xxxx1101
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+  };
+
+  lut.byte_2_high = {
+    too_short, too_short, too_short, too_short, /// 0xxx: ASCII
+    too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4, /// 1000
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,                   /// 1001
+    too_long | overlong_2 | two_conts | surrogate  | too_large,                   /// 1010
+    too_long | overlong_2 | two_conts | surrogate  | too_large,                   /// 1011
+    too_short, too_short, too_short, too_short, /// 11xx: lead byte
+  };
+
+  return lut;
+}();
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar fallbacks. These also finish off the tail of every
+// vectorized scan, once fewer than one register's worth remains.
+
+template<ByteClass::Value cls_, bool in_class_>
+FORCEINLINE_ auto find_scalar_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  while(p < end && bool(ByteClass::table[*p] & cls_) != in_class_) ++p;
+  return p;
+}
+
+FORCEINLINE_ auto find_line_end_scalar_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  while(p < end && *p != u8'\n' && *p != u8'\0') ++p;
+  return p;
+}
+
+FORCEINLINE_ auto skip_space_scalar_(
+  const char8_t* p,
+  const char8_t* end,
+  uint32_t& newlines ) -> const char8_t*
+{
+  while(p < end && (ByteClass::table[*p] & ByteClass::Space)) {
+    newlines += (*p == u8'\n');
+    ++p;
+  }
+
+  return p;
+}
+
+FORCEINLINE_ auto find_invalid_utf8_scalar_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  constexpr uint32_t min_cp[] = { 0, 0, 0x80, 0x800, 0x10000 };
+  while(p < end) {
+    const uint8_t lead = *p;
+    if(lead < 0x80) {
+      ++p;
+      continue;
+    }
+
+    size_t len = 0;
+    uint32_t cp = 0;
+    if((lead & 0xE0) == 0xC0)      { len = 2; cp = lead & 0x1F; }
+    else if((lead & 0xF0) == 0xE0) { len = 3; cp = lead & 0x0F; }
+    else if((lead & 0xF8) == 0xF0) { len = 4; cp = lead & 0x07; }
+    else return p;
+
+    if(static_cast<size_t>(end - p) < len) return p;
+    for(size_t i = 1; i < len; i++) {
+      if((p[i] & 0xC0) != 0x80) return p;
+      cp = (cp << 6) | (p[i] & 0x3F);
+    }
+
+    if(cp < min_cp[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return p;
+    p += len;
+  }
+
+  return p;
+}
+
+/// The vectorized validators only know that a block is bad,
+/// not where. The scalar one pinpoints it, starting from the lead
+/// byte of whatever sequence runs into `p` (at most 3 bytes back).
+FORCEINLINE_ auto utf8_rewind_(const char8_t* begin, const char8_t* p) -> const char8_t* {
+  const char8_t* q = p;
+  while(q > begin && p - q < 3 && (q[-1] & 0xC0) == 0x80) --q;
+  if(q > begin && q[-1] >= 0xC0) return q - 1;
+  return p;
+}
+
+#ifdef N19_X86_64
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SSSE3: 16 bytes per step.
+
+TARGET_("ssse3") FORCEINLINE_
+static auto class_mask_ssse3_(const __m128i v, const NibbleLut& lut) -> uint32_t {
+  const __m128i nib = _mm_set1_epi8(0x0F);
+  const __m128i lo  = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)lut.lo.data()), _mm_and_si128(v, nib));
+  const __m128i hi  = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)lut.hi.data()),
+    _mm_and_si128(_mm_srli_epi16(v, 4), nib));
+  const __m128i out = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+  return ~static_cast<uint32_t>(_mm_movemask_epi8(out)) & 0xFFFF;
+}
+
+TARGET_("ssse3")
+static auto find_delimiter_ssse3_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  for(; p + 16 <= end; p += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)p);
+    const uint32_t hits = class_mask_ssse3_(v, delimiter_lut);
+    if(hits != 0) return p + std::countr_zero(hits);
+  }
+
+  return find_scalar_<ByteClass::Delimiter, true>(p, end);
+}
+
+TARGET_("ssse3")
+static auto find_line_end_ssse3_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  const __m128i lf = _mm_set1_epi8('\n');
+  for(; p + 16 <= end; p += 16) {
+    const __m128i v  = _mm_loadu_si128((const __m128i*)p);
+    const __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    const auto hits  = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+    if(hits != 0) return p + std::countr_zero(hits);
+  }
+
+  return find_line_end_scalar_(p, end);
+}
+
+TARGET_("ssse3")
+static auto skip_space_ssse3_(const char8_t* p, const char8_t* end, uint32_t& newlines)
+  -> const char8_t*
+{
+  const __m128i lf = _mm_set1_epi8('\n');
+  for(; p + 16 <= end; p += 16) {
+    const __m128i v    = _mm_loadu_si128((const __m128i*)p);
+    const uint32_t ws  = class_mask_ssse3_(v, space_lut);
+    const uint32_t nl  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, lf)));
+    if(ws != 0xFFFF) {
+      const int stop = std::countr_zero(~ws);
+      newlines += std::popcount(nl & ((1u << stop) - 1));
+      return p + stop;
+    }
+
+    newlines += std::popcount(nl);
+  }
+
+  return skip_space_scalar_(p, end, newlines);
+}
+
+TARGET_("ssse3")
+static auto find_invalid_utf8_ssse3_(const char8_t* begin, const char8_t* end) -> const char8_t* {
+  const __m128i nib = _mm_set1_epi8(0x0F);
+  const __m128i b1h = _mm_load_si128((const __m128i*)utf8_lut.byte_1_high.data());
+  const __m128i b1l = _mm_load_si128((const __m128i*)utf8_lut.byte_1_low.data());
+  const __m128i b2h = _mm_load_si128((const __m128i*)utf8_lut.byte_2_high.data());
+
+  /// Nonzero in the last three lanes if a sequence
+  /// that starts there can't have finished yet.
+  const __m128i max_complete = _mm_setr_epi8(
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+
+  __m128i prev = _mm_setzero_si128();
+  const char8_t* p = begin;
+  for(; p + 16 <= end; p += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)p);
+    const __m128i incomplete = _mm_subs_epu8(prev, max_complete);
+
+    /// All ASCII, and nothing left hanging from the last block.
+    if(_mm_movemask_epi8(v) == 0
+      && _mm_movemask_epi8(_mm_cmpeq_epi8(incomplete, _mm_setzero_si128())) == 0xFFFF) {
+      prev = v;
+      continue;
+    }
+
+    const __m128i prev1 = _mm_alignr_epi8(v, prev, 15);
+    const __m128i prev2 = _mm_alignr_epi8(v, prev, 14);
+    const __m128i prev3 = _mm_alignr_epi8(v, prev, 13);
+
+    const __m128i special = _mm_and_si128(
+      _mm_and_si128(
+        _mm_shuffle_epi8(b1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), nib)),
+        _mm_shuffle_epi8(b1l, _mm_and_si128(prev1, nib))),
+      _mm_shuffle_epi8(b2h, _mm_and_si128(_mm_srli_epi16(v, 4), nib)));
+
+    const __m128i must_be_cont = _mm_or_si128(
+      _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80))),   /// 111xxxxx two back
+      _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80))));  /// 1111xxxx three back
+
+    const __m128i err = _mm_xor_si128(
+      _mm_and_si128(must_be_cont, _mm_set1_epi8(char(0x80))), special);
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) != 0xFFFF) {
+      return find_invalid_utf8_scalar_(utf8_rewind_(begin, p), end);
+    }
+
+    prev = v;
+  }
+
+  return find_invalid_utf8_scalar_(utf8_rewind_(begin, p), end);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// AVX2: 32 bytes per step. vpshufb works per 128-bit lane,
+// so the nibble tables are broadcast into both halves.
+// GCC doesn't emit vzeroupper for target("avx2") functions, and
+// the rest of the lexer is legacy SSE. Every exit path clears the
+// upper halves by hand to avoid the AVX/SSE transition penalty.
+
+TARGET_("avx2") FORCEINLINE_
+static auto class_mask_avx2_(const __m256i v, const NibbleLut& lut) -> uint32_t {
+  const __m256i nib = _mm256_set1_epi8(0x0F);
+  const __m256i lo_tbl = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)lut.lo.data()));
+  const __m256i hi_tbl = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)lut.hi.data()));
+  const __m256i lo  = _mm256_shuffle_epi8(lo_tbl, _mm256_and_si256(v, nib));
+  const __m256i hi  = _mm256_shuffle_epi8(hi_tbl, _mm256_and_si256(_mm256_srli_epi16(v, 4), nib));
+  const __m256i out = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+  return ~static_cast<uint32_t>(_mm256_movemask_epi8(out));
+}
+
+TARGET_("avx2")
+static auto find_delimiter_avx2_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  for(; p + 32 <= end; p += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    const uint32_t hits = class_mask_avx2_(v, delimiter_lut);
+    if(hits != 0) {
+      _mm256_zeroupper();
+      return p + std::countr_zero(hits);
+    }
+  }
+
+  _mm256_zeroupper();
+  return find_delimiter_ssse3_(p, end);
+}
+
+TARGET_("avx2")
+static auto find_line_end_avx2_(const char8_t* p, const char8_t* end) -> const char8_t* {
+  const __m256i lf = _mm256_set1_epi8('\n');
+  for(; p + 32 <= end; p += 32) {
+    const __m256i v  = _mm256_loadu_si256((const __m256i*)p);
+    const __m256i eq = _mm256_or_si256(
+      _mm256_cmpeq_epi8(v, lf),
+      _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    const auto hits  = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+    if(hits != 0) {
+      _mm256_zeroupper();
+      return p + std::countr_zero(hits);
+    }
+  }
+
+  _mm256_zeroupper();
+  return find_line_end_ssse3_(p, end);
+}
+
+TARGET_("avx2")
+static auto skip_space_avx2_(const char8_t* p, const char8_t* end, uint32_t& newlines)
+  -> const char8_t*
+{
+  const __m256i lf = _mm256_set1_epi8('\n');
+  for(; p + 32 <= end; p += 32) {
+    const __m256i v    = _mm256_loadu_si256((const __m256i*)p);
+    const uint32_t ws  = class_mask_avx2_(v, space_lut);
+    const uint32_t nl  = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lf)));
+    if(ws != 0xFFFFFFFF) {
+      const int stop = std::countr_zero(~ws);
+      newlines += std::popcount(nl & ((1u << stop) - 1));
+      _mm256_zeroupper();
+      return p + stop;
+    }
+
+    newlines += std::popcount(nl);
+  }
+
+  _mm256_zeroupper();
+  return skip_space_ssse3_(p, end, newlines);
+}
+
+TARGET_("avx2")
+static auto find_invalid_utf8_avx2_(const char8_t* begin, const char8_t* end) -> const char8_t* {
+  const __m256i nib = _mm256_set1_epi8(0x0F);
+  const __m256i b1h = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)utf8_lut.byte_1_high.data()));
+  const __m256i b1l = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)utf8_lut.byte_1_low.data()));
+  const __m256i b2h = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)utf8_lut.byte_2_high.data()));
+
+  const __m256i max_complete = _mm256_setr_epi8(
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+
+  __m256i prev = _mm256_setzero_si256();
+  const char8_t* p = begin;
+  for(; p + 32 <= end; p += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    const __m256i incomplete = _mm256_subs_epu8(prev, max_complete);
+
+    if(_mm256_movemask_epi8(v) == 0
+      && _mm256_movemask_epi8(_mm256_cmpeq_epi8(incomplete, _mm256_setzero_si256())) == -1) {
+      prev = v;
+      continue;
+    }
+
+    /// alignr works per lane, so the lane before the low
+    /// half is the high half of the previous block.
+    const __m256i shifted = _mm256_permute2x128_si256(prev, v, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(v, shifted, 15);
+    const __m256i prev2 = _mm256_alignr_epi8(v, shifted, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(v, shifted, 13);
+
+    const __m256i special = _mm256_and_si256(
+      _mm256_and_si256(
+        _mm256_shuffle_epi8(b1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nib)),
+        _mm256_shuffle_epi8(b1l, _mm256_and_si256(prev1, nib))),
+      _mm256_shuffle_epi8(b2h, _mm256_and_si256(_mm256_srli_epi16(v, 4), nib)));
+
+    const __m256i must_be_cont = _mm256_or_si256(
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80))),
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80))));
+
+    const __m256i err = _mm256_xor_si256(
+      _mm256_and_si256(must_be_cont, _mm256_set1_epi8(char(0x80))), special);
+    if(!_mm256_testz_si256(err, err)) {
+      _mm256_zeroupper();
+      return find_invalid_utf8_scalar_(utf8_rewind_(begin, p), end);
+    }
+
+    prev = v;
+  }
+
+  _mm256_zeroupper();
+  return find_invalid_utf8_scalar_(utf8_rewind_(begin, p), end);
+}
+#endif // N19_X86_64
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Dispatch.
+
+static auto detect_level_() -> SimdLevel {
+#ifdef N19_X86_64
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))  return SimdLevel::AVX2;
+  if(__builtin_cpu_supports("ssse3")) return SimdLevel::SSSE3;
+#endif
+  return SimdLevel::Scalar;
+}
+
+static auto current_level_() -> SimdLevel& {
+  static SimdLevel level = detect_level_();
+  return level;
+}
+
+auto ByteScanner::max_level() -> SimdLevel {
+  static const SimdLevel level = detect_level_();
+  return level;
+}
+
+auto ByteScanner::level() -> SimdLevel {
+  return current_level_();
+}
+
+auto ByteScanner::set_level(const SimdLevel lvl) -> SimdLevel {
+  current_level_() = std::min(lvl, max_level());
+  return current_level_();
+}
+
+auto ByteScanner::find_delimiter(const char8_t* begin, const char8_t* end) -> const char8_t* {
+  ASSERT(begin <= end);
+  switch(current_level_()) {
+#ifdef N19_X86_64
+  case SimdLevel::AVX2:  return find_delimiter_avx2_(begin, end);
+  case SimdLevel::SSSE3: return find_delimiter_ssse3_(begin, end);
+#endif
+  default: return find_scalar_<ByteClass::Delimiter, true>(begin, end);
+  }
+}
+
+auto ByteScanner::find_line_end(const char8_t* begin, const char8_t* end) -> const char8_t* {
+  ASSERT(begin <= end);
+  switch(current_level_()) {
+#ifdef N19_X86_64
+  case SimdLevel::AVX2:  return find_line_end_avx2_(begin, end);
+  case SimdLevel::SSSE3: return find_line_end_ssse3_(begin, end);
+#endif
+  default: return find_line_end_scalar_(begin, end);
+  }
+}
+
+auto ByteScanner::find_non_xdigit(const char8_t* begin, const char8_t* end) -> const char8_t* {
+  ASSERT(begin <= end);                           /// Hex literals are short, a vector
+  return find_scalar_<ByteClass::XDigit, false>(  /// setup wouldn't pay for itself.
+    begin, end);
+}
+
+auto ByteScanner::skip_space(
+  const char8_t* begin,
+  const char8_t* end,
+  uint32_t& newlines ) -> const char8_t*
+{
+  ASSERT(begin <= end);
+  switch(current_level_()) {
+#ifdef N19_X86_64
+  case SimdLevel::AVX2:  return skip_space_avx2_(begin, end, newlines);
+  case SimdLevel::SSSE3: return skip_space_ssse3_(begin, end, newlines);
+#endif
+  default: return skip_space_scalar_(begin, end, newlines);
+  }
+}
+
+auto ByteScanner::find_invalid_utf8(const char8_t* begin, const char8_t* end) -> const char8_t* {
+  ASSERT(begin <= end);
+  switch(current_level_()) {
+#ifdef N19_X86_64
+  case SimdLevel::AVX2:  return find_invalid_utf8_avx2_(begin, end);
+  case SimdLevel::SSSE3: return find_invalid_utf8_ssse3_(begin, end);
+#endif
+  default: return find_invalid_utf8_scalar_(begin, end);
+  }
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,98 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+BEGIN_NAMESPACE(rl);
+
+///
+/// Per-byte classification flags used by the lexer.
+/// Every scanner below (scalar or vectorized) is driven by
+/// this one table, so they can't drift apart from the lexer.
+struct ByteClass {
+  using Value = uint8_t;
+  constexpr static Value None      = 0;
+  constexpr static Value Reserved  = 1;       /// Lexer::is_reserved_byte
+  constexpr static Value Delimiter = 1 << 1;  /// Ends an identifier.
+  constexpr static Value Space     = 1 << 2;  /// Skipped between tokens.
+  constexpr static Value XDigit    = 1 << 3;  /// [0-9a-fA-F]
+
+  using Table = std::array<Value, 256>;
+  static const Table table;
+  ByteClass() = delete;
+};
+
+constexpr ByteClass::Table ByteClass::table = []() consteval -> Table {
+  constexpr char8_t reserved[] = {
+    u8';', u8'(',  u8')',  u8'{', u8'}', u8',', u8'-', u8'+', u8'*',
+    u8'/', u8'%',  u8'=',  u8'<', u8'>', u8'&', u8'|', u8'!', u8'~',
+    u8'^', u8'\'', u8'"',  u8'`', u8'[', u8']', u8'?', u8':', u8'#',
+    u8'@', u8'.',  u8'\\', u8'$', u8'\0'
+  };
+
+  constexpr char8_t space[] = {
+    u8' ', u8'\r', u8'\b', u8'\a', u8'\v', u8'\t', u8'\n'
+  };
+
+  Table out = { ByteClass::None };
+  for(const char8_t ch : reserved) out[ch] |= Reserved | Delimiter;
+  for(const char8_t ch : space)    out[ch] |= Space;
+
+  for(size_t ch = 0; ch < 0x80; ch++) {
+    const bool is_space = ch == ' ' || (ch >= '\t' && ch <= '\r');
+    const bool is_ctrl  = ch < 0x20 || ch == 0x7F;
+    if(is_space || is_ctrl) out[ch] |= Delimiter;
+  }
+
+  for(size_t ch = '0'; ch <= '9'; ch++) out[ch] |= XDigit;
+  for(size_t ch = 'a'; ch <= 'f'; ch++) out[ch] |= XDigit;
+  for(size_t ch = 'A'; ch <= 'F'; ch++) out[ch] |= XDigit;
+  return out;
+}();
+
+enum class SimdLevel : uint8_t {
+  Scalar = 0,  /// Portable table lookups.
+  SSSE3  = 1,  /// 16 bytes per step (needs pshufb).
+  AVX2   = 2,  /// 32 bytes per step.
+};
+
+///
+/// Bulk byte scanners for the lexer's hot loops.
+/// Each one takes a [begin, end) range and returns a pointer to
+/// the first byte that stops the scan, or `end` if none does.
+class ByteScanner {
+public:
+  /// First byte that ends an identifier.
+  static auto find_delimiter(const char8_t* begin, const char8_t* end) -> const char8_t*;
+
+  /// First '\n' or '\0'; used to skip comments.
+  static auto find_line_end(const char8_t* begin, const char8_t* end) -> const char8_t*;
+
+  /// First byte that isn't a hexadecimal digit.
+  static auto find_non_xdigit(const char8_t* begin, const char8_t* end) -> const char8_t*;
+
+  /// First byte that isn't whitespace. `newlines` is incremented
+  /// by the number of line feeds that were skipped over.
+  static auto skip_space(const char8_t* begin, const char8_t* end, uint32_t& newlines)
+    -> const char8_t*;
+
+  /// Start of the first malformed UTF-8 sequence: a stray or missing
+  /// continuation byte, an overlong encoding, a surrogate, anything
+  /// above U+10FFFF, or a sequence cut off by `end`.
+  static auto find_invalid_utf8(const char8_t* begin, const char8_t* end) -> const char8_t*;
+
+  static auto max_level() -> SimdLevel;   /// Best level this CPU supports.
+  static auto level() -> SimdLevel;       /// Level currently in use.
+  static auto set_level(SimdLevel) -> SimdLevel;
+
+  ByteScanner() = delete;
+};
+
+END_NAMESPACE(rl);
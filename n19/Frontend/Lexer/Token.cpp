@@ -6,31 +6,24 @@
 #include <n19/Frontend/Lexer/Lexer.hpp>
 #include <n19/Core/Fmt.hpp>
 #include <n19/Core/Panic.hpp>
-#include <n19/Core/Murmur3.hpp>
+#include <n19/Core/StringUtil.hpp>
 #include <algorithm>
+#include <iterator>
+#include <format>
 #include <new>
 BEGIN_NAMESPACE(rl);
 
-auto Token::eof(
-  const uint32_t pos, const uint32_t line ) -> Token
-{
+auto Token::eof(const SourcePos pos) -> Token {
   Token token;
   token.pos_   = pos;
-  token.line_  = line;
-  token.cat_   = TokenCategory::NonCategorical;
   token.type_  = TokenType::EndOfFile;
   return token;
 }
 
-auto Token::illegal(
-  const uint32_t pos,
-  const uint32_t length, const uint32_t line ) -> Token
-{
+auto Token::illegal(const SourcePos pos, const uint32_t length) -> Token {
   Token token;
   token.len_   = length;
   token.pos_   = pos;
-  token.line_  = line;
-  token.cat_   = TokenCategory::NonCategorical;
   token.type_  = TokenType::Illegal;
   return token;
 }
@@ -38,7 +31,13 @@ auto Token::illegal(
 // Converts a given TokenType's underlying
 // Type enumeration to a string.
 auto TokenType::to_string() const -> std::string {
-  #define X(TYPE, STR) case TokenType::TYPE: return #TYPE;
+  return std::string(name());
+}
+
+// Same as TokenType::to_string(), but the names
+// are static strings, so nothing gets allocated.
+auto TokenType::name() const -> std::string_view {
+  #define X(TYPE, STR, CAT) case TokenType::TYPE: return #TYPE;
   switch(value) {
     RL_TOKEN_TYPE_LIST
     default: return "Unknown"; // Failsafe
@@ -53,7 +52,7 @@ auto TokenType::to_string() const -> std::string {
 // - TokenType::PlusEq becomes "+="
 // etc.
 auto TokenType::string_repr() const -> std::string {
-#define X(TYPE, STR) case TokenType::TYPE: return STR;
+#define X(TYPE, STR, CAT) case TokenType::TYPE: return STR;
   switch(value) {
     RL_TOKEN_TYPE_LIST
     default: return "Unknown"; // Failsafe
@@ -64,18 +63,24 @@ auto TokenType::string_repr() const -> std::string {
 // Converts a given TokenCategory's underlying
 // Type enumeration to a string.
 auto TokenCategory::to_string() const -> std::string {
-  #define X(CAT, UNUSED) if(value & CAT) buff += (std::string(#CAT) + " | ");
-   std::string buff;
-   RL_TOKEN_CATEGORY_LIST
-  #undef X
+  std::string buff;
+  format_to(buff);
+  return buff;
+}
 
-  if(!buff.empty() && buff[buff.size() - 2] == '|') {
-    buff.erase(buff.size() - 3);
-  } else {
-    buff += "NonCategorical";
-  }
+// Appends the flags to `out`, separated by " | ",
+// without building a temporary string per flag.
+auto TokenCategory::format_to(std::string& out) const -> void {
+  const size_t start = out.size();
+  #define X(CAT, UNUSED)                         \
+    if(value & CAT) {                            \
+      if(out.size() != start) out += " | ";      \
+      out += #CAT;                               \
+    }
+  RL_TOKEN_CATEGORY_LIST
+  #undef X
 
-  return buff;
+  if(out.size() == start) out += "NonCategorical";
 }
 
 // Retrieves a TokenCategory value, using a given string
@@ -84,62 +89,69 @@ auto TokenCategory::to_string() const -> std::string {
 auto TokenCategory::from_keyword(const std::u8string_view& str)
 -> Maybe<TokenCategory>
 {
-  constexpr uint32_t seed = 0xbeef;
-  if(str.size() > 15) return Nothing;
-
-  switch(murmur3_x86_32(str, seed)) {
-#define KEYWORD_X(NAME, UNUSED, CAT) case u8##NAME##_mm32: return CAT;
-    LR_KEYWORDS; default: break;
-#undef KEYWORD_X
+  if(const auto* entry = KeywordTable::find(str)) {
+    return entry->kw.cat;
   }
 
   return Nothing;
 }
 
+// The token's text, exactly as it appears in the source
+// buffer. Nothing is copied, so the view is only good for as
+// long as the bytes stay in the lexer's window (always, unless
+// the lexer is in LexMode::Streaming). Empty if len_ is zero.
+auto Token::view(const Lexer& lxr) const -> std::u8string_view {
+  if(len_ == 0) return {};
+  const auto bytes = lxr.src_;
+  const auto pos   = lxr.offset_in_window(pos_);
+  ASSERT(pos_ >= lxr.base());
+  ASSERT(pos < bytes.size());
+  ASSERT(pos + len_ - 1 < bytes.size());
+
+  return { &bytes[pos], len_ };
+}
+
 // Gets a given token's "value". This is the exact
 // way in which it appears in a source file. For example,
 // an identifier of "foo" would be returned as such,
 // a string of "foo". For the plus op it would return "+".
+// Prefer Token::view() unless an owned copy is needed.
 auto Token::value(const Lexer& lxr) const -> Maybe<std::string> {
   if(len_ == 0) return Nothing;
-  const auto bytes = lxr.get_bytes();
-  ASSERT(pos_ < bytes.size());
-  ASSERT(pos_ + len_ - 1 < bytes.size());
-
-  std::string ret;
-  ret.reserve(len_);
-
-  for(size_t i = pos_, j = 0; j < len_; i++, j++) {
-    auto ch = bytes[i];
-    ret += (static_cast<char>(ch));
-  }
-  return ret;
+  return std::string(as_chars(view(lxr)));
 }
 
 // Formats a token into a more readable representation.
 // For debugging/testing purposes only.
 auto Token::format(const Lexer &lxr) const -> std::string {
   std::string buffer;
-  buffer += fmt("{:<12}: ", type_.to_string());
-  buffer += fmt("\"{}\" -- ", value(lxr).value_or("N/A"));
-  buffer += fmt("LINE={},POS={} -- ", line_, pos_);
-  buffer += fmt("{}\n", cat_.to_string());
+  format_to(lxr, buffer);
   return buffer;
 }
 
+// Same as Token::format(), but appends to `out`, so
+// that a caller printing many tokens can reuse one buffer.
+// Once the buffer has grown, this doesn't allocate at all.
+auto Token::format_to(const Lexer& lxr, std::string& out) const -> void {
+  const auto text = as_chars(view(lxr));
+  std::format_to(std::back_inserter(out), "{:<12}: \"{}\" -- LINE={},POS={} -- ",
+    type_.name(),
+    text.empty() ? std::string_view{"N/A"} : text,
+    lxr.line_of(*this),
+    SourcePos(pos_));
+
+  cat().format_to(out);
+  out += '\n';
+}
+
 // Retrieves a TokenType value, using a given string
 // which represents a keyword. The keyword may or may not exist.
 // returns the type if it exists, or Nothing otherwise.
 auto TokenType::from_keyword(const std::u8string_view& keyword)
 -> Maybe<TokenType>
 {
-  constexpr uint32_t seed = 0xbeef;
-  if(keyword.size() > 15) return Nothing;
-
-  switch(murmur3_x86_32(keyword, seed)) {
-#define KEYWORD_X(NAME, TYPE, UNUSED) case u8##NAME##_mm32: return TYPE;
-  LR_KEYWORDS; default: break;
-#undef KEYWORD_X
+  if(const auto* entry = KeywordTable::find(keyword)) {
+    return entry->kw.type;
   }
 
   return Nothing;
@@ -150,46 +162,4 @@ auto Token::is_terminator() const -> bool {
   return type_ == TokenType::Semicolon || type_ == TokenType::Comma;
 }
 
-// TODO
-// operator precedence of a given token.
-auto TokenType::prec() const -> Precedence::Value {
-  switch(this->value) {
-  case ValueAssignment:   return Precedence::max;
-  case PlusEq:            FALLTHROUGH_;
-  case SubEq:             FALLTHROUGH_;
-  case MulEq:             FALLTHROUGH_;
-  case DivEq:             FALLTHROUGH_;
-  case ModEq:             FALLTHROUGH_;
-  case LshiftEq:          FALLTHROUGH_;
-  case RshiftEq:          FALLTHROUGH_;
-  case BitwiseAndEq:      FALLTHROUGH_;
-  case BitwiseOrEq:       FALLTHROUGH_;
-  case XorEq:             return Precedence::max - 1;
-  case LogicalAnd:        return Precedence::max - 2;
-  case LogicalOr:         return Precedence::max - 3;
-  case Mul:               FALLTHROUGH_;
-  case Div:               FALLTHROUGH_;
-  case Mod:               return Precedence::max - 4;
-  case Plus:              FALLTHROUGH_;
-  case Sub:               return Precedence::max - 5;
-  case Lshift:            FALLTHROUGH_;
-  case Rshift:            return Precedence::max - 6;
-  case Lt:                FALLTHROUGH_;
-  case Lte:               FALLTHROUGH_;
-  case Gt:                FALLTHROUGH_;
-  case Gte:               return Precedence::max - 7;
-  case Eq:                FALLTHROUGH_;
-  case Neq:               return Precedence::max - 8;
-  case BitwiseAnd:        return Precedence::max - 9;
-  case Xor:               return Precedence::max - 10;
-  case BitwiseOr:         return Precedence::max - 11;
-  case Dot:               FALLTHROUGH_;
-  case SkinnyArrow:       return Precedence::max - 12;
-  case NamespaceOperator: return Precedence::max - 13;
-  default: break;
-  }
-
-  PANIC("TokenType::prec(): default assertion.");
-}
-
 END_NAMESPACE(rl);
@@ -9,108 +9,111 @@
 #include <n19/Core/ClassTraits.hpp>
 #include <n19/Core/Maybe.hpp>
 #include <n19/Core/Platform.hpp>
+#include <n19/Core/StringPool.hpp>
 #include <n19/Frontend/Lexer/Keywords.hpp>
+#include <n19/Frontend/Common/SourcePos.hpp>
 #include <string_view>
 #include <string>
 #include <cstdint>
 #include <vector>
+#include <array>
 BEGIN_NAMESPACE(rl);
 
 using namespace n19;
 
-#define RL_TOKEN_TYPE_LIST       \
-  X(None, "")                    \
-  X(EndOfFile, "\\0")            \
-  X(Illegal, "")                 \
-  X(Identifier, "")              \
-  X(ValueAssignment, "=")        \
-  X(TypeAssignment, ":")         \
-  X(NamespaceOperator, "::")     \
-  X(Semicolon, ";")              \
-  X(LeftParen, "(")              \
-  X(RightParen, ")")             \
-  X(LeftBrace, "{")              \
-  X(RightBrace, "}")             \
-  X(LeftSqBracket, "[")          \
-  X(RightSqBracket, "]")         \
-  X(Comma, ",")                  \
-  X(Dot, ".")                    \
-  X(DotTwo, "..")                \
-  X(DotThree, "...")             \
-  X(Huh, "?")                    \
-  X(Backslash, "\\")             \
-  X(Money, "$")                  \
-  X(Pound, "#")                  \
-  X(At, "@")                     \
-  X(Eq, "==")                    \
-  X(Neq, "!=")                   \
-  X(Lt, "<")                     \
-  X(Lte, "<=")                   \
-  X(Gt, ">")                     \
-  X(Gte, ">=")                   \
-  X(LogicalAnd, "&&")            \
-  X(LogicalOr, "||")             \
-  X(LogicalNot, "!")             \
-  X(IntLiteral, "")              \
-  X(FloatLiteral, "")            \
-  X(HexLiteral, "")              \
-  X(OctalLiteral, "")            \
-  X(ByteLiteral, "")             \
-  X(BooleanLiteral, "")          \
-  X(StringLiteral, "")           \
-  X(Plus, "+")                   \
-  X(PlusEq, "+=")                \
-  X(Sub, "-")                    \
-  X(SubEq, "-=")                 \
-  X(Mul, "*")                    \
-  X(MulEq, "*=")                 \
-  X(Div, "/")                    \
-  X(DivEq, "/=")                 \
-  X(Mod, "%")                    \
-  X(ModEq, "%=")                 \
-  X(Inc, "++")                   \
-  X(Dec, "--")                   \
-  X(BitwiseNot, "~")             \
-  X(BitwiseAnd, "&")             \
-  X(BitwiseAndEq, "&=")          \
-  X(BitwiseOr, "|")              \
-  X(BitwiseOrEq, "|=")           \
-  X(Xor, "^")                    \
-  X(XorEq, "^=")                 \
-  X(Lshift, "<<")                \
-  X(LshiftEq, "<<=")             \
-  X(Rshift, ">>")                \
-  X(RshiftEq, ">>=")             \
-  X(Proc, "proc")                \
-  X(Let, "let")                  \
-  X(Const, "const")              \
-  X(NullLiteral, "null")         \
-  X(Return, "return")            \
-  X(Break, "break")              \
-  X(Continue, "continue")        \
-  X(For, "for")                  \
-  X(While, "while")              \
-  X(Do, "do")                    \
-  X(If, "if")                    \
-  X(Else, "else")                \
-  X(Struct, "struct")            \
-  X(Enum, "enum")                \
-  X(Switch, "switch")            \
-  X(Case, "case")                \
-  X(Default, "default")          \
-  X(Fallthrough, "fallthrough")  \
-  X(Namespace, "namespace")      \
-  X(Compose, "compose")          \
-  X(Defer, "defer")              \
-  X(DeferIf, "defer_if")         \
-  X(Scope, "scope")              \
-  X(Typeof, "typeof")            \
-  X(Sizeof, "sizeof")            \
-  X(As, "as")                    \
-  X(CompEval, "compeval")        \
-  X(Using, "using")              \
-  X(SkinnyArrow, "->")           \
-  X(FatArrow, "=>")              \
+#define RL_TOKEN_TYPE_LIST                                                       \
+  X(None, "", NonCategorical)                                                    \
+  X(EndOfFile, "\\0", NonCategorical)                                            \
+  X(Illegal, "", NonCategorical)                                                 \
+  X(Identifier, "", Identifier)                                                  \
+  X(ValueAssignment, "=", BinaryOp)                                              \
+  X(TypeAssignment, ":", NonCategorical)                                         \
+  X(NamespaceOperator, "::", UnaryOp | ValidPrefix | BinaryOp)                   \
+  X(Semicolon, ";", Punctuator)                                                  \
+  X(LeftParen, "(", Punctuator | ValidPostfix)                                   \
+  X(RightParen, ")", Punctuator)                                                 \
+  X(LeftBrace, "{", Punctuator)                                                  \
+  X(RightBrace, "}", Punctuator)                                                 \
+  X(LeftSqBracket, "[", Punctuator | ValidPostfix)                               \
+  X(RightSqBracket, "]", Punctuator)                                             \
+  X(Comma, ",", Punctuator | Terminator)                                         \
+  X(Dot, ".", BinaryOp)                                                          \
+  X(DotTwo, "..", NonCategorical)                                                \
+  X(DotThree, "...", NonCategorical)                                             \
+  X(Huh, "?", NonCategorical)                                                    \
+  X(Backslash, "\\", NonCategorical)                                             \
+  X(Money, "$", NonCategorical)                                                  \
+  X(Pound, "#", NonCategorical)                                                  \
+  X(At, "@", Punctuator)                                                         \
+  X(Eq, "==", BinaryOp | LogicalOp | ComparisonOp)                               \
+  X(Neq, "!=", BinaryOp | LogicalOp | ComparisonOp)                              \
+  X(Lt, "<", BinaryOp | LogicalOp | ComparisonOp)                                \
+  X(Lte, "<=", BinaryOp | LogicalOp | ComparisonOp)                              \
+  X(Gt, ">", BinaryOp | LogicalOp | ComparisonOp)                                \
+  X(Gte, ">=", BinaryOp | LogicalOp | ComparisonOp)                              \
+  X(LogicalAnd, "&&", BinaryOp | LogicalOp)                                      \
+  X(LogicalOr, "||", BinaryOp | LogicalOp)                                       \
+  X(LogicalNot, "!", UnaryOp | ValidPrefix | LogicalOp)                          \
+  X(IntLiteral, "", Literal)                                                     \
+  X(FloatLiteral, "", Literal)                                                   \
+  X(HexLiteral, "", Literal)                                                     \
+  X(OctalLiteral, "", Literal)                                                   \
+  X(ByteLiteral, "", Literal)                                                    \
+  X(BooleanLiteral, "", Literal)                                                 \
+  X(StringLiteral, "", Literal)                                                  \
+  X(Plus, "+", BinaryOp | UnaryOp | ArithmeticOp | PointerArithOp | ValidPrefix) \
+  X(PlusEq, "+=", BinaryOp | ArithAssignOp | ArithmeticOp | PointerArithOp)      \
+  X(Sub, "-", BinaryOp | ArithmeticOp | PointerArithOp)                          \
+  X(SubEq, "-=", BinaryOp | ArithAssignOp | ArithmeticOp | PointerArithOp)       \
+  X(Mul, "*", BinaryOp | UnaryOp | ArithmeticOp | ValidPrefix)                   \
+  X(MulEq, "*=", BinaryOp | ArithAssignOp | ArithmeticOp)                        \
+  X(Div, "/", BinaryOp | UnaryOp | ArithmeticOp | ValidPrefix)                   \
+  X(DivEq, "/=", BinaryOp | ArithAssignOp | ArithmeticOp)                        \
+  X(Mod, "%", BinaryOp | ArithmeticOp)                                           \
+  X(ModEq, "%=", BinaryOp | ArithmeticOp | ArithAssignOp)                        \
+  X(Inc, "++", UnaryOp | ArithAssignOp | ArithmeticOp | PointerArithOp | ValidPostfix | ValidPrefix) \
+  X(Dec, "--", UnaryOp | ArithAssignOp | ArithmeticOp | PointerArithOp | ValidPostfix | ValidPrefix) \
+  X(BitwiseNot, "~", UnaryOp | BitwiseOp | ValidPrefix)                          \
+  X(BitwiseAnd, "&", BinaryOp | BitwiseOp | UnaryOp | ValidPrefix)               \
+  X(BitwiseAndEq, "&=", BinaryOp | BitwiseOp | BitwiseAssignOp)                  \
+  X(BitwiseOr, "|", BitwiseOp)                                                   \
+  X(BitwiseOrEq, "|=", BinaryOp | BitwiseOp | BitwiseAssignOp)                   \
+  X(Xor, "^", BinaryOp | BitwiseOp)                                              \
+  X(XorEq, "^=", BinaryOp | BitwiseOp | BitwiseAssignOp)                         \
+  X(Lshift, "<<", BinaryOp | BitwiseOp)                                          \
+  X(LshiftEq, "<<=", BinaryOp | BitwiseOp | BitwiseAssignOp)                     \
+  X(Rshift, ">>", BinaryOp | BitwiseOp)                                          \
+  X(RshiftEq, ">>=", BinaryOp | BitwiseOp | BitwiseAssignOp)                     \
+  X(Proc, "proc", Keyword)                                                       \
+  X(Let, "let", Keyword)                                                         \
+  X(Const, "const", Keyword)                                                     \
+  X(NullLiteral, "null", Literal)                                                \
+  X(Return, "return", Keyword)                                                   \
+  X(Break, "break", Keyword)                                                     \
+  X(Continue, "continue", Keyword)                                               \
+  X(For, "for", Keyword)                                                         \
+  X(While, "while", Keyword)                                                     \
+  X(Do, "do", Keyword)                                                           \
+  X(If, "if", Keyword)                                                           \
+  X(Else, "else", Keyword)                                                       \
+  X(Struct, "struct", Keyword)                                                   \
+  X(Enum, "enum", Keyword)                                                       \
+  X(Switch, "switch", Keyword)                                                   \
+  X(Case, "case", Keyword)                                                       \
+  X(Default, "default", Keyword)                                                 \
+  X(Fallthrough, "fallthrough", Keyword)                                         \
+  X(Namespace, "namespace", Keyword)                                             \
+  X(Compose, "compose", Keyword)                                                 \
+  X(Defer, "defer", Keyword)                                                     \
+  X(DeferIf, "defer_if", Keyword)                                                \
+  X(Scope, "scope", Keyword)                                                     \
+  X(Typeof, "typeof", Keyword)                                                   \
+  X(Sizeof, "sizeof", Keyword)                                                   \
+  X(As, "as", Keyword)                                                           \
+  X(CompEval, "compeval", Keyword)                                               \
+  X(Using, "using", Keyword)                                                     \
+  X(SkinnyArrow, "->", BinaryOp)                                                 \
+  X(FatArrow, "=>", NonCategorical)                                              \
 
 #define RL_TOKEN_CATEGORY_LIST   \
   X(NonCategorical, 0ULL)        \
@@ -140,22 +143,20 @@ class TokenType {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(TokenType);
   N19_MAKE_DEFAULT_ASSIGNABLE(TokenType);
 public:
-  #define X(TOKEN_TYPE, STR_UNUSED) TOKEN_TYPE,
+  #define X(TOKEN_TYPE, STR_UNUSED, CAT_UNUSED) TOKEN_TYPE,
   enum Value : uint16_t {
     RL_TOKEN_TYPE_LIST
   };
   #undef X
 
-  struct Precedence {   /// Token precedence constants
-    using Value = uint16_t;
-    constexpr static Value max = 1000;
-    Precedence() = delete;
-  };
+  #define X(TOKEN_TYPE, STR_UNUSED, CAT_UNUSED) + 1
+  constexpr static size_t count = 0 RL_TOKEN_TYPE_LIST;
+  #undef X
 
   NODISCARD_ auto string_repr() const -> std::string;
   NODISCARD_ auto to_string() const -> std::string;
+  NODISCARD_ auto name() const -> std::string_view;
   NODISCARD_ static auto from_keyword(const std::u8string_view&) -> Maybe<TokenType>;
-  NODISCARD_ auto prec() const -> Precedence::Value;
 
   Value value  = None;
   constexpr TokenType() = default;
@@ -174,7 +175,9 @@ public:
   #undef X
 
   NODISCARD_ auto to_string() const -> std::string;
+  auto format_to(std::string& out) const -> void;
   NODISCARD_ static auto from_keyword(const std::u8string_view&) -> Maybe<TokenCategory>;
+  NODISCARD_ static constexpr auto of(TokenType type) -> TokenCategory;
   NODISCARD_ auto isa(TokenCategory val) const -> bool;
 
   constexpr auto operator|=(const TokenCategory &other) -> void;
@@ -183,6 +186,8 @@ public:
   size_t value = NonCategorical;
   constexpr TokenCategory() = default;
   constexpr TokenCategory(const size_t v) : value(v) {}
+private:
+  static const std::array<size_t, TokenType::count> table_;
 };
 
 class Token {
@@ -191,22 +196,51 @@ class Token {
   N19_MAKE_DEFAULT_CONSTRUCTIBLE(Token);
   N19_MAKE_DEFAULT_ASSIGNABLE(Token);
 public:
-  uint32_t pos_  = 0;   /// File offset.
-  uint32_t len_  = 0;   /// Length of the token.
-  uint32_t line_ = 1;   /// The line it appears on.
-  TokenCategory cat_;   /// It's flags or modifiers.
+  PackedPos pos_;       /// File offset.
   TokenType type_;      /// The type of token.
+  uint32_t len_  = 0;   /// Length of the token.
 
+  /// Flags or modifiers. Always a function of the type, so
+  /// it's looked up rather than stored. The line a token is on
+  /// comes from the lexer's line index (Lexer::line_of).
+  NODISCARD_ auto cat() const -> TokenCategory;
+  NODISCARD_ auto view(const class Lexer&) const -> std::u8string_view;
   NODISCARD_ auto value(const class Lexer&) const -> Maybe<std::string>;
   NODISCARD_ auto format(const class Lexer&) const -> std::string;
+  auto format_to(const class Lexer&, std::string& out) const -> void;
   NODISCARD_ auto is_terminator() const -> bool;
 
-  static auto eof(uint32_t pos, uint32_t line) -> Token;
-  static auto illegal(uint32_t pos, uint32_t length, uint32_t line) -> Token;
+  static auto eof(SourcePos pos) -> Token;
+  static auto illegal(SourcePos pos, uint32_t length) -> Token;
   ~Token() = default;
   Token() = default;
 };
 
+static_assert(sizeof(Token) == 12, "Token should pack into 12 bytes.");
+
+///
+/// The value of a numeric literal, decoded once while it's
+/// lexed. The lexer keeps these in a side table ordered by
+/// position, see Lexer::literal().
+struct LiteralValue {
+  SourcePos pos = 0;         /// Where the literal token starts.
+  union {
+    uint64_t integer = 0;    /// Int, hex and octal literals.
+    double floating;         /// Float literals.
+  };
+  bool in_range = true;      /// False if the value doesn't fit.
+};
+
+///
+/// An identifier, or the unescaped contents of a string literal,
+/// interned into the lexer's StringPool as it's lexed. Equal
+/// spellings share an index. See Lexer::interned().
+struct InternedString {
+  SourcePos pos = 0;         /// Where the token starts.
+  StringPool::Index index{}; /// Into Lexer::strings().
+  Murmur3_32 hash = 0;       /// StringPool::hash_of() the spelling.
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Begin inlined methods.
 
@@ -222,6 +256,32 @@ FORCEINLINE_ constexpr auto TokenCategory::operator|=(
   value |= other;
 }
 
+/// The third column of RL_TOKEN_TYPE_LIST. Types that are spelled
+/// as keywords take their full category from LR_KEYWORDS, which may
+/// only add flags on top of the column ("continue" is also ControlFlow).
+constexpr std::array<size_t, TokenType::count> TokenCategory::table_ = []() consteval {
+  using enum TokenCategory::Value;
+  std::array<size_t, TokenType::count> out{};
+#define X(TYPE, STR_UNUSED, CAT) out[TokenType::TYPE] = CAT;
+  RL_TOKEN_TYPE_LIST
+#undef X
+#define KEYWORD_X(NAME, TYPE, CAT)                                                     \
+  if((out[TokenType::TYPE] & (CAT)) != out[TokenType::TYPE])                          \
+    throw "LR_KEYWORDS entry " NAME " drops flags from RL_TOKEN_TYPE_LIST.";        \
+  out[TokenType::TYPE] = CAT;
+  LR_KEYWORDS
+#undef KEYWORD_X
+  return out;
+}();
+
+FORCEINLINE_ constexpr auto TokenCategory::of(const TokenType type) -> TokenCategory {
+  return table_[type.value];
+}
+
+FORCEINLINE_ auto Token::cat() const -> TokenCategory {
+  return TokenCategory::of(type_);
+}
+
 FORCEINLINE_ auto TokenCategory::isa(const TokenCategory val) const -> bool {
   return this->value & val.value;
 }
@@ -0,0 +1,264 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/Lexer/TokenCache.hpp>
+#include <n19/System/MappedFile.hpp>
+#include <n19/Core/Bytes.hpp>
+#include <n19/Core/Fmt.hpp>
+#include <n19/Core/Try.hpp>
+#include <type_traits>
+#include <cstring>
+#include <map>
+
+BEGIN_NAMESPACE(rl);
+namespace {
+  struct Header_ {
+    char magic[8];
+    uint32_t version;
+    uint32_t token_size;      /// sizeof(Token), in case the layout moves.
+    uint64_t hash_first;
+    uint64_t hash_second;
+    uint64_t source_size;
+    uint64_t tokens;
+    uint64_t lines;
+    uint64_t literals;
+    uint64_t interned;
+    uint64_t strings;
+    uint64_t blob;            /// Bytes of string data.
+  };
+
+  struct InternedRecord_ {
+    uint64_t pos;
+    uint32_t string;          /// Into the string table.
+    uint32_t hash;
+  };
+
+  struct StringRecord_ {
+    uint32_t offset;          /// Into the blob.
+    uint32_t len;
+    uint32_t hash;
+    uint32_t unused_;
+  };
+
+  constexpr char magic_[8] = { 'n', '1', '9', 't', 'o', 'k', 's', '\0' };
+
+  static_assert(std::is_trivially_copyable_v<Token>);
+  static_assert(std::is_trivially_copyable_v<LiteralValue>);
+  static_assert(std::is_trivially_copyable_v<Header_>);
+
+  constexpr auto align8_(const uint64_t size) -> uint64_t {
+    return (size + 7) & ~uint64_t{7};
+  }
+
+  template<typename T>
+  auto append_(std::vector<Byte>& out, const T* data, const size_t count) -> void {
+    const size_t size = sizeof(T) * count;
+    const size_t at   = out.size();
+    out.resize(align8_(at + size));
+    if(size) std::memcpy(out.data() + at, data, size);
+  }
+
+  template<typename T>
+  auto read_(const Byte*& cursor, std::vector<T>& into, const size_t count) -> void {
+    into.resize(count);
+    if(count) std::memcpy(into.data(), cursor, sizeof(T) * count);
+    cursor += align8_(sizeof(T) * count);
+  }
+}
+
+auto TokenCache::open(const sys::String& dir) -> Result<TokenCache> {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if(ec) return Error(ErrC::FileIO, "Could not create the token cache directory: " + ec.message());
+
+  TokenCache cache;
+  cache.dir_ = dir;
+  return cache;
+}
+
+auto TokenCache::path_for(const Murmur3_128& hash) const -> std::filesystem::path {
+  return dir_ / fmt("{:016x}{:016x}.rltok", hash.first_, hash.second_);
+}
+
+auto TokenCache::lex(sys::File& ref) -> Result<std::shared_ptr<Lexer>> {
+  auto lxr = std::make_shared<Lexer>();
+  lxr->mode_ = LexMode::Eager;
+  TRY(lxr->adopt_(ref));
+  return lex_(std::move(lxr));
+}
+
+auto TokenCache::lex(sys::File& ref, sys::MappedFile&& mapped) -> Result<std::shared_ptr<Lexer>> {
+  auto lxr = std::make_shared<Lexer>();
+  lxr->mode_ = LexMode::Eager;
+  TRY(lxr->adopt_(ref, std::move(mapped)));
+  return lex_(std::move(lxr));
+}
+
+auto TokenCache::lex_(std::shared_ptr<Lexer>&& lxr) -> Result<std::shared_ptr<Lexer>> {
+  const std::u8string_view src{ lxr->src_.data(), lxr->src_.size() };
+  const Murmur3_128 hash = murmur3_x64_128(src, seed);
+  const auto path = path_for(hash);
+
+  if(load_(*lxr, path, hash)) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    lxr->tok_index_ = 0;
+    lxr->curr_ = lxr->toks_.front();
+    return lxr;
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  lxr->line_starts_.assign(1, 0);   /// A rejected entry may have
+  lxr->literals_.clear();           /// left some of these behind.
+  lxr->interned_.clear();
+  lxr->tokenize_();
+  (void)store_(*lxr, path, hash);   /// A cache that can't be written
+  return lxr;                       /// to is just a slower cache.
+}
+
+/// Anything that doesn't add up is treated as a miss
+/// rather than an error, the entry just gets rewritten.
+auto TokenCache::load_(
+  Lexer& lxr,
+  const std::filesystem::path& path,
+  const Murmur3_128& hash ) -> bool
+{
+  std::error_code ec;
+  if(!std::filesystem::is_regular_file(path, ec)) return false;
+
+  auto file = sys::File::open(sys::String(path.native()), false, sys::File::Read);
+  if(!file) return false;
+
+  auto mapped = sys::MappedFile::map(*file);
+  file->close();
+  if(!mapped) return false;
+
+  const Bytes bytes = mapped->bytes();
+  Header_ header{};
+  if(bytes.size() < sizeof(header)) return false;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+
+  if(std::memcmp(header.magic, magic_, sizeof(magic_)) != 0
+    || header.version     != version
+    || header.token_size  != sizeof(Token)
+    || header.hash_first  != hash.first_
+    || header.hash_second != hash.second_
+    || header.source_size != lxr.src_.size()
+    || header.tokens == 0) {
+    return false;
+  }
+
+  /// Every count is bounded by the file size, so none
+  /// of the section sizes below can overflow.
+  const uint64_t limit = bytes.size();
+  if(header.tokens > limit || header.lines > limit || header.literals > limit
+    || header.interned > limit || header.strings > limit || header.blob > limit) {
+    return false;
+  }
+
+  const uint64_t expected = align8_(sizeof(Header_))
+    + align8_(header.tokens   * sizeof(Token))
+    + align8_(header.lines    * sizeof(SourcePos))
+    + align8_(header.literals * sizeof(LiteralValue))
+    + align8_(header.interned * sizeof(InternedRecord_))
+    + align8_(header.strings  * sizeof(StringRecord_))
+    + align8_(header.blob);
+
+  if(expected != bytes.size()) return false;
+
+  const Byte* cursor = bytes.data() + align8_(sizeof(Header_));
+  std::vector<InternedRecord_> interned;
+  std::vector<StringRecord_> strings;
+
+  read_(cursor, lxr.toks_, header.tokens);
+  read_(cursor, lxr.line_starts_, header.lines);
+  read_(cursor, lxr.literals_, header.literals);
+  read_(cursor, interned, header.interned);
+  read_(cursor, strings, header.strings);
+
+  const char* blob = reinterpret_cast<const char*>(cursor);
+  if(lxr.toks_.back() != TokenType::EndOfFile || lxr.line_starts_.empty()) {
+    return false;
+  }
+
+  /// One pool insertion per distinct spelling,
+  /// not one per identifier in the file.
+  std::vector<StringPool::Index> indices;
+  indices.reserve(strings.size());
+  for(const StringRecord_& str : strings) {
+    if(str.len == 0 || uint64_t{str.offset} + str.len > header.blob) return false;
+    const std::string_view text{ blob + str.offset, str.len };
+    indices.emplace_back(lxr.strings().get_index(text, str.hash));
+  }
+
+  lxr.interned_.clear();
+  lxr.interned_.reserve(interned.size());
+  for(const InternedRecord_& rec : interned) {
+    if(rec.string >= indices.size()) return false;
+    lxr.interned_.emplace_back(InternedString{
+      .pos   = rec.pos,
+      .index = indices[rec.string],
+      .hash  = rec.hash,
+    });
+  }
+
+  return true;
+}
+
+/// Written with sys::write_atomically(), so
+/// a concurrent reader never sees half of an entry.
+auto TokenCache::store_(
+  const Lexer& lxr,
+  const std::filesystem::path& path,
+  const Murmur3_128& hash ) -> Result<void>
+{
+  std::vector<InternedRecord_> interned;
+  std::vector<StringRecord_> strings;
+  std::map<StringPool::Index, uint32_t> seen;
+  std::string blob;
+
+  interned.reserve(lxr.interned_.size());
+  for(const InternedString& str : lxr.interned_) {
+    auto [it, inserted] = seen.try_emplace(str.index, static_cast<uint32_t>(strings.size()));
+    if(inserted) {
+      const auto text = lxr.strings_->get_string(str.index);
+      strings.emplace_back(StringRecord_{
+        .offset  = static_cast<uint32_t>(blob.size()),
+        .len     = static_cast<uint32_t>(text.size()),
+        .hash    = str.hash,
+        .unused_ = 0,
+      });
+      blob += text;
+    }
+
+    interned.emplace_back(InternedRecord_{ .pos = str.pos, .string = it->second, .hash = str.hash });
+  }
+
+  Header_ header{};
+  std::memcpy(header.magic, magic_, sizeof(magic_));
+  header.version     = version;
+  header.token_size  = sizeof(Token);
+  header.hash_first  = hash.first_;
+  header.hash_second = hash.second_;
+  header.source_size = lxr.src_.size();
+  header.tokens      = lxr.toks_.size();
+  header.lines       = lxr.line_starts_.size();
+  header.literals    = lxr.literals_.size();
+  header.interned    = interned.size();
+  header.strings     = strings.size();
+  header.blob        = blob.size();
+
+  std::vector<Byte> out;
+  append_(out, &header, 1);
+  append_(out, lxr.toks_.data(), lxr.toks_.size());
+  append_(out, lxr.line_starts_.data(), lxr.line_starts_.size());
+  append_(out, lxr.literals_.data(), lxr.literals_.size());
+  append_(out, interned.data(), interned.size());
+  append_(out, strings.data(), strings.size());
+  append_(out, blob.data(), blob.size());
+
+  return sys::write_atomically(path, as_bytes(out));
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,90 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <n19/Core/Murmur3.hpp>
+#include <n19/Core/Result.hpp>
+#include <n19/System/File.hpp>
+#include <n19/System/String.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <filesystem>
+#include <atomic>
+#include <utility>
+#include <memory>
+#include <cstdint>
+BEGIN_NAMESPACE(rl);
+using namespace n19;
+
+///
+/// An opt-in, on-disk cache of lexer output. Entries are keyed by
+/// a 128-bit hash of the source bytes, so renaming or touching a
+/// file doesn't invalidate anything, and editing it always does.
+///
+/// Each entry is one binary file that's mapped straight back in:
+/// a header, then the token array, the line index, the decoded
+/// literals and the interned strings, each section 8-byte aligned.
+/// Entries from another format version, or that don't check out
+/// against the source they claim to describe, count as misses.
+/// One cache can serve every compilation running at once.
+class TokenCache {
+  N19_MAKE_NONCOPYABLE(TokenCache);
+public:
+  struct Stats {
+    size_t hits   = 0;
+    size_t misses = 0;
+  };
+
+  /// Bumped whenever the layout, or anything
+  /// that changes what the lexer produces, changes.
+  constexpr static uint32_t version = 1;
+  constexpr static uint32_t seed    = 0x6e31394b;
+
+  /// Creates the directory if it doesn't exist yet.
+  static auto open(const sys::String& dir) -> Result<TokenCache>;
+
+  /// An eager lexer over `ref`. On a hit the token stream comes
+  /// from the cache, on a miss the file is lexed and stored.
+  auto lex(sys::File& ref) -> Result<std::shared_ptr<Lexer>>;
+
+  /// Same, over a mapping of `ref` made with Lexer::padding,
+  /// for callers that already had to map the file themselves.
+  auto lex(sys::File& ref, sys::MappedFile&& mapped) -> Result<std::shared_ptr<Lexer>>;
+  auto stats() const -> Stats;
+  auto path_for(const Murmur3_128& hash) const -> std::filesystem::path;
+
+  TokenCache(TokenCache&& other) noexcept;
+  TokenCache& operator=(TokenCache&& other) noexcept;
+  TokenCache() = default;
+  ~TokenCache() = default;
+private:
+  auto lex_(std::shared_ptr<Lexer>&& lxr) -> Result<std::shared_ptr<Lexer>>;
+  static auto load_(Lexer& lxr, const std::filesystem::path& path, const Murmur3_128& hash) -> bool;
+  static auto store_(const Lexer& lxr, const std::filesystem::path& path, const Murmur3_128& hash) -> Result<void>;
+
+  std::filesystem::path dir_;
+  std::atomic<size_t> hits_{ 0 };
+  std::atomic<size_t> misses_{ 0 };
+};
+
+inline TokenCache::TokenCache(TokenCache&& other) noexcept
+  : dir_(std::move(other.dir_))
+  , hits_(other.hits_.load())
+  , misses_(other.misses_.load()) {}
+
+inline auto TokenCache::operator=(TokenCache&& other) noexcept -> TokenCache& {
+  dir_ = std::move(other.dir_);
+  hits_.store(other.hits_.load());
+  misses_.store(other.misses_.load());
+  return *this;
+}
+
+inline auto TokenCache::stats() const -> Stats {
+  return Stats{ .hits = hits_.load(), .misses = misses_.load() };
+}
+
+END_NAMESPACE(rl);
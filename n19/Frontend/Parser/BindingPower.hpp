@@ -0,0 +1,83 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Frontend/Lexer/Token.hpp>
+#include <array>
+#include <cstdint>
+BEGIN_NAMESPACE(rl);
+
+///
+/// How tightly a token binds to the expressions around it, for
+/// each position it can appear in. Higher binds tighter, and zero
+/// means the token isn't an operator in that position.
+///
+/// An infix operator keeps extending its left operand for as long
+/// as the next operator's `infix_left` is at least its own
+/// `infix_right`. Every infix operator has `infix_right` one below
+/// `infix_left`, which groups equal levels to the right:
+/// "a - b - c" is "a - (b - c)".
+struct BindingPower {
+  uint8_t prefix      = 0;   /// Binding power of a prefix operator's operand.
+  uint8_t infix_left  = 0;
+  uint8_t infix_right = 0;
+  uint8_t postfix     = 0;
+
+  static constexpr uint8_t prefix_  = 30;   /// Above every infix level.
+  static constexpr uint8_t postfix_ = 32;   /// Above prefix: "!f()" is "!(f())".
+
+  NODISCARD_ static constexpr auto of(TokenType type) -> BindingPower;
+
+private:
+  static const std::array<BindingPower, TokenType::count> table_;
+};
+
+static_assert(sizeof(BindingPower) == 4, "BindingPower should pack into 4 bytes.");
+
+constexpr std::array<BindingPower, TokenType::count> BindingPower::table_ = []() consteval {
+  using T = TokenType;
+  std::array<BindingPower, TokenType::count> out{};
+
+  auto infix = [&](const T::Value type, const uint8_t level) {
+    if((TokenCategory::of(type).value & TokenCategory::BinaryOp) == 0)
+      throw "BindingPower: infix operator isn't a BinaryOp.";
+    out[type].infix_left  = static_cast<uint8_t>(level * 2);
+    out[type].infix_right = static_cast<uint8_t>(level * 2 - 1);
+  };
+
+  /// Loosest first. "|" isn't lexed as a BinaryOp yet, and
+  /// casts with "as" aren't parsed yet, so neither has an entry.
+  infix(T::ValueAssignment, 1);
+  for(const auto op : { T::PlusEq, T::SubEq, T::MulEq, T::DivEq, T::ModEq,
+    T::LshiftEq, T::RshiftEq, T::BitwiseAndEq, T::BitwiseOrEq, T::XorEq }) infix(op, 2);
+  infix(T::LogicalAnd, 3);
+  infix(T::LogicalOr, 4);
+  for(const auto op : { T::Mul, T::Div, T::Mod })   infix(op, 5);
+  for(const auto op : { T::Plus, T::Sub })          infix(op, 6);
+  for(const auto op : { T::Lshift, T::Rshift })     infix(op, 7);
+  for(const auto op : { T::Lt, T::Lte, T::Gt, T::Gte }) infix(op, 8);
+  for(const auto op : { T::Eq, T::Neq })            infix(op, 9);
+  infix(T::BitwiseAnd, 10);
+  infix(T::Xor, 11);
+  for(const auto op : { T::Dot, T::SkinnyArrow })   infix(op, 13);
+  infix(T::NamespaceOperator, 14);
+
+  for(const auto op : { T::NamespaceOperator, T::LogicalNot, T::Plus, T::Mul, T::Div,
+    T::Inc, T::Dec, T::BitwiseNot, T::BitwiseAnd }) out[op].prefix = prefix_;
+
+  for(const auto op : { T::LeftParen, T::LeftSqBracket, T::Inc, T::Dec })
+    out[op].postfix = postfix_;
+
+  return out;
+}();
+
+FORCEINLINE_ constexpr auto BindingPower::of(const TokenType type) -> BindingPower {
+  return table_[type.value];
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,84 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/Frontend/Parser/IncludePrefetcher.hpp>
+#include <n19/Core/Defer.hpp>
+#include <n19/Core/Try.hpp>
+#include <n19/System/File.hpp>
+#include <algorithm>
+#include <utility>
+BEGIN_NAMESPACE(rl);
+
+IncludePrefetcher::~IncludePrefetcher() {
+  worker_.reset();  /// Joins before queue_ goes away.
+}
+
+auto IncludePrefetcher::load_(const sys::String& name) -> Result<std::shared_ptr<Lexer>> {
+  auto ref = TRY(sys::File::open(name, false, sys::File::Read));
+  DEFER_IF(!ref.is_invalid(), {
+    ref.close();
+  });
+
+  return Lexer::create_detached(ref);
+}
+
+auto IncludePrefetcher::enqueue(const InputFile::ID id, const sys::String& name) -> void {
+  Entry_* entry = nullptr;
+  {
+    std::lock_guard guard(lock_);
+    entry = &queue_.emplace_back();
+    entry->loaded.id   = id;
+    entry->loaded.name = name;
+  }
+
+  if(worker_ == nullptr) {
+    worker_ = std::make_unique<ThreadPool>(1);
+  }
+
+  worker_->submit([this, entry] {
+    const auto begin = std::chrono::steady_clock::now();
+    auto lexer = load_(entry->loaded.name);
+    const auto cost = std::chrono::steady_clock::now() - begin;
+
+    {
+      std::lock_guard guard(lock_);
+      entry->loaded.lexer = std::move(lexer);
+      entry->cost = std::chrono::duration_cast<std::chrono::nanoseconds>(cost);
+      entry->done = true;
+    }
+
+    loaded_.notify_all();
+  });
+}
+
+auto IncludePrefetcher::next() -> Maybe<Loaded> {
+  std::unique_lock guard(lock_);
+  if(queue_.empty()) {
+    return Nothing;
+  }
+
+  Entry_& front = queue_.front();
+  const bool ready = front.done;
+  const auto begin = std::chrono::steady_clock::now();
+  loaded_.wait(guard, [&front] { return front.done; });
+  const auto waited = std::chrono::steady_clock::now() - begin;
+
+  /// Whatever part of the load we didn't have
+  /// to sit through was overlapped with parsing.
+  ++stats_.files;
+  stats_.ready += ready ? 1 : 0;
+  stats_.saved += std::max<std::chrono::nanoseconds>(front.cost - waited, {});
+
+  Loaded out = std::move(front.loaded);
+  queue_.pop_front();
+  return out;
+}
+
+auto IncludePrefetcher::stats() const -> Stats {
+  std::lock_guard guard(lock_);
+  return stats_;
+}
+
+END_NAMESPACE(rl);
@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <n19/Core/Maybe.hpp>
+#include <n19/Core/Result.hpp>
+#include <n19/Core/ThreadPool.hpp>
+#include <n19/System/String.hpp>
+#include <n19/Frontend/FrontendContext.hpp>
+#include <n19/Frontend/Lexer/Lexer.hpp>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+BEGIN_NAMESPACE(rl);
+using namespace n19;
+
+///
+/// Opens, maps and tokenizes @include'd files on a background
+/// thread while the parser is still busy with the current one.
+/// Files come back out of next() in the order they were queued,
+/// as detached lexers ready for Lexer::reset(Lexer&).
+///
+/// The thread is only started by the first enqueue(), so a
+/// prefetcher that's never used costs nothing.
+class IncludePrefetcher {
+  N19_MAKE_NONCOPYABLE(IncludePrefetcher);
+  N19_MAKE_NONMOVABLE(IncludePrefetcher);
+public:
+  struct Stats {
+    size_t files = 0;                   /// Handed out by next().
+    size_t ready = 0;                   /// Already done when they were asked for.
+    std::chrono::nanoseconds saved{};   /// Loading time the parser didn't wait on.
+  };
+
+  struct Loaded {
+    InputFile::ID id = RL_INVALID_INFILE_ID;
+    sys::String name;
+    Result<std::shared_ptr<Lexer>> lexer;
+  };
+
+  auto enqueue(InputFile::ID id, const sys::String& name) -> void;
+
+  /// The oldest queued file, waiting for it to finish
+  /// loading if it hasn't yet. Nothing once the queue is empty.
+  auto next() -> Maybe<Loaded>;
+  auto stats() const -> Stats;
+
+  IncludePrefetcher() = default;
+  ~IncludePrefetcher();
+private:
+  struct Entry_ {
+    Loaded loaded;
+    std::chrono::nanoseconds cost{};    /// Time spent loading on the background thread.
+    bool done = false;
+  };
+
+  static auto load_(const sys::String& name) -> Result<std::shared_ptr<Lexer>>;
+
+  std::deque<Entry_> queue_;            /// Never reallocates, the worker holds a pointer.
+  std::unique_ptr<ThreadPool> worker_;  /// Created on first use.
+  mutable std::mutex lock_;
+  std::condition_variable loaded_;
+  Stats stats_;
+};
+
+END_NAMESPACE(rl);
@@ -11,8 +11,12 @@
 #include <n19/Frontend/Lexer/Lexer.hpp>
 #include <n19/Frontend/Entities/EntityTable.hpp>
 #include <n19/Frontend/AST/ASTNodes.hpp>
+#include <n19/Frontend/AST/AstArena.hpp>
+#include <n19/Frontend/Parser/IncludePrefetcher.hpp>
 #include <n19/Core/Stream.hpp>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <cstdint>
 BEGIN_NAMESPACE(rl);
 
@@ -27,8 +31,39 @@ struct ParseContext {
   uint16_t        paren_level;
   EntityTable&    entities;
 
+  /// Every node the parser creates lives here, and
+  /// is released along with the context.
+  AstArena arena;
   std::vector<AstNode::Ptr<>> toplevel_decls_;
 
+  /// When set, procedure bodies are skipped with a brace-matching
+  /// scan and parsed later, by AstProcDecl::ensure_body() or
+  /// parse_pending_bodies(). Ignored for LexMode::Streaming, where
+  /// the body may have left the window by then. Until a body is
+  /// parsed, its syntax errors go unreported and whatever it would
+  /// declare is missing from the entity table.
+  bool skim_bodies = false;
+  std::vector<AstNode::Ptr<AstProcDecl>> pending_bodies_;
+
+  /// Sources of files the lexer has moved on from that still have
+  /// skimmed bodies in them, put aside with Lexer::swap_source().
+  std::unordered_map<InputFile::ID, std::shared_ptr<Lexer>> parked_files_;
+
+  /// Files @include'd from this context, loading in the
+  /// background until get_next_include_() switches to them.
+  IncludePrefetcher includes;
+
+  /// Every file parsed or queued here, starting with the one the
+  /// context was made for. Including any of them again does nothing,
+  /// so each file is parsed once per compilation, whatever other
+  /// compilations running alongside this one include.
+  std::vector<InputFile::ID> files_;
+
+  /// Set by any @include, even one of a file that was skipped
+  /// as already parsed or that then failed to load. The tree
+  /// depends on more than this file's bytes once it's set.
+  bool saw_include = false;
+
   ParseContext(
     InputFile::ID inf_id,
     OStream& errstream,
@@ -45,9 +80,16 @@ struct ParseContext {
   {
     ASSERT(!lxr.src_.empty());
     ASSERT(!entities.map_.empty());
+    files_.push_back(inf_id);
+
+    /// Builtins exist before any identifier is lexed. Put their
+    /// names in the pool too, so lookups compare indices only.
+    for(auto& [id, ent] : entities.map_) {
+      if(!ent->lname_.empty()) ent->lname_id_ = lxr.strings().get_index(ent->lname_);
+    }
   }
 
-  bool on(TokenCategory cat) { return lxr.current().cat_.isa(cat); }
+  bool on(TokenCategory cat) { return lxr.current().cat().isa(cat); }
   bool on_type(TokenType ty) { return lxr.current() == ty; }
 
   ~ParseContext() = default;
@@ -4,12 +4,13 @@
 */
 
 #include <n19/Frontend/Parser/Parser.hpp>
+#include <n19/Frontend/Parser/BindingPower.hpp>
 #include <n19/Core/StringUtil.hpp>
 #include <n19/Frontend/FrontendContext.hpp>
 #include <n19/System/File.hpp>
 #include <algorithm>
-#include <utility>
 #include <filesystem>
+#include <utility>
 BEGIN_NAMESPACE(rl::detail_);
 
 auto is_node_toplevel_valid_(const AstNode::Ptr<> &ptr) -> bool {
@@ -54,12 +55,8 @@ auto node_never_needs_terminal_(const AstNode::Ptr<>& ptr) -> bool {
   }
 }
 
-auto parse_begin_(
-  ParseContext &ctx,
-  bool nocheck_term, bool parse_single ) -> Result<AstNode::Ptr<>>
-{
-  const auto curr     = ctx.lxr.current();
-  AstNode::Ptr<> expr = nullptr;
+auto parse_primary_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
+  const auto curr = ctx.lxr.current();
 
   ///
   /// Check if EOF has been reached.
@@ -69,33 +66,39 @@ auto parse_begin_(
 
   ///
   /// Check categories
-  if(curr.cat_.isa(TokenCategory::Punctuator)) {
-    expr = TRY(parse_punctuator_(ctx));
+  if(curr.cat().isa(TokenCategory::Punctuator)) {
+    return parse_punctuator_(ctx);
   }
-  else if(curr.cat_.isa(TokenCategory::Literal)) {
-    expr = TRY(parse_scalar_lit_(ctx));
+  if(curr.cat().isa(TokenCategory::Literal)) {
+    return parse_scalar_lit_(ctx);
   }
-  else if(curr.type_ == TokenType::Identifier) {
-    expr = TRY(parse_identifier_(ctx));
+  if(curr.type_ == TokenType::Identifier) {
+    return parse_identifier_(ctx);
   }
-  else if(curr.cat_.isa(TokenCategory::Keyword)) {
-    expr = TRY(parse_keyword_(ctx));
+  if(curr.cat().isa(TokenCategory::Keyword)) {
+    return parse_keyword_(ctx);
   }
-  else if(curr.cat_.isa(TokenCategory::UnaryOp | TokenCategory::ValidPrefix)) {
-    expr = TRY(parse_unary_prefix_(ctx));
+  if(BindingPower::of(curr.type_).prefix != 0) {
+    return parse_unary_prefix_(ctx);
   }
 
   ///
   /// Illegal token
-  else if(curr == TokenType::Illegal) {
+  if(curr == TokenType::Illegal) {
+    if(ctx.lxr.stream_error().has_value()) return Error(ctx.lxr.stream_error().value());
     return Error{ErrC::BadToken, "Illegal token."};
   }
 
   ///
   /// Unknown token
-  else {
-    return Error{ErrC::BadToken, "Wtf is this shit bro"};
-  }
+  return Error{ErrC::BadToken, "Wtf is this shit bro"};
+}
+
+auto parse_begin_(
+  ParseContext &ctx,
+  bool nocheck_term, bool parse_single ) -> Result<AstNode::Ptr<>>
+{
+  AstNode::Ptr<> expr = TRY(parse_primary_(ctx));
 
   ///
   /// Special exceptions: these expressions NEVER
@@ -105,26 +108,9 @@ auto parse_begin_(
   }
 
   ///
-  /// Check for postfixes
-  while(ctx.lxr.current().cat_.isa(TokenCategory::ValidPostfix)) {
-    const auto curr = ctx.lxr.current();
-    expr = TRY(parse_postfix_(ctx, std::move(expr)));
-    if(expr == nullptr) {
-      ctx.lxr.revert_before(curr);
-      return Error(ErrC::BadExpr, "Invalid expression.");
-    }
-  }
-
-  ///
-  /// Check for binary operators following the expression
-  while(!parse_single && ctx.lxr.current().cat_.isa(TokenCategory::BinaryOp)) {
-    const auto curr = ctx.lxr.current();
-    expr = TRY(parse_binexpr_(ctx, std::move(expr)));
-    if(expr == nullptr) {
-      ctx.lxr.revert_before(curr);
-      return Error(ErrC::BadExpr, "Invalid expression.");
-    }
-  }
+  /// Postfixes, then binary operators following the
+  /// expression. A single operand only takes postfixes.
+  expr = TRY(parse_operators_(ctx, std::move(expr), parse_single ? BindingPower::prefix_ : 0));
 
   ///
   /// Check if we're leaving a parenthesized expression
@@ -155,20 +141,111 @@ auto parse_begin_(
   return Error{ErrC::BadToken, "Unexpected token."};
 }
 
+/* record_error_ stores a syntax error in ctx.errors, to be shown
+ * once the file is done. It fails once N19_MAX_ERRORS have been
+ * stored, which unwinds the parse all the way to parse_impl_.
+ */
+auto record_error_(ParseContext& ctx, const std::string& msg, const SourcePos pos) -> Result<void> {
+  if(ctx.errors.error_count() >= N19_MAX_ERRORS) {
+    return Error{ErrC::Overflow, "Too many errors."};
+  }
+
+  ctx.errors.store_error(
+    msg.empty() ? "Unexpected end of file." : msg,
+    ctx.lxr.file_name_,
+    pos,
+    ctx.lxr.line_col(pos).line);
+
+  if(ctx.errors.error_count() >= N19_MAX_ERRORS) {
+    return Error{ErrC::Overflow, "Too many errors."};
+  }
+
+  return Result<void>::create();
+}
+
+/* synchronize_ is panic mode. After a syntax error, it skips
+ * tokens until the parser is somewhere it can pick back up:
+ *
+ *  - just past a ';' or a closed brace block, or
+ *  - on the next "proc" or "namespace" keyword, or
+ *  - inside a block, on the '}' that closes it.
+ *
+ * Braces opened while skipping are skipped as a whole. The
+ * token the failed statement started on is always skipped,
+ * so every round of recovery makes progress.
+ */
+auto synchronize_(ParseContext& ctx, const Token& start, const bool in_block) -> void {
+  uint32_t depth = 0;
+  if(ctx.lxr.current().pos_ == start.pos_ && ctx.lxr.current() != TokenType::RightBrace) {
+    ctx.lxr.consume(1);
+  }
+
+  while(ctx.lxr.current() != TokenType::EndOfFile) {
+    const Token curr = ctx.lxr.current();
+    if(depth == 0) {
+      if(curr == TokenType::Proc || curr == TokenType::Namespace) return;
+      if(curr == TokenType::RightBrace && in_block) return;
+      if(curr == TokenType::Semicolon || curr == TokenType::RightBrace) {
+        ctx.lxr.consume(1);
+        return;
+      }
+    }
+
+    if(curr == TokenType::LeftBrace) {
+      ++depth;
+    } else if(curr == TokenType::RightBrace && --depth == 0) {
+      ctx.lxr.consume(1);
+      return;
+    }
+
+    ctx.lxr.consume(1);
+  }
+}
+
+/* recover_ is called by every loop over a brace block's statements
+ * when one of them fails. It records the error and synchronizes, so
+ * the loop can go on with the next statement. Running out of input,
+ * or into the error limit, can't be recovered from; those are passed
+ * back up for parse_impl_ to deal with.
+ */
+auto recover_(
+  ParseContext& ctx,
+  const Token& start,
+  const Error& err,
+  const bool in_block ) -> Result<void>
+{
+  if(ctx.lxr.current() == TokenType::EndOfFile || ctx.errors.error_count() >= N19_MAX_ERRORS) {
+    return Error(err);
+  }
+
+  TRY(record_error_(ctx, err.msg, ctx.lxr.current().pos_));
+  synchronize_(ctx, start, in_block);
+  ctx.paren_level = 0;
+  return Result<void>::create();
+}
+
 auto parse_impl_(ParseContext &ctx) -> bool {
+  const uint32_t errors_before = ctx.errors.error_count();
+  bool give_up = false;
+
   do {
-    while (true) {
+    while (ctx.lxr.current() != TokenType::EndOfFile) {
+      const Token start  = ctx.lxr.current();
       auto toplevel_decl = parse_begin_(ctx, false, false);
 
-      /// An error has occurred, or EOF was reached. We're done.
+      /// Record the error and carry on from the next
+      /// synchronization point. Errors that can't be
+      /// recovered from end the parse.
       if (!toplevel_decl.has_value()) {
-        if (ctx.lxr.current() != TokenType::EndOfFile) {
-          ErrorCollector::display_error(
-            toplevel_decl.error().msg,
-            ctx.lxr, 
-            ctx.errstream);
+        auto recovered = recover_(ctx, start, toplevel_decl.error(), false);
+        if (!recovered.has_value()) {
+          (void)record_error_(ctx, recovered.error().msg, ctx.lxr.current().pos_);
+          give_up = true;
+          break;
         }
-        break;
+
+        ctx.curr_namespace = RL_ROOT_ENTITY_ID;
+        continue;
       }
 
       /// Note: a returned value of nullptr indicates that the
@@ -182,130 +259,159 @@ auto parse_impl_(ParseContext &ctx) -> bool {
       /// Verify that the returned node is valid at the toplevel
       /// (i.e. can exist at the global scope).
       if (!is_node_toplevel_valid_(*toplevel_decl)) {
-        ErrorCollector::display_error(
-          "Expression is invalid at the toplevel.",
-          ctx.lxr.file_name_,
-          ctx.lxr.src_,
-          ctx.errstream,
-          (*toplevel_decl)->pos_,
-          (*toplevel_decl)->line_);
-        return false;
+        if (!record_error_(ctx, "Expression is invalid at the toplevel.", (*toplevel_decl)->pos_)) {
+          give_up = true;
+          break;
+        }
+
+        ctx.curr_namespace = RL_ROOT_ENTITY_ID;
+        continue;
       }
 
       /// Store the toplevel node within the parsing context.
       ctx.toplevel_decls_.emplace_back(std::move(*toplevel_decl));
     }
 
-    /// We expect the final token to be an EOF. If this isn't the case,
-    /// an error has occurred and parsing has failed.
-    if (ctx.lxr.current() != TokenType::EndOfFile) {
-      return false;
+    /// Diagnostics are shown per file, while
+    /// the lexer still has its source.
+    ctx.errors.emit(ctx.errstream, ctx.lxr);
+  } while (!give_up && get_next_include_(ctx));
+
+  if (give_up && ctx.errors.error_count() >= N19_MAX_ERRORS) {
+    ctx.errstream
+      << Con::RedFG
+      << "Error:"
+      << Con::Reset
+      << " too many errors, stopping.\n";
+  }
+
+  return ctx.errors.error_count() == errors_before;
+}
+
+/* parse_operators_ is the Pratt loop. Starting from `operand`, it
+ * folds in postfixes and binary operators for as long as they bind
+ * at least as tightly as `min_bp`, looking each one up in the
+ * BindingPower table. The right operand of a binary operator is
+ * parsed by recursing with that operator's right binding power, so
+ * every token is looked at once and nothing is ever re-lexed.
+ */
+auto parse_operators_(
+  ParseContext& ctx,
+  AstNode::Ptr<>&& operand,
+  const uint8_t min_bp ) -> Result<AstNode::Ptr<>>
+{
+  AstNode::Ptr<> expr = std::move(operand);
+  while(true) {
+    const auto bp = BindingPower::of(ctx.lxr.current().type_);
+    if(bp.postfix != 0 && bp.postfix >= min_bp) {
+      expr = TRY(parse_postfix_(ctx, std::move(expr)));
+    } else if(bp.infix_left != 0 && bp.infix_left >= min_bp) {
+      expr = TRY(parse_binexpr_(ctx, std::move(expr), bp.infix_right));
+    } else {
+      break;
     }
+  }
 
-  } while (get_next_include_(ctx));
+  return Result<AstNode::Ptr<>>::create(std::move(expr));
+}
 
-  return true;
+/* parse_operand_ parses the operand of a prefix or binary
+ * operator: a primary expression, followed by whatever
+ * binds at least as tightly as `min_bp`. The caller checks
+ * that what comes back can actually be used as an operand.
+ */
+auto parse_operand_(ParseContext& ctx, const uint8_t min_bp) -> Result<AstNode::Ptr<>> {
+  AstNode::Ptr<> expr = TRY(parse_primary_(ctx));
+  if(expr == nullptr || !is_valid_subexpression_(expr)) {
+    return Result<AstNode::Ptr<>>(std::move(expr));
+  }
+
+  return parse_operators_(ctx, std::move(expr), min_bp);
 }
 
-auto parse_binexpr_(ParseContext& ctx, AstNode::Ptr<>&& operand) -> Result<AstNode::Ptr<>> {
-  auto curr = ctx.lxr.current();
-  ASSERT(curr.cat_.isa(TokenCategory::BinaryOp));
+auto parse_binexpr_(
+  ParseContext& ctx,
+  AstNode::Ptr<>&& operand,
+  const uint8_t right_bp ) -> Result<AstNode::Ptr<>>
+{
+  const auto curr = ctx.lxr.current();
+  ASSERT(curr.cat().isa(TokenCategory::BinaryOp));
 
   auto node = AstNode::create<AstBinExpr>(
+    ctx.arena,
     curr.pos_,
-    curr.line_,
+    ctx.lxr.line_of(curr),
     nullptr,
     ctx.curr_file);
 
   node->op_type_ = curr.type_;
-  node->op_cat_  = curr.cat_;
+  node->op_cat_  = curr.cat();
   node->left_    = std::move(operand);
-  node->left_->parent_ = node.get();
+  node->left_->parent_ = node;
 
   ctx.lxr.consume(1);
-  node->right_ = TRY(parse_begin_(ctx, true, true));
+  node->right_ = TRY(parse_operand_(ctx, right_bp));
 
   if(node->right_ == nullptr || !is_valid_subexpression_(node->right_)) {
     ctx.lxr.revert_before(curr);
     return Error{ErrC::BadExpr, "Invalid expression following binary operator."};
   }
 
-  node->right_->parent_ = node.get();
-  curr = ctx.lxr.current();
-
-  while(curr.cat_.isa(TokenCategory::BinaryOp) && curr.type_.prec() <= node->op_type_.prec()) {
-    node->right_ = TRY(parse_binexpr_(ctx, std::move(node->right_)));
-    curr = ctx.lxr.current();
-  }
-
+  node->right_->parent_ = node;
   return Result<AstNode::Ptr<>>::create(std::move(node));
 }
 
 /* parse_scalar_lit_ parses a scalar literal, i.e. 34.2, 100, "foo", etc.
  * string literals are considered to be scalars, because their type resolves
- * to a const i8*. Non-decimal values like hex and octal literals are
- * converted to their respective decimal values by this function.
+ * to a const i8*. Numeric values were already decoded by the lexer, so
+ * hex and octal literals arrive here as plain integers.
  */
 auto parse_scalar_lit_(ParseContext &ctx) -> Result<AstNode::Ptr<>> {
   const auto curr = ctx.lxr.current();
-  ASSERT(curr.cat_.isa(TokenCategory::Literal));
+  ASSERT(curr.cat().isa(TokenCategory::Literal));
 
   auto node = AstNode::create<AstScalarLiteral>(
+    ctx.arena,
     curr.pos_,
-    curr.line_,
+    ctx.lxr.line_of(curr),
     nullptr,
     ctx.curr_file);
 
-  auto val_ = curr.value(ctx.lxr);
-  ASSERT(val_.has_value());
-  uint64_t converted = 0;
+  const auto lit = ctx.lxr.literal(curr);  /// Nothing unless it's numeric.
+  ERROR_IF(lit.has_value() && !lit->in_range, ErrC::BadToken, "Literal value is too large.");
 
-  try {
-    switch(curr.type_.value) {
-    case TokenType::FloatLiteral:
-      node->scalar_type_ = AstScalarLiteral::FloatLit;
-      (void)std::stod(*val_);
-      node->value_       = std::move(*val_);
-      break;
-    case TokenType::IntLiteral:
-      node->scalar_type_ = AstScalarLiteral::IntLit;
-      (void)std::stoull(*val_);
-      node->value_       = std::move(*val_);
-      break;
-    case TokenType::BooleanLiteral:
-      node->scalar_type_ = AstScalarLiteral::BoolLit;
-      node->value_       = std::move(*val_);
-      break;
-    case TokenType::NullLiteral:
-      node->scalar_type_ = AstScalarLiteral::NullLit;
-      break;
-    case TokenType::ByteLiteral:
-      node->scalar_type_ = AstScalarLiteral::U8Lit;
-      node->value_       = TRY(unescape_quoted_string(*val_));
-      break;
-    case TokenType::HexLiteral:
-      node->scalar_type_ = AstScalarLiteral::IntLit;
-      converted          = std::stoull(*val_, nullptr, 16);
-      node->value_       = std::to_string(converted);
-      break;
-    case TokenType::OctalLiteral:
-      node->scalar_type_ = AstScalarLiteral::IntLit;
-      converted          = std::stoull(*val_, nullptr, 8);
-      node->value_       = std::to_string(converted);
-      break;
-    case TokenType::StringLiteral:
-      node->scalar_type_ = AstScalarLiteral::StringLit;
-      node->value_       = TRY(unescape_quoted_string(*val_));
-      break;
-    default:
-      PANIC("parse_scalar_lit_: unknown literal kind.");
+  switch(curr.type_.value) {
+  case TokenType::FloatLiteral:
+    node->scalar_type_ = AstScalarLiteral::FloatLit;
+    node->float_value_ = lit->floating;
+    break;
+  case TokenType::IntLiteral:
+  case TokenType::HexLiteral:
+  case TokenType::OctalLiteral:
+    node->scalar_type_ = AstScalarLiteral::IntLit;
+    node->int_value_   = lit->integer;
+    break;
+  case TokenType::BooleanLiteral:
+    node->scalar_type_ = AstScalarLiteral::BoolLit;
+    node->int_value_   = ctx.lxr.src_[ ctx.lxr.offset_in_window(curr.pos_) ] == u8't';
+    break;
+  case TokenType::NullLiteral:
+    node->scalar_type_ = AstScalarLiteral::NullLit;
+    break;
+  case TokenType::ByteLiteral:
+    node->scalar_type_ = AstScalarLiteral::U8Lit;
+    node->value_       = TRY(unescape_quoted_string(as_chars(curr.view(ctx.lxr))));
+    break;
+  case TokenType::StringLiteral:
+    node->scalar_type_ = AstScalarLiteral::StringLit;
+    if(const auto str = ctx.lxr.interned(curr)) {
+      node->value_ = ctx.lxr.strings().get_string(str->index);
+    } else {                                  /// "", or a bad escape to report.
+      node->value_ = TRY(unescape_quoted_string(as_chars(curr.view(ctx.lxr))));
     }
-  }
-  catch(const std::out_of_range&) {
-    return Error(ErrC::BadToken, "Literal value is too large.");
-  }
-  catch(...) {
-    return Error(ErrC::BadToken, "Invalid literal token.");
+    break;
+  default:
+    PANIC("parse_scalar_lit_: unknown literal kind.");
   }
 
   ctx.lxr.consume(1);
@@ -316,8 +422,9 @@ auto parse_aggregate_lit_(ParseContext &ctx) -> Result<AstNode::Ptr<>> {
   ASSERT(ctx.lxr.current() == TokenType::LeftBrace);
 
   auto node = AstNode::create<AstAggregateLiteral>(
+    ctx.arena,
     ctx.lxr.current().pos_,
-    ctx.lxr.current().line_,
+    ctx.lxr.line_of(ctx.lxr.current()),
     nullptr,
     ctx.curr_file
   );
@@ -332,8 +439,8 @@ auto parse_aggregate_lit_(ParseContext &ctx) -> Result<AstNode::Ptr<>> {
       return Error{ErrC::BadExpr, "Invalid subexpression within aggregate literal."};
     }
 
-    child->parent_ = node.get();
-    node->children_.emplace_back(std::move(child));
+    child->parent_ = node;
+    node->children_.push_back(ctx.arena, child);
 
     if(ctx.lxr.current() == TokenType::Comma)
       ctx.lxr.consume(1);
@@ -372,8 +479,36 @@ auto parse_punctuator_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   return Error{ErrC::BadToken, "Unexpected token."};
 }
 
+/* parse_directive_ handles "@" directives. The only one so far is
+ *
+ * @include "path"
+ *
+ * which queues a file to be parsed after the current one. A relative
+ * path is taken from the directory of the file doing the including.
+ * Directives don't produce an AST node.
+ */
 auto parse_directive_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
-  return Error{ErrC::NotImplimented};
+  TRY(ctx.lxr.expect_type(TokenType::At));
+  const Token name  = TRY(ctx.lxr.expect_type(TokenType::Identifier));
+  ERROR_IF(name.view(ctx.lxr) != u8"include", ErrC::BadToken, "Unknown directive.");
+  ERROR_IF(ctx.curr_namespace != RL_ROOT_ENTITY_ID, ErrC::BadExpr,
+    "@include is only allowed at the toplevel.");
+
+  const Token path_tok = TRY(ctx.lxr.expect_type(TokenType::StringLiteral));
+  const auto path_str  = TRY(unescape_quoted_string(as_chars(path_tok.view(ctx.lxr))));
+  ERROR_IF(path_str.empty(), ErrC::BadToken, "@include needs a file name.");
+
+  std::filesystem::path path(path_str);
+  if(path.is_relative()) {
+    path = std::filesystem::path(ctx.lxr.file_name_).parent_path() / path;
+  }
+
+#ifdef N19_WIN32
+  register_include_(ctx, path.lexically_normal().wstring());
+#else
+  register_include_(ctx, path.lexically_normal().string());
+#endif
+  return Result<AstNode::Ptr<>>::create(nullptr);
 }
 
 /* parse_deep_ident_ parses something like foo::bar::baz
@@ -409,13 +544,14 @@ auto parse_deep_ident_(ParseContext& ctx) -> Result<Entity::ID> {
   /// Rest of the identifier.
   while(true) {
     const auto curr_tok  = TRY(ctx.lxr.expect_type(TokenType::Identifier));
-    const auto curr_name = MUST(curr_tok.value(ctx.lxr));
+    const auto curr_name = ctx.lxr.interned(curr_tok);
     const auto curr_ent  = ctx.entities.find(ctx.curr_namespace);
+    ERROR_IF(!curr_name.has_value(), ErrC::BadToken, "Identifier is too long.");
 
     bool already_exists = false;
     for(const Entity::ID id : curr_ent->chldrn_) {
       const auto child = ctx.entities.find(id);
-      if(child->lname_ == curr_name) {
+      if(child->lname_id_.has_value() && *child->lname_id_ == curr_name->index) {
         ctx.curr_namespace = child->id_;
         already_exists = true;
         break;
@@ -426,9 +562,10 @@ auto parse_deep_ident_(ParseContext& ctx) -> Result<Entity::ID> {
       auto new_ent = ctx.entities.insert<PlaceHolder>(
         ctx.curr_namespace,
         curr_tok.pos_,
-        curr_tok.line_,
+        ctx.lxr.line_of(curr_tok),
         ctx.curr_file,
-        curr_name);
+        std::string(ctx.lxr.strings().get_string(curr_name->index)));
+      new_ent->lname_id_ = curr_name->index;
       ctx.curr_namespace = new_ent->id_;
     }
 
@@ -455,7 +592,7 @@ auto parse_namespacedecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
       ent_ptr->id_,
       ent_ptr->parent_,
       begin.pos_,
-      begin.line_,
+      ctx.lxr.line_of(begin),
       ctx.curr_file));
   }
 
@@ -466,8 +603,9 @@ auto parse_namespacedecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   /// restore the old ctx.curr_namespace afterwards.
 
   auto node = AstNode::create<AstNamespace>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file);
 
@@ -484,8 +622,8 @@ auto parse_namespacedecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
         return Error{ErrC::BadExpr, "Expression is invalid at the toplevel."};
       }
 
-      child->parent_ = node.get();
-      node->body_.emplace_back(std::move(child));
+      child->parent_ = node;
+      node->body_.push_back(ctx.arena, child);
     }
 
     ctx.curr_namespace = old_id;
@@ -494,18 +632,24 @@ auto parse_namespacedecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
 
   /// Otherwise: we have braces. Parse the namespace body.
   ctx.lxr.consume(1);
+  const Entity::ID scope = ctx.curr_namespace;
   while(!ctx.on_type(TokenType::RightBrace)) {
     const auto curr = ctx.lxr.current();
-    auto child      = TRY(parse_begin_(ctx, false, false));
+    auto child      = parse_begin_(ctx, false, false);
+    if(!child.has_value()) {
+      TRY(recover_(ctx, curr, child.error(), true));
+      ctx.curr_namespace = scope;
+      continue;
+    }
 
-    if(child != nullptr) {
-      if(!is_node_toplevel_valid_(child)) {
-        ctx.lxr.revert_before(curr);
-        return Error{ErrC::BadExpr, "Expression is invalid at the toplevel."};
+    if(*child != nullptr) {
+      if(!is_node_toplevel_valid_(*child)) {
+        TRY(record_error_(ctx, "Expression is invalid at the toplevel.", curr.pos_));
+        continue;
       }
 
-      child->parent_ = node.get();
-      node->body_.emplace_back(std::move(child));
+      (*child)->parent_ = node;
+      node->body_.push_back(ctx.arena, *child);
     }
   }
 
@@ -535,7 +679,7 @@ auto parse_procdecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
       temp_ptr->id_,
       temp_ptr->parent_,
       begin.pos_,
-      begin.line_,
+      ctx.lxr.line_of(begin),
       ctx.curr_file
     ));
     temp_ptr.reset();
@@ -552,8 +696,9 @@ auto parse_procdecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   TRY(ctx.lxr.expect_type(TokenType::LeftParen));
 
   auto node = AstNode::create<AstProcDecl>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file
   );
@@ -575,23 +720,95 @@ auto parse_procdecl_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
     TRY(try_parse_return_type_(ctx, node, proc_ptr));
   }
 
-  /// Parse procedure body
+  /// Parse procedure body, or just find where it ends.
+  if(ctx.skim_bodies && ctx.lxr.mode() != LexMode::Streaming) {
+    node->body_begin_ = TRY(ctx.lxr.expect_type(TokenType::LeftBrace, false));
+    node->body_end_   = ctx.lxr.skip_braces();
+    if(node->body_end_ != TokenType::RightBrace) {
+      ctx.lxr.revert_before(node->body_begin_);
+      return Error(ErrC::BadToken, "Unterminated procedure body.");
+    }
+
+    node->body_pending_ = true;
+    ctx.pending_bodies_.push_back(node);
+  } else {
+    TRY(parse_procbody_(ctx, node));
+  }
+
+  ctx.curr_namespace = old_id;
+  ctx.lxr.consume(1);
+  return Result<AstNode::Ptr<>>::create(std::move(node));
+}
+
+/* parse_procbody_ parses a procedure body from its opening
+ * brace, and stops on the closing one without consuming it.
+ * The caller sets curr_namespace to the procedure.
+ */
+auto parse_procbody_(ParseContext& ctx, AstNode::Ptr<AstProcDecl> node) -> Result<void> {
   TRY(ctx.lxr.expect_type(TokenType::LeftBrace));
+  const Entity::ID scope = ctx.curr_namespace;
   while(ctx.lxr.current() != TokenType::RightBrace) {
     const auto curr = ctx.lxr.current();
-    auto child = TRY(parse_begin_(ctx, false, false));
-    if(child == nullptr) {
+    auto child = parse_begin_(ctx, false, false);
+    if(!child.has_value()) {
+      TRY(recover_(ctx, curr, child.error(), true));
+      ctx.curr_namespace = scope;
+      continue;
+    }
+
+    if(*child == nullptr) {
       ctx.lxr.revert_before(curr);
-      return Error(ErrC::BadExpr, "Invalid expression within procedure body.");
+      TRY(recover_(ctx, curr, Error(ErrC::BadExpr, "Invalid expression within procedure body."), true));
+      ctx.curr_namespace = scope;
+      continue;
     }
 
-    child->parent_ = node.get();
-    node->body_.emplace_back(std::move(child));
+    (*child)->parent_ = node;
+    node->body_.push_back(ctx.arena, *child);
   }
 
-  ctx.curr_namespace = old_id;
-  ctx.lxr.consume(1);
-  return Result<AstNode::Ptr<>>::create(std::move(node));
+  return Result<void>::create();
+}
+
+/* parse_skimmed_body_ parses a body that parse_procdecl_ skipped
+ * over, in the context it would have been parsed in, and shows its
+ * syntax errors. A body from a file the lexer has since moved on from
+ * is parsed with that file swapped back in. Only running out of errors
+ * is returned. The lexer is left wherever parsing stopped, and the
+ * callers put it back afterwards.
+ */
+auto parse_skimmed_body_(ParseContext& ctx, AstNode::Ptr<AstProcDecl> node) -> Result<void> {
+  ASSERT(node->body_pending_);
+  if(node->file_ != ctx.curr_file) {
+    const auto parked = ctx.parked_files_.find(node->file_);
+    ASSERT(parked != ctx.parked_files_.end(), "Skimmed body's source was dropped.");
+
+    /// The current file waits in the parked
+    /// lexer, cursor and all, until it's swapped back.
+    const InputFile::ID current = ctx.curr_file;
+    ctx.lxr.swap_source(*parked->second);
+    ctx.curr_file = node->file_;
+    auto res = parse_skimmed_body_(ctx, node);
+    ctx.lxr.swap_source(*parked->second);
+    ctx.curr_file = current;
+    return res;
+  }
+
+  node->body_pending_ = false;
+  ctx.lxr.revert_before(node->body_begin_);
+  ctx.curr_namespace = node->id_;
+  ctx.paren_level    = 0;
+
+  auto res = parse_procbody_(ctx, node);
+  if(res.has_value() && ctx.lxr.current().pos_ != node->body_end_.pos_) {
+    res = Error(ErrC::BadToken, "Procedure body ends before its closing brace.");
+  }
+  if(!res.has_value()) {
+    res = record_error_(ctx, res.error().msg, ctx.lxr.current().pos_);
+  }
+
+  ctx.errors.emit(ctx.errstream, ctx.lxr);
+  return res;
 }
 
 /* NOTE:
@@ -612,22 +829,32 @@ auto parse_scope_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   TRY(ctx.lxr.expect_type(TokenType::LeftBrace));
 
   auto node = AstNode::create<AstScopeBlock>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file
   );
 
+  const Entity::ID scope = ctx.curr_namespace;
   while(!ctx.on_type(TokenType::RightBrace)) {
     const auto curr = ctx.lxr.current();
-    auto child = TRY(parse_begin_(ctx, false, false));
-    if(child == nullptr) {
+    auto child = parse_begin_(ctx, false, false);
+    if(!child.has_value()) {
+      TRY(recover_(ctx, curr, child.error(), true));
+      ctx.curr_namespace = scope;
+      continue;
+    }
+
+    if(*child == nullptr) {
       ctx.lxr.revert_before(curr);
-      return Error(ErrC::BadExpr, "Invalid expression inside scope block.");
+      TRY(recover_(ctx, curr, Error(ErrC::BadExpr, "Invalid expression inside scope block."), true));
+      ctx.curr_namespace = scope;
+      continue;
     }
 
-    child->parent_ = node.get();
-    node->children_.emplace_back(std::move(child));
+    (*child)->parent_ = node;
+    node->children_.push_back(ctx.arena, *child);
   }
 
   ctx.lxr.consume(1);
@@ -638,8 +865,9 @@ auto parse_ret_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   const Token begin = MUST(ctx.lxr.expect_type(TokenType::Return));
 
   auto node = AstNode::create<AstReturn>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file
   );
@@ -652,7 +880,7 @@ auto parse_ret_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
       ctx.lxr.revert_before(curr);
       return Error(ErrC::BadExpr, "Invalid expression after return statement.");
     }
-    node->value_->parent_ = node.get();
+    node->value_->parent_ = node;
   }
 
   return Result<AstNode::Ptr<>>::create(std::move(node));
@@ -662,8 +890,9 @@ auto parse_cont_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   const Token begin = MUST(ctx.lxr.expect_type(TokenType::Continue));
 
   auto node = AstNode::create<AstContinue>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file);
 
@@ -675,8 +904,9 @@ auto parse_qualtype_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   const Entity::ID ent_id = TRY(parse_deep_ident_(ctx));
 
   auto node = AstNode::create<AstQualifiedRef>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file
   );
@@ -688,8 +918,9 @@ auto parse_break_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
   const Token begin = MUST(ctx.lxr.expect_type(TokenType::Break));
 
   auto node = AstNode::create<AstBreak>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file);
 
@@ -720,28 +951,29 @@ auto parse_keyword_(ParseContext& ctx) -> Result<AstNode::Ptr<>> {
 }
 
 auto parse_unary_prefix_(ParseContext &ctx) -> Result<AstNode::Ptr<>> {
-  ASSERT(ctx.on(TokenCategory::UnaryOp));
+  ASSERT(BindingPower::of(ctx.lxr.current().type_).prefix != 0);
   const auto begin = ctx.lxr.current();
   ctx.lxr.consume(1);
 
   auto node = AstNode::create<AstUnaryExpr>(
+    ctx.arena,
     begin.pos_,
-    begin.line_,
+    ctx.lxr.line_of(begin),
     nullptr,
     ctx.curr_file
   );
 
   node->op_type_    = begin.type_;
-  node->op_cat_     = begin.cat_;
+  node->op_cat_     = begin.cat();
   node->is_postfix_ = false;
-  node->operand_    = TRY(parse_begin_(ctx, true, true));
+  node->operand_    = TRY(parse_operand_(ctx, BindingPower::of(begin.type_).prefix));
 
   if(node->operand_ == nullptr || !is_valid_subexpression_(node->operand_)) {
     ctx.lxr.revert_before(begin);
     return Error{ErrC::BadExpr, "Unexpected expression following unary operator."};
   }
 
-  node->operand_->parent_ = node.get();
+  node->operand_->parent_ = node;
   return Result<AstNode::Ptr<>>::create(std::move(node));
 }
 
@@ -757,16 +989,17 @@ auto parse_postfix_(ParseContext& ctx, AstNode::Ptr<>&& operand) -> Result<AstNo
   case TokenType::Dec: FALLTHROUGH_;
   case TokenType::Inc: {
     auto node = AstNode::create<AstUnaryExpr>(
+      ctx.arena,
       curr.pos_,
-      curr.line_,
+      ctx.lxr.line_of(curr),
       nullptr,
       ctx.curr_file);
 
     node->op_type_    = curr.type_;
-    node->op_cat_     = curr.cat_;
+    node->op_cat_     = curr.cat();
     node->is_postfix_ = true;
     node->operand_    = std::move(operand);
-    node->operand_->parent_ = node.get();
+    node->operand_->parent_ = node;
 
     ctx.lxr.consume(1);
     return Result<AstNode::Ptr<>>::create(std::move(node));
@@ -783,8 +1016,9 @@ auto parse_call_(ParseContext& ctx, AstNode::Ptr<>&& operand) -> Result<AstNode:
   ASSERT(curr == TokenType::LeftParen);
 
   auto node = AstNode::create<AstCall>(
+    ctx.arena,
     curr.pos_,
-    curr.line_,
+    ctx.lxr.line_of(curr),
     nullptr,
     ctx.curr_file);
 
@@ -805,7 +1039,7 @@ auto parse_call_(ParseContext& ctx, AstNode::Ptr<>&& operand) -> Result<AstNode:
       return Error{ErrC::BadExpr, "Invalid subexpression within call."};
     }
 
-    node->arguments_.emplace_back(std::move(expr));
+    node->arguments_.push_back(ctx.arena, expr);
     if(old_paren_lvl >= ctx.paren_level) {
       break;
     }
@@ -827,57 +1061,96 @@ auto parse_identifier_(ParseContext &ctx) -> Result<AstNode::Ptr<>> {
   ASSERT(curr == TokenType::Identifier);
 
   auto node = AstNode::create<AstEntityRefThunk>(
+    ctx.arena,
     curr.pos_,
-    curr.line_,
+    ctx.lxr.line_of(curr),
     nullptr,
     ctx.curr_file);
 
-  auto val = curr.value(ctx.lxr);
-  ASSERT(val.has_value());
+  const auto name = ctx.lxr.interned(curr);
+  ERROR_IF(!name.has_value(), ErrC::BadToken, "Identifier is too long.");
 
-  node->name_ = std::move(val.value());
+  node->name_id_ = name->index;
+  node->name_    = ctx.lxr.strings().get_string(name->index);
   ctx.lxr.consume(1);
   return Result<AstNode::Ptr<>>::create(std::move(node));
 }
 
-auto get_next_include_(ParseContext& ctx) -> bool {
-  auto& frontend_ctx = Context::the();
-  if(frontend_ctx.inputs_.empty()) {
-    return false;
+/* register_include_ is where an @include'd file gets handed off.
+ * It becomes a Pending input and starts loading in the background
+ * straight away, so by the time the parser reaches the end of the
+ * current file, the next one is usually already tokenized. A file
+ * this compilation has already parsed or queued isn't loaded twice.
+ */
+auto register_include_(ParseContext& ctx, sys::String&& name) -> void {
+  ctx.saw_include = true;
+  const auto id = Context::the().add_include(sys::String(name));
+  if(std::ranges::find(ctx.files_, id) == ctx.files_.end()) {
+    ctx.files_.push_back(id);
+    ctx.includes.enqueue(id, name);
   }
-  
-  auto next = std::ranges::find_if(frontend_ctx.inputs_, [](const InputFile& f) {
-    return f.state == InputFileState::Pending && f.kind == InputFileKind::Included;
-  });
+}
 
-  if(next == frontend_ctx.inputs_.end())
+auto get_next_include_(ParseContext& ctx) -> bool {
+  auto next = ctx.includes.next();
+  if(!next.has_value()) {
     return false;
+  }
 
-  /// ts is so fucking retarded 🥀💔
-  std::filesystem::path path(next->name);
-
-#ifdef N19_WIN32
-  auto file = sys::File::open(path.wstring());
-#else /// POSIX
-  auto file = sys::File::open(path.string());
-#endif
-
-  if(!file.has_value()) {
+  const auto cannot_open = [&](const Error& err) -> bool {
     ctx.errstream
       << Con::RedFG
       << "\nError:"
       << Con::Reset
       << " could not open included file "
       << next->name
-      << ".\n\n";
+      << ".\n"
+      << err.msg
+      << "\n\n";
     return false;
+  };
+
+  auto& loaded = next->lexer;
+  if(!loaded.has_value()) {
+    return cannot_open(loaded.error());
+  }
+
+  /// Bodies skimmed in the file being left can still be asked
+  /// for, so its source is put aside instead of being dropped.
+  const bool skimmed = std::ranges::any_of(ctx.pending_bodies_, [&ctx](const auto& node) {
+    return node->body_pending_ && node->file_ == ctx.curr_file;
+  });
+
+  std::shared_ptr<Lexer> parked;
+  if(skimmed) {
+    parked = std::make_shared<Lexer>();
+    ctx.lxr.swap_source(*parked);
+  }
+
+  const auto unpark = [&](const Error& err) -> bool {
+    if(parked) ctx.lxr.swap_source(*parked);
+    return cannot_open(err);
+  };
+
+  /// Only an eager lexer can take over a pre-tokenized
+  /// file. Anything else reads it again, like before.
+  if(ctx.lxr.mode() == LexMode::Eager) {
+    const auto reset = ctx.lxr.reset(**loaded);
+    if(!reset) return unpark(reset.error());
+  } else {
+    auto file = sys::File::open(next->name, false, sys::File::Read);
+    if(!file) return unpark(file.error());
+    const auto reset = ctx.lxr.reset(*file);
+    if(!reset) return unpark(reset.error());
   }
 
-  next->state        = InputFileState::Finished;
+  if(parked) {
+    ctx.parked_files_.emplace(ctx.curr_file, std::move(parked));
+  }
+
+  Context::the().set_input_state(next->id, InputFileState::Finished);
   ctx.curr_namespace = RL_ROOT_ENTITY_ID;
   ctx.paren_level    = 0;
-
-  ASSERT(ctx.lxr.reset(*file));
   ctx.curr_file = next->id;
   return true;
 }
@@ -889,4 +1162,50 @@ auto parse(ParseContext& ctx) -> bool {
   return detail_::parse_impl_(ctx);
 }
 
+/* parse_pending_bodies parses every body that was skimmed over,
+ * in source order, and shows whatever errors they had. It returns
+ * false if any did. The bodies share ctx's entity table and arena,
+ * neither of which is thread safe, so this runs on the calling thread.
+ */
+auto parse_pending_bodies(ParseContext& ctx) -> bool {
+  const uint32_t errors_before = ctx.errors.error_count();
+  const Token resume      = ctx.lxr.current();
+  const Entity::ID old_ns = ctx.curr_namespace;
+
+  for(size_t i = 0; i < ctx.pending_bodies_.size(); i++) {    /// A body can skim
+    const auto node = ctx.pending_bodies_[i];                   /// more bodies.
+    if(node->body_pending_ && !detail_::parse_skimmed_body_(ctx, node)) {
+      break;
+    }
+  }
+
+  ctx.pending_bodies_.clear();
+  ctx.parked_files_.clear();
+  ctx.lxr.revert_before(resume);
+  ctx.curr_namespace = old_ns;
+  ctx.paren_level    = 0;
+  return ctx.errors.error_count() == errors_before;
+}
+
+auto AstProcDecl::ensure_body(ParseContext& ctx) -> Result<void> {
+  if(!body_pending_) {
+    return Result<void>::create();
+  }
+
+  const uint32_t errors_before = ctx.errors.error_count();
+  const Token resume        = ctx.lxr.current();
+  const Entity::ID old_ns   = ctx.curr_namespace;
+  const uint16_t old_parens = ctx.paren_level;
+  auto res = detail_::parse_skimmed_body_(ctx, this);
+
+  ctx.lxr.revert_before(resume);
+  ctx.curr_namespace = old_ns;
+  ctx.paren_level    = old_parens;
+  if(res.has_value() && ctx.errors.error_count() != errors_before) {
+    return Error(ErrC::BadExpr, "Procedure body has syntax errors.");
+  }
+
+  return res;
+}
+
 END_NAMESPACE(rl);
@@ -16,6 +16,7 @@
 /// Public parsing functions
 BEGIN_NAMESPACE(rl);
 auto parse(ParseContext& ctx) -> bool;
+auto parse_pending_bodies(ParseContext& ctx) -> bool;
 END_NAMESPACE(rl);
 
 ///
@@ -28,8 +29,16 @@ auto parse_begin_(
   bool parse_single
 ) -> Result<AstNode::Ptr<>>;
 
+auto parse_primary_(ParseContext&) -> Result<AstNode::Ptr<>>;
+auto parse_operand_(ParseContext&, uint8_t min_bp) -> Result<AstNode::Ptr<>>;
+auto parse_operators_(ParseContext&, AstNode::Ptr<>&&, uint8_t min_bp) -> Result<AstNode::Ptr<>>;
+
 /// Utility
 auto get_next_include_(ParseContext&) -> bool;
+auto register_include_(ParseContext&, sys::String&& name) -> void;
+auto record_error_(ParseContext&, const std::string& msg, SourcePos pos) -> Result<void>;
+auto synchronize_(ParseContext&, const Token& start, bool in_block) -> void;
+auto recover_(ParseContext&, const Token& start, const Error& err, bool in_block) -> Result<void>;
 auto is_node_toplevel_valid_(const AstNode::Ptr<>&)   -> bool;
 auto node_never_needs_terminal_(const AstNode::Ptr<>&) -> bool;
 auto is_valid_subexpression_(const AstNode::Ptr<>&)   -> bool;
@@ -47,6 +56,8 @@ auto parse_directive_(ParseContext&)     -> Result<AstNode::Ptr<>>;
 auto parse_identifier_(ParseContext&)    -> Result<AstNode::Ptr<>>;
 auto parse_procdecl_(ParseContext&)      -> Result<AstNode::Ptr<>>;
 auto parse_namespacedecl_(ParseContext&) -> Result<AstNode::Ptr<>>;
+auto parse_procbody_(ParseContext&, AstNode::Ptr<AstProcDecl>) -> Result<void>;
+auto parse_skimmed_body_(ParseContext&, AstNode::Ptr<AstProcDecl>) -> Result<void>;
 auto parse_deep_ident_(ParseContext&)    -> Result<Entity::ID>;
 
 auto parse_scope_(ParseContext&)         -> Result<AstNode::Ptr<>>;
@@ -59,6 +70,6 @@ auto parse_usingstmt_(ParseContext&)     -> Result<AstNode::Ptr<>>;
 auto parse_postfix_(ParseContext&, AstNode::Ptr<>&&)    -> Result<AstNode::Ptr<>>;
 auto parse_subscript_(ParseContext&, AstNode::Ptr<> &&) -> Result<AstNode::Ptr<>>;
 auto parse_call_(ParseContext&, AstNode::Ptr<>&&)       -> Result<AstNode::Ptr<>>;
-auto parse_binexpr_(ParseContext&, AstNode::Ptr<>&&)    -> Result<AstNode::Ptr<>>;
+auto parse_binexpr_(ParseContext&, AstNode::Ptr<>&&, uint8_t right_bp) -> Result<AstNode::Ptr<>>;
 
 END_NAMESPACE(rl::detail_);
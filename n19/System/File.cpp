@@ -6,15 +6,61 @@
 #include <n19/System/File.hpp>
 #include <n19/System/Error.hpp>
 #include <n19/Core/Try.hpp>
+#include <atomic>
+#include <string>
 #include <utility>
 
+#ifdef N19_WIN32
+#include <n19/System/Win32.hpp>
+#else
+#include <unistd.h>
+#endif
+
 namespace stdfs = std::filesystem;
 BEGIN_NAMESPACE(n19::sys);
+namespace {
+  /// Two threads can write the same path at once, so
+  /// the process ID alone doesn't make a name private.
+  std::atomic<uint64_t> next_tmp_id_{ 0 };
+
+  auto process_id_() -> uint64_t {
+  #ifdef N19_WIN32
+    return ::GetCurrentProcessId();
+  #else
+    return static_cast<uint64_t>(::getpid());
+  #endif
+  }
+}
 
 auto File::dev() const -> IODevice {
   return IODevice::from(this->value_);
 }
 
+auto write_atomically(const stdfs::path& path, const Bytes& bytes) -> Result<void> {
+  auto tmp = path;
+  tmp += "." + std::to_string(process_id_())
+    + "." + std::to_string(next_tmp_id_.fetch_add(1, std::memory_order_relaxed))
+    + ".tmp";
+
+  auto file = TRY(File::create_trunc(String(tmp.native())));
+  const auto written = file.write(bytes);
+  file.close();
+  if(!written) {
+    std::error_code ec;
+    stdfs::remove(tmp, ec);
+    return written;
+  }
+
+  std::error_code ec;
+  stdfs::rename(tmp, path, ec);
+  if(ec) {
+    stdfs::remove(tmp, ec);
+    return Error(ErrC::FileIO, "Could not move " + path.string() + " into place: " + ec.message());
+  }
+
+  return Result<void>::create();
+}
+
 END_NAMESPACE(n19::sys);
 #if defined(N19_POSIX)
 #include <sys/stat.h>
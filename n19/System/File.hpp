@@ -55,4 +55,14 @@ public:
   sys::String name_;
 };
 
+/// Writes `bytes` to a temporary next to `path`, then renames
+/// it into place, so a concurrent reader sees either the old
+/// file or all of the new one. Temporary names are private to
+/// each call, even across threads. The temporary is removed if
+/// anything fails.
+NODISCARD_ auto write_atomically(
+  const std::filesystem::path& path,
+  const Bytes& bytes
+) -> Result<void>;
+
 END_NAMESPACE(n19::sys);
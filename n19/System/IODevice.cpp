@@ -28,6 +28,16 @@ auto IODevice::read_into(WritableBytes& bytes) -> Result<void> {
   return Result<void>::create();
 }
 
+auto IODevice::read_some(const WritableBytes bytes) -> Result<size_t> {
+  ASSERT(!bytes.empty());
+  const ::ssize_t count = ::read(value_, bytes.data(), bytes.size_bytes());
+  if(count == -1) {
+    return Error(ErrC::Native, last_error());
+  }
+
+  return Result<size_t>::create(static_cast<size_t>(count));
+}
+
 auto IODevice::create_pipe() -> Result<std::array<IODevice, 2>> {
   int pipefds[ 2 ]{};
   std::array<IODevice, 2> arr{};
@@ -103,6 +113,22 @@ auto IODevice::read_into(WritableBytes& bytes) -> Result<void> {
   return Result<void>::create();
 }
 
+auto IODevice::read_some(const WritableBytes bytes) -> Result<size_t> {
+  ASSERT(!bytes.empty());
+  ::DWORD count = 0;
+  if(!::ReadFile(              ///
+    value_,                    /// The input file handle.
+    (void*)bytes.data(),       /// The input buffer.
+    (DWORD)bytes.size_bytes(), /// Size of our buffer.
+    &count,                    /// Number of bytes actually read.
+    nullptr                    /// OVERLAPPED struct (optional)
+  )) {
+    return Error(ErrC::Native, last_error());
+  }
+
+  return Result<size_t>::create(static_cast<size_t>(count));
+}
+
 auto IODevice::create_pipe() -> Result<std::array<IODevice, 2>> {
   SECURITY_ATTRIBUTES sa{};
   sa.nLength              = sizeof(sa);
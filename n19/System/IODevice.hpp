@@ -47,6 +47,7 @@ public:
 
   auto write(const Bytes& bytes) -> Result<void>;
   auto read_into(WritableBytes& bytes) -> Result<void>;
+  auto read_some(WritableBytes bytes) -> Result<size_t>;
   auto flush_handle() const -> void;
 
   template<typename T>
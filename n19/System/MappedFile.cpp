@@ -0,0 +1,146 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include <n19/System/MappedFile.hpp>
+#include <n19/System/PageAllocator.hpp>
+#include <n19/System/Error.hpp>
+#include <n19/Core/Try.hpp>
+#include <utility>
+
+#ifdef N19_WIN32
+#include <n19/System/Win32.hpp>
+#else // POSIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+BEGIN_NAMESPACE(n19::sys);
+
+static auto round_to_page_(const size_t size, const size_t page) -> size_t {
+  return (size + page - 1) / page * page;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  : addr_(std::exchange(other.addr_, nullptr))
+  , size_(std::exchange(other.size_, 0))
+  , total_(std::exchange(other.total_, 0))
+  , owned_(std::exchange(other.owned_, false)) {}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+  if(&other == this) return *this;
+  close();
+  addr_  = std::exchange(other.addr_, nullptr);
+  size_  = std::exchange(other.size_, 0);
+  total_ = std::exchange(other.total_, 0);
+  owned_ = std::exchange(other.owned_, false);
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+#ifdef N19_WIN32
+
+auto MappedFile::map(const File& file, const size_t padding) -> Result<MappedFile> {
+  const size_t fsize = TRY(file.size());
+  ERROR_IF(fsize == 0, ErrC::InvalidArg, "Cannot map an empty file.");
+
+  MappedFile mf;
+  mf.size_ = fsize;
+
+  /// The tail of the file's last page reads as zeroes, but there's
+  /// no way to place more memory directly after a view on Windows.
+  /// If that tail can't hold the padding, fall back to a private copy.
+  const size_t page = PageAllocator::page_size();
+  const size_t tail = round_to_page_(fsize, page) - fsize;
+  if(tail < padding) {
+    mf.total_ = round_to_page_(fsize + padding, page);
+    mf.owned_ = true;
+    mf.addr_  = PageAllocator::alloc(mf.total_);
+    if(mf.addr_ == nullptr) return Error::from_native();
+
+    auto dev    = file.dev();
+    auto wbytes = WritableBytes{ static_cast<Byte*>(mf.addr_), fsize };
+    TRY(file.seek(0, FSeek::Beg));
+    TRY(dev.read_into(wbytes));
+    return mf;
+  }
+
+  ::HANDLE mapping = ::CreateFileMappingW(file.value(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(mapping == nullptr) return Error::from_native();
+
+  mf.addr_  = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  mf.total_ = fsize;
+  ::CloseHandle(mapping); /// The view keeps the mapping alive.
+
+  if(mf.addr_ == nullptr) return Error::from_native();
+  return mf;
+}
+
+auto MappedFile::close() -> void {
+  if(addr_ != nullptr) {
+    if(owned_) PageAllocator::free(addr_, total_);
+    else ::UnmapViewOfFile(addr_);
+  }
+
+  addr_  = nullptr;
+  size_  = 0;
+  total_ = 0;
+  owned_ = false;
+}
+
+#else // POSIX
+
+auto MappedFile::map(const File& file, const size_t padding) -> Result<MappedFile> {
+  const size_t fsize = TRY(file.size());
+  ERROR_IF(fsize == 0, ErrC::InvalidArg, "Cannot map an empty file.");
+
+  const size_t page      = PageAllocator::page_size();
+  const size_t file_span = round_to_page_(fsize, page);
+  const size_t total     = round_to_page_(fsize + padding, page);
+
+  /// Reserve the whole range as zeroed anonymous memory first,
+  /// then map the file over the front of it. Bytes past EOF in the
+  /// file's last page read as zero, and the anonymous pages
+  /// after it cover whatever padding is left.
+  void* base = ::mmap(nullptr, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(base == MAP_FAILED) return Error::from_native();
+
+  int flags = MAP_PRIVATE | MAP_FIXED;
+#ifdef N19_LINUX
+  flags |= MAP_POPULATE;  /// Prefault the page tables up front.
+#endif
+
+  void* addr = ::mmap(base, file_span, PROT_READ, flags, file.value(), 0);
+  if(addr == MAP_FAILED) {
+    auto err = Error::from_native();
+    ::munmap(base, total);
+    return err;
+  }
+
+  /// Source files are read front to back exactly once.
+  ::madvise(addr, file_span, MADV_SEQUENTIAL);
+
+  MappedFile mf;
+  mf.addr_  = addr;
+  mf.size_  = fsize;
+  mf.total_ = total;
+  return mf;
+}
+
+auto MappedFile::close() -> void {
+  if(addr_ != nullptr) {
+    ::munmap(addr_, total_);
+  }
+
+  addr_  = nullptr;
+  size_  = 0;
+  total_ = 0;
+  owned_ = false;
+}
+
+#endif
+END_NAMESPACE(n19::sys);
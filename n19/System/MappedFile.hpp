@@ -0,0 +1,63 @@
+/*
+* Copyright (c) 2025 Diago Lima
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#pragma once
+
+#include <n19/Core/Common.hpp>
+#include <n19/Core/Platform.hpp>
+#include <n19/Core/ClassTraits.hpp>
+#include <n19/Core/Bytes.hpp>
+#include <n19/Core/Result.hpp>
+#include <n19/System/File.hpp>
+#include <cstdint>
+#include <span>
+BEGIN_NAMESPACE(n19::sys);
+
+/* n19::sys::MappedFile
+ *
+ * A read-only view of a file's contents, mapped directly
+ * into the process' address space. No copy is made and
+ * nothing is zero-filled up front; pages are faulted in
+ * (or prefetched, on Linux) as they are touched.
+ *
+ * map() can also guarantee a number of readable zero bytes
+ * past the end of the file ("padding"), so that scanners
+ * can treat '\0' as a sentinel instead of bounds checking.
+ *
+ * The file must not be truncated while it is mapped.
+ */
+class MappedFile {
+  N19_MAKE_NONCOPYABLE(MappedFile);
+public:
+  NODISCARD_ static auto map(const File& file, size_t padding = 0) -> Result<MappedFile>;
+
+  NODISCARD_ auto data()  const -> const void* { return addr_; }
+  NODISCARD_ auto size()  const -> size_t      { return size_; }
+  NODISCARD_ auto empty() const -> bool        { return size_ == 0; }
+  NODISCARD_ auto bytes() const -> Bytes;
+  NODISCARD_ auto chars() const -> std::span<const char8_t>;
+  auto close() -> void;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  MappedFile() = default;
+ ~MappedFile();
+private:
+  void* addr_   = nullptr;  /// Start of the view.
+  size_t size_  = 0;        /// Size of the file itself.
+  size_t total_ = 0;        /// Size of the whole reservation.
+  bool owned_   = false;    /// Copied into private memory instead of mapped.
+};
+
+inline auto MappedFile::bytes() const -> Bytes {
+  return { static_cast<const Byte*>(addr_), size_ };
+}
+
+inline auto MappedFile::chars() const -> std::span<const char8_t> {
+  return { static_cast<const char8_t*>(addr_), size_ };
+}
+
+END_NAMESPACE(n19::sys);
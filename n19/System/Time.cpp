@@ -96,6 +96,20 @@ auto SystemTime::from_local() -> Result<SystemTime> {
   return time;
 }
 
+auto thread_cpu_time() -> std::chrono::nanoseconds {
+  ::FILETIME created{}, exited{}, kernel{}, user{};
+  if(!::GetThreadTimes(::GetCurrentThread(), &created, &exited, &kernel, &user)) {
+    return std::chrono::nanoseconds(0);
+  }
+
+  /// Both are counts of 100ns intervals.
+  const auto ticks = [](const ::FILETIME& ft) -> uint64_t {
+    return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+  };
+
+  return std::chrono::nanoseconds((ticks(kernel) + ticks(user)) * 100);
+}
+
 #else // POSIX
 auto SystemTime::from_utc() -> Result<SystemTime> {
   SystemTime time{}; /// To return.
@@ -137,5 +151,14 @@ auto SystemTime::from_local() -> Result<SystemTime> {
   return time;
 }
 
+auto thread_cpu_time() -> std::chrono::nanoseconds {
+  struct ::timespec spec{};
+  if(::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &spec) != 0) {
+    return std::chrono::nanoseconds(0);
+  }
+
+  return std::chrono::seconds(spec.tv_sec) + std::chrono::nanoseconds(spec.tv_nsec);
+}
+
 #endif // N19_WIN32
 END_NAMESPACE(n19::sys);
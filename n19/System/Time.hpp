@@ -9,6 +9,7 @@
 #include <n19/Core/Platform.hpp>
 #include <n19/Core/Result.hpp>
 #include <n19/Core/ClassTraits.hpp>
+#include <chrono>
 #include <string>
 
 #ifdef N19_WIN32
@@ -57,4 +58,9 @@ public:
   SystemTime() = default;
 };
 
+///
+/// CPU time the calling thread has used so far. Differences
+/// between two calls on the same thread are what's meaningful.
+NODISCARD_ auto thread_cpu_time() -> std::chrono::nanoseconds;
+
 END_NAMESPACE(n19::sys);